@@ -35,10 +35,15 @@ echo -e ""
 # Redirect all output from run_analysis.sh to the log file
 touch "$LOG_FILE"
 
-# --- Step 1: Clean and build the project ---
+# --- Step 1: Build the project ---
+# The analysis is incremental: instances and stages whose inputs did not
+# change are skipped (see analysis/<instance>/manifest.txt). CLEAN=1 removes
+# all previous results (make clean) and recomputes everything.
 echo -e "${BLUE}[BUILDING PROJECT]${NC}"
 pushd "$SRC_DIR" > /dev/null
-make clean >> "$LOG_FILE" 2>&1
+if [ "${CLEAN:-0}" = "1" ]; then
+  make clean >> "$LOG_FILE" 2>&1
+fi
 make >> "$LOG_FILE" 2>&1
 popd > /dev/null
 echo -e "${GREEN}  -> Build completed.${NC}"
@@ -51,8 +56,13 @@ popd > /dev/null
 echo -e "${GREEN}  -> Generating metrics completed.${NC}"
 
 # --- Step 3: Generate the comparison table ---
+# sts-pipeline writes comparative_results.csv (and the columnar
+# comparative_results.bin) itself; the Python script is only needed for the
+# chain of separate tools (LEGACY_CHAIN=1).
 echo -e "${BLUE}[GENERATING COMPARATIVE TABLE]${NC}"
-"$PYTHON_CMD" "$TABLE_SCRIPT" "$ANALYSIS_DIR" >> "$LOG_FILE" 2>&1
+if [ "${LEGACY_CHAIN:-0}" = "1" ]; then
+  "$PYTHON_CMD" "$TABLE_SCRIPT" "$ANALYSIS_DIR" >> "$LOG_FILE" 2>&1
+fi
 echo -e "${GREEN}  -> Comparative table generated in $ROOT_DIR/comparative_results.csv${NC}"
 
 # --- Step 4: Clean up temporary files ---
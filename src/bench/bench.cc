@@ -0,0 +1,343 @@
+/* bench.cc
+
+Micro-benchmarks of the kernels the analysis is built of, on synthetic
+fronts (synthetic.h):
+
+   parse_text    read_point_file() of a text file ("%.9e", as normalize writes)
+   parse_binary  read_point_file() of a binary file (reader.h)
+   hv            hv_ind_value(), the reference point 1.1 in every objective
+   eps           eps_ind_value() (additive) against a reference set of 1000 points
+   igd           igd_value() against a reference set of 1000 points
+   filter        filter_nondominated()
+   ranks         rank_engine::rank() of 10 samples, as kruskal-wallis ranks them
+   ranks_pairs   the same with the pair-wise statistics of mann-whit
+
+   COMPILE:
+      make bin/bench     (make bench builds and runs it)
+
+   RUN:
+      ./bench [--kernels <k,...>] [--sizes <n,...>] [--dims <d,...>]
+        [--shapes <s,...>] [--duplicates <rate>] [--seed <n>] [--reps <n>]
+        [--min-time <seconds>] [--no-limits] [--tmp <dir>]
+
+   Every kernel runs on every combination of the sizes (default 1000, 10000,
+   100000 and 1000000 points), dimensions (default 2, 3 and 4) and shapes
+   (default concave and random) of the options; the ranks kernels take the
+   first objective of the random points. Cases that would take minutes with
+   the current kernels are skipped unless --no-limits is given: on the
+   nondominated shapes, the hypervolume of more than 10000 points in 3 and
+   of more than 1000 points in 4 or more objectives and the filtering of
+   more than 10000 points in 3 or more objectives, and on any shape the
+   epsilon values of more than 100000 points.
+
+   A case is repeated until it has run at least --min-time seconds (default
+   0.2) and at least three times, or --reps times (default 10); the inputs
+   are prepared outside of the measured time. Parse benchmarks write their
+   files to --tmp (default /tmp).
+
+   Each case is written to stdout as one JSON object per line,
+
+      {"kernel":"hv","dim":2,"shape":"concave","size":1000,"duplicates":0,
+       "reps":10,"min_s":...,"median_s":...,"points_per_s":...,"result":...}
+
+   where points_per_s refers to min_s and result is the value the kernel
+   computed (the indicator value, the number of remaining points, the
+   number of ties, or the number of points read), so that another
+   implementation of a kernel can be checked against the same inputs.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "synthetic.h"
+#include "reader.h"
+#include "hv.h"
+#include "eps.h"
+#include "igd.h"
+#include "nondominated.h"
+#include "ranks.h"
+
+using namespace std;
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+#define REFERENCE_SIZE 1000  // the size of the reference sets of eps and igd
+#define SAMPLES 10           // the number of samples of the ranks kernels
+
+struct options
+{
+  vector<string> kernels;
+  vector<long> sizes;
+  vector<int> dims;
+  vector<front_shape> shapes;
+  double duplicates;
+  unsigned long long seed;
+  int reps;
+  double min_time;
+  bool no_limits;
+  string tmp;
+};
+
+static const char *all_kernels[] = { "parse_text", "parse_binary", "hv", "eps", "igd",
+				     "filter", "ranks", "ranks_pairs" };
+
+static vector<string> split(const char *list)
+{
+  vector<string> items;
+  string s(list);
+  size_t begin = 0, end;
+
+  while ((end = s.find(',', begin)) != string::npos)
+    {
+      items.push_back(s.substr(begin, end - begin));
+      begin = end + 1;
+    }
+  items.push_back(s.substr(begin));
+  return items;
+}
+
+static double seconds_since(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// runs prepare() and the measured run() until the case has taken the
+// minimum time and repetitions; returns the times of run() and stores the
+// value of the last run in result
+template <class P, class R>
+static vector<double> measure(const options &opt, P prepare, R run, double *result)
+{
+  vector<double> times;
+  double total = 0.0;
+
+  while ((int)times.size() < opt.reps && (times.size() < 3 || total < opt.min_time))
+    {
+      prepare();
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      *result = run();
+      times.push_back(seconds_since(start));
+      total += times.back();
+    }
+  return times;
+}
+
+static void record(const char *kernel, int dim, front_shape shape, long size,
+		   const options &opt, vector<double> times, double result)
+{
+  sort(times.begin(), times.end());
+  double median = times.size() % 2 ? times[times.size()/2]
+    : (times[times.size()/2 - 1] + times[times.size()/2])/2.0;
+  printf("{\"kernel\":\"%s\",\"dim\":%d,\"shape\":\"%s\",\"size\":%ld,\"duplicates\":%g,"
+	 "\"reps\":%d,\"min_s\":%.6e,\"median_s\":%.6e,\"points_per_s\":%.6e,\"result\":%.17g}\n",
+	 kernel, dim, shape_name(shape), size, opt.duplicates, (int)times.size(),
+	 times[0], median, times[0] > 0.0 ? size/times[0] : 0.0, result);
+  fflush(stdout);
+}
+
+static bool skipped(const string &kernel, int dim, front_shape shape, long size,
+		    const options &opt)
+{
+  if (opt.no_limits)
+    return false;
+  if (kernel == "eps")
+    return size > 100000;
+  if (shape == SHAPE_RANDOM)
+    return false;
+  if (kernel == "hv")
+    return (dim == 3 && size > 10000) || (dim >= 4 && size > 1000);
+  if (kernel == "filter")
+    return dim >= 3 && size > 10000;
+  return false;
+}
+
+static void bench_parse(bool binary, int dim, front_shape shape, long size,
+			const vector<double> &points, const options &opt)
+{
+  string path = opt.tmp + "/bench_" + to_string((long)getpid()) + (binary ? ".bin" : ".txt");
+  point_file pf;
+  double result = 0.0;
+
+  error(!write_front(path.c_str(), points, dim, 1), "could not write the temporary front");
+  vector<double> times = measure(opt, [] {},
+				 [&] {
+				   error(!read_point_file(path.c_str(), dim, 1, &pf),
+					 "could not read the temporary front");
+				   double n = pf.no_points;
+				   free_point_file(&pf);
+				   return n;
+				 }, &result);
+  unlink(path.c_str());
+  record(binary ? "parse_binary" : "parse_text", dim, shape, size, opt, times, result);
+}
+
+static void bench_front(const string &kernel, int dim, front_shape shape, long size,
+			const options &opt)
+{
+  vector<double> points, ref, work;
+  vector<int> obj(dim, 0);
+  vector<double> nadir(dim, 1.1);
+  vector<const double *> o;
+  vector<int> minmax1(dim, -1);
+  bool *dominated = NULL;
+  double result = 0.0;
+  vector<double> times;
+
+  synthetic_front(dim, size, shape, opt.duplicates, opt.seed, points);
+  if (kernel == "parse_text" || kernel == "parse_binary")
+    {
+      bench_parse(kernel == "parse_binary", dim, shape, size, points, opt);
+      return;
+    }
+  if (kernel == "hv")
+    times = measure(opt, [&] { work = points; },
+		    [&] { return hv_ind_value(work.data(), (int)size, dim, obj.data(), nadir.data()); },
+		    &result);
+  else if (kernel == "eps" || kernel == "igd")
+    {
+      synthetic_front(dim, REFERENCE_SIZE, shape == SHAPE_RANDOM ? SHAPE_CONCAVE : shape, 0.0,
+		      opt.seed + 1, ref);
+      if (kernel == "eps")
+	times = measure(opt, [&] { work = points; },
+			[&] { return eps_ind_value(ref.data(), REFERENCE_SIZE, work.data(), (int)size,
+						   dim, obj.data(), 0); },
+			&result);
+      else
+	times = measure(opt, [] {},
+			[&] { return igd_value(ref.data(), REFERENCE_SIZE, points.data(), (int)size, dim); },
+			&result);
+    }
+  else if (kernel == "filter")
+    {
+      for (long i = 0; i < size; i++)
+	o.push_back(&points[(size_t)i*dim]);
+      dominated = new bool[size];
+      times = measure(opt, [] {},
+		      [&] {
+			filter_nondominated(o.data(), (int)size, dim, minmax1.data(), dominated);
+			return (double)(size - count(dominated, dominated + size, true));
+		      }, &result);
+      delete [] dominated;
+    }
+  record(kernel.c_str(), dim, shape, size, opt, times, result);
+}
+
+static void bench_ranks(bool pairs, long size, const options &opt)
+{
+  vector<double> points;
+  vector<D> values((size_t)size), d;
+  rank_engine r;
+  double result = 0.0;
+
+  synthetic_front(1, size, SHAPE_RANDOM, opt.duplicates, opt.seed, points);
+  for (long i = 0; i < size; i++)
+    {
+      values[i].value = points[i];
+      values[i].label = (int)(i % SAMPLES);
+      values[i].rank = 0.0;
+    }
+  vector<double> times = measure(opt, [&] { d = values; },
+				 [&] {
+				   r.rank(d.data(), (int)size, SAMPLES, pairs);
+				   return (double)r.ties;
+				 }, &result);
+  record(pairs ? "ranks_pairs" : "ranks", 1, SHAPE_RANDOM, size, opt, times, result);
+}
+
+int main(int argc, char **argv)
+{
+  options opt;
+  int i = 1;
+
+  opt.kernels.assign(all_kernels, all_kernels + sizeof(all_kernels)/sizeof(all_kernels[0]));
+  opt.sizes = {1000, 10000, 100000, 1000000};
+  opt.dims = {2, 3, 4};
+  opt.shapes = {SHAPE_CONCAVE, SHAPE_RANDOM};
+  opt.duplicates = 0.0;
+  opt.seed = 1;
+  opt.reps = 10;
+  opt.min_time = 0.2;
+  opt.no_limits = false;
+  opt.tmp = "/tmp";
+
+  for (; i < argc; i++)
+    if (i+1 < argc && strcmp(argv[i], "--kernels") == 0)
+      opt.kernels = split(argv[++i]);
+    else if (i+1 < argc && strcmp(argv[i], "--sizes") == 0)
+      {
+	opt.sizes.clear();
+	for (const string &s : split(argv[++i]))
+	  opt.sizes.push_back(atol(s.c_str()));
+      }
+    else if (i+1 < argc && strcmp(argv[i], "--dims") == 0)
+      {
+	opt.dims.clear();
+	for (const string &s : split(argv[++i]))
+	  opt.dims.push_back(atoi(s.c_str()));
+      }
+    else if (i+1 < argc && strcmp(argv[i], "--shapes") == 0)
+      {
+	opt.shapes.clear();
+	for (const string &s : split(argv[++i]))
+	  {
+	    front_shape shape;
+	    error(!parse_shape(s, &shape), "the shapes are linear, concave, convex and random");
+	    opt.shapes.push_back(shape);
+	  }
+      }
+    else if (i+1 < argc && strcmp(argv[i], "--duplicates") == 0)
+      opt.duplicates = atof(argv[++i]);
+    else if (i+1 < argc && strcmp(argv[i], "--seed") == 0)
+      opt.seed = strtoull(argv[++i], NULL, 10);
+    else if (i+1 < argc && strcmp(argv[i], "--reps") == 0)
+      opt.reps = atoi(argv[++i]);
+    else if (i+1 < argc && strcmp(argv[i], "--min-time") == 0)
+      opt.min_time = atof(argv[++i]);
+    else if (strcmp(argv[i], "--no-limits") == 0)
+      opt.no_limits = true;
+    else if (i+1 < argc && strcmp(argv[i], "--tmp") == 0)
+      opt.tmp = argv[++i];
+    else
+      error(true, "./bench [--kernels <k,...>] [--sizes <n,...>] [--dims <d,...>] [--shapes <s,...>] [--duplicates <rate>] [--seed <n>] [--reps <n>] [--min-time <seconds>] [--no-limits] [--tmp <dir>]");
+
+  error(opt.duplicates < 0.0 || opt.duplicates >= 1.0, "the duplicate rate is in [0,1)");
+  error(opt.reps < 1, "the number of repetitions must be at least 1");
+  for (long size : opt.sizes)
+    error(size < 1 || size > 100000000L, "the sizes must be between 1 and 10^8");
+  for (int dim : opt.dims)
+    error(dim < 2, "the dimensions must be at least 2");
+
+  for (const string &kernel : opt.kernels)
+    {
+      bool known = false;
+      for (const char *k : all_kernels)
+	known = known || kernel == k;
+      error(!known, "unknown kernel");
+
+      if (kernel == "ranks" || kernel == "ranks_pairs")
+	{
+	  for (long size : opt.sizes)
+	    {
+	      fprintf(stderr, "--> %s, %ld values\n", kernel.c_str(), size);
+	      bench_ranks(kernel == "ranks_pairs", size, opt);
+	    }
+	  continue;
+	}
+      for (int dim : opt.dims)
+	for (front_shape shape : opt.shapes)
+	  for (long size : opt.sizes)
+	    {
+	      if (skipped(kernel, dim, shape, size, opt))
+		continue;
+	      fprintf(stderr, "--> %s, %d objectives, %s, %ld points\n", kernel.c_str(), dim,
+		      shape_name(shape), size);
+	      bench_front(kernel, dim, shape, size, opt);
+	    }
+    }
+  return 0;
+}
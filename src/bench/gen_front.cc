@@ -0,0 +1,50 @@
+/*===========================================================================*
+ * gen_front.cc: writes synthetic approximation sets (see synthetic.h)
+ *
+ * Usage:
+ *   gen_front <dim> <size> <shape> <duplicates> <seed> <outFile> [<runs>]
+ *
+ *   <dim> is the number of objectives and <size> the number of points;
+ *   <shape> is one of linear, concave, convex (nondominated fronts) and
+ *   random (points in the unit cube); <duplicates> is the fraction of the
+ *   points that are copies of earlier points and <seed> selects the
+ *   points. The points are divided into <runs> runs (default 1) of nearly
+ *   equal size, and written in the text format of normalize ("%.9e") or,
+ *   if the name of <outFile> ends in .bin, in the binary format of
+ *   reader.h. All objectives are to be minimized.
+ *===========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "synthetic.h"
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+int  main(int  argc, char  *argv[])
+{
+    int  dim, runs = 1;
+    long  size;
+    double  duplicates;
+    unsigned long long  seed;
+    front_shape  shape;
+    std::vector<double>  points;
+
+    error(argc != 7 && argc != 8,
+	  "gen_front - wrong number of arguments:\ngen_front dim size shape duplicates seed outFile [runs]");
+    dim = atoi(argv[1]);
+    size = atol(argv[2]);
+    duplicates = atof(argv[4]);
+    seed = strtoull(argv[5], NULL, 10);
+    if (argc == 8)
+	runs = atoi(argv[7]);
+    error(dim < 1 || size < 1 || size > 2147483647L / dim, "invalid dimension or size");
+    error(!parse_shape(argv[3], &shape), "the shape is linear, concave, convex or random");
+    error(duplicates < 0.0 || duplicates >= 1.0, "the duplicate rate is in [0,1)");
+    error(runs < 1 || runs > size, "invalid number of runs");
+
+    synthetic_front(dim, size, shape, duplicates, seed, points);
+    error(!write_front(argv[6], points, dim, runs), "output file could not be written");
+    return 0;
+}
@@ -0,0 +1,137 @@
+/* synthetic.cc
+
+Synthetic approximation sets, see synthetic.h.
+
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include "reader.h"
+#include "synthetic.h"
+
+using namespace std;
+
+static const char *names[] = { "linear", "concave", "convex", "random" };
+
+namespace {
+
+class splitmix
+{
+ public:
+  explicit splitmix(unsigned long long seed) : state(seed) {}
+
+  unsigned long long next()
+  {
+    unsigned long long z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // uniform in (0, 1)
+  double uniform() { return ((next() >> 11) + 0.5) * (1.0/9007199254740992.0); }
+
+ private:
+  unsigned long long state;
+};
+
+}
+
+bool parse_shape(const string &name, front_shape *shape)
+{
+  for (int i = 0; i < 4; i++)
+    if (name == names[i])
+      {
+	*shape = (front_shape)i;
+	return true;
+      }
+  return false;
+}
+
+const char *shape_name(front_shape shape)
+{
+  return names[shape];
+}
+
+void synthetic_front(int dim, long size, front_shape shape, double duplicates,
+		     unsigned long long seed, vector<double> &points)
+{
+  splitmix rng(seed);
+  long i;
+  int k;
+
+  points.resize((size_t)size*dim);
+  for (i = 0; i < size; i++)
+    {
+      double *f = &points[(size_t)i*dim];
+      if (i > 0 && rng.uniform() < duplicates)
+	{
+	  const double *g = &points[(size_t)(rng.next() % i)*dim];
+	  for (k = 0; k < dim; k++)
+	    f[k] = g[k];
+	  continue;
+	}
+      if (shape == SHAPE_RANDOM)
+	{
+	  for (k = 0; k < dim; k++)
+	    f[k] = rng.uniform();
+	  continue;
+	}
+
+      // a uniformly distributed point of the simplex
+      double sum = 0.0;
+      for (k = 0; k < dim; k++)
+	sum += f[k] = -log(rng.uniform());
+      for (k = 0; k < dim; k++)
+	f[k] /= sum;
+
+      if (shape == SHAPE_CONCAVE)
+	{
+	  double norm = 0.0;
+	  for (k = 0; k < dim; k++)
+	    norm += f[k]*f[k];
+	  norm = sqrt(norm);
+	  for (k = 0; k < dim; k++)
+	    f[k] /= norm;
+	}
+      else if (shape == SHAPE_CONVEX)
+	for (k = 0; k < dim; k++)
+	  f[k] *= f[k];
+    }
+}
+
+bool write_front(const char *path, const vector<double> &points, int dim, int runs)
+{
+  long size = (long)(points.size()/dim), i;
+  vector<int> run_start;
+  int r, k;
+
+  for (r = 0; r <= runs; r++)
+    run_start.push_back((int)(size*r/runs));
+
+  if (binary_file_name(path))
+    {
+      point_file pf;
+      pf.dim = dim;
+      pf.no_runs = runs;
+      pf.no_points = (int)size;
+      pf.points = (double *)points.data();
+      pf.run_start = run_start.data();
+      return write_point_file(path, &pf, NULL) != 0;
+    }
+
+  FILE *fp = fopen(path, "w");
+  if (fp == NULL)
+    return false;
+  for (r = 0; r < runs; r++)
+    {
+      for (i = run_start[r]; i < run_start[r+1]; i++)
+	{
+	  for (k = 0; k < dim; k++)
+	    fprintf(fp, "%.9e ", points[i*dim+k]);
+	  fprintf(fp, "\n");
+	}
+      fprintf(fp, "\n");
+    }
+  return fclose(fp) == 0;
+}
@@ -0,0 +1,43 @@
+/* synthetic.h
+
+Synthetic approximation sets for the benchmarks (bench.cc) and for
+gen_front.
+
+All objectives are minimized. The points of the front shapes are
+nondominated; they are drawn uniformly from the simplex (as normalized
+vectors of dim exponential variates) and mapped onto
+
+   linear    f_1 + ... + f_dim = 1
+   concave   f_1^2 + ... + f_dim^2 = 1 (the front of DTLZ2)
+   convex    sqrt(f_1) + ... + sqrt(f_dim) = 1
+
+while the points of random are uniformly distributed in the unit cube, so
+that most of them are dominated. A fraction duplicates of the points are
+copies of earlier points. The points only depend on the arguments: the
+generator is SplitMix64 and the variates are computed from its bits
+without the implementation-defined standard distributions.
+
+*/
+
+#ifndef SYNTHETIC_H
+#define SYNTHETIC_H
+
+#include <string>
+#include <vector>
+
+enum front_shape { SHAPE_LINEAR, SHAPE_CONCAVE, SHAPE_CONVEX, SHAPE_RANDOM };
+
+// the shape called name; returns false for an unknown name
+bool parse_shape(const std::string &name, front_shape *shape);
+const char *shape_name(front_shape shape);
+
+// stores size points of dim objectives in points, row-major
+void synthetic_front(int dim, long size, front_shape shape, double duplicates,
+		     unsigned long long seed, std::vector<double> &points);
+
+// writes the points to path, divided into runs of nearly equal size, in the
+// text format of normalize ("%.9e") or, if path ends in .bin, in the binary
+// format of reader.h; returns false if the file cannot be written
+bool write_front(const char *path, const std::vector<double> &points, int dim, int runs);
+
+#endif
@@ -0,0 +1,261 @@
+/*===========================================================================*
+ * eps.cc: epsilon indicator kernel shared by eps_ind, sts-pipeline and libsts
+ *
+ * The indicator is the one proposed in
+ *   Zitzler, E., Thiele, L., Laumanns, M., Fonseca, C., and
+ *   Grunert da Fonseca, V (2003): Performance Assessment of
+ *   Multiobjective Optimizers: An Analysis and Review. IEEE
+ *   Transactions on Evolutionary Computation, 7(2), 117-132.
+ *
+ * The code originally was part of eps_ind.c (Eckart Zitzler, February 3,
+ * 2005 / last update August 9, 2005).
+ *
+ * The value is max_i min_j max_k e(a_ik, b_jk), e being b - a (additive)
+ * or b / a (multiplicative) for minimized objectives and a - b resp. a / b
+ * for maximized ones. The approximation set is transposed into columns
+ * and the method and sense tests are hoisted out of the loops over its
+ * points, so every inner loop is a branch-free pass over one column. For
+ * 2 objectives the set is reduced to its nondominated points, sorted, and
+ * the inner minimum is found by a binary search. Every e() is computed and
+ * compared as in the original triple loop, so the result is the same.
+ * The column passes are a template on the number of objectives D (0 for a
+ * number only known at run time), instantiated for 3 objectives.
+ *===========================================================================*/
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "eps.h"
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+#define OBJECTIVES(D, n)  ((D) > 0 ? (D) : (n))
+
+#define BLOCK  256  /* points of 'b' processed per pass over the columns */
+
+typedef struct
+{
+    double  key1, key2;
+    int  j;
+} sweep_point;
+
+static double  eps_term(double  a, double  b, int  k, const int  *obj,
+			int  method)
+{
+    if (method == 0)
+	return obj[k] == 0 ? b - a : a - b;
+    return obj[k] == 0 ? b / a : a / b;
+}
+
+static void  check_signs(double  *a, int  size_a, double  *b, int  size_b,
+			 int  dim, int  *sign)
+    /* the multiplicative version requires all values of an objective to be
+       nonzero and of the same sign; sign[k] receives that sign */
+{
+    int  i, k;
+
+    for (k = 0; k < dim; k++) {
+	sign[k] = a[k] > 0 ? 1 : -1;
+	for (i = 0; i < size_a; i++)
+	    error(a[i * dim + k] == 0 || (a[i * dim + k] > 0) != (sign[k] > 0),
+		  "error in data file");
+	for (i = 0; i < size_b; i++)
+	    error(b[i * dim + k] == 0 || (b[i * dim + k] > 0) != (sign[k] > 0),
+		  "error in data file");
+    }
+}
+
+static int  compare_sweep_points(const void  *p, const void  *q)
+{
+    const sweep_point  *x = (const sweep_point *) p;
+    const sweep_point  *y = (const sweep_point *) q;
+
+    if (x->key1 != y->key1)
+	return x->key1 < y->key1 ? -1 : 1;
+    if (x->key2 != y->key2)
+	return x->key2 < y->key2 ? -1 : 1;
+    return x->j - y->j;
+}
+
+static double  eps_2d(double  *a, int  size_a, double  *b, int  size_b,
+		      const int  *obj, int  method, const int  *sign)
+{
+    sweep_point  *s;
+    double  dir[2], eps, eps_j, g1, g2;
+    int  i, j, n, lo, hi, mid;
+
+    /* e(a, b) is monotone in b in every objective; dir[k] = 1 if it grows
+       with b_k, -1 if it shrinks; e.g. b / a with a < 0 shrinks */
+    for (i = 0; i < 2; i++)
+	dir[i] = (obj[i] == 0) == (method == 0 || sign[i] > 0) ? 1 : -1;
+
+    /* the points of 'b' that are not dominated regarding dir, by
+       increasing first and decreasing second term; a dominated point can
+       not give a smaller maximum of both terms */
+    s = (sweep_point *) malloc(size_b * sizeof(sweep_point));
+    error(s == NULL, "memory overflow");
+    for (j = 0; j < size_b; j++) {
+	s[j].key1 = dir[0] * b[j * 2];
+	s[j].key2 = dir[1] * b[j * 2 + 1];
+	s[j].j = j;
+    }
+    qsort(s, size_b, sizeof(sweep_point), compare_sweep_points);
+    for (j = 0, n = 0; j < size_b; j++)
+	if (n == 0 || s[j].key2 < s[n - 1].key2)
+	    s[n++] = s[j];
+
+    eps = method == 0 ? DBL_MIN : 0;
+    for (i = 0; i < size_a; i++) {
+	/* the first term grows along s, the second one shrinks; find the
+	   first point at which the first term is not smaller */
+	lo = 0;
+	hi = n;
+	while (lo < hi) {
+	    mid = lo + (hi - lo) / 2;
+	    g1 = eps_term(a[i * 2], b[s[mid].j * 2], 0, obj, method);
+	    g2 = eps_term(a[i * 2 + 1], b[s[mid].j * 2 + 1], 1, obj, method);
+	    if (g1 < g2)
+		lo = mid + 1;
+	    else
+		hi = mid;
+	}
+	eps_j = DBL_MAX;
+	if (lo < n)
+	    eps_j = eps_term(a[i * 2], b[s[lo].j * 2], 0, obj, method);
+	if (lo > 0) {
+	    g2 = eps_term(a[i * 2 + 1], b[s[lo - 1].j * 2 + 1], 1, obj, method);
+	    if (lo == n || eps_j > g2)
+		eps_j = g2;
+	}
+	if (i == 0 || eps < eps_j)
+	    eps = eps_j;
+    }
+
+    free(s);
+    return eps;
+}
+
+template <int D>
+static double  eps_columns(double  *a, int  size_a, double  *b, int  size_b,
+			   int  dim, const int  *obj, int  method)
+    /* eps_ind_value() for size_a, size_b > 0 and any number of objectives */
+{
+    int  i, j, k, n, start;
+    double  eps, eps_j, *column, *m, *c;
+
+    dim = OBJECTIVES(D, dim);
+    eps = method == 0 ? DBL_MIN : 0;
+
+    /* 'b' column by column */
+    column = (double *) malloc((size_t)dim * size_b * sizeof(double));
+    m = (double *) malloc(BLOCK * sizeof(double));
+    error(column == NULL || m == NULL, "memory overflow");
+    for (j = 0; j < size_b; j++)
+	for (k = 0; k < dim; k++)
+	    column[(size_t)k * size_b + j] = b[j * dim + k];
+
+    for (i = 0; i < size_a; i++) {
+	const double  *ai = &a[i * dim];
+
+	eps_j = 0;
+	for (start = 0; start < size_b; start += BLOCK) {
+	    n = size_b - start < BLOCK ? size_b - start : BLOCK;
+	    /* m[j] = max_k e(a_ik, b_jk) for the points of this block */
+	    for (k = 0; k < dim; k++) {
+		const double  aik = ai[k];
+		c = &column[(size_t)k * size_b + start];
+		if (k == 0) {
+		    if (method == 0 && obj[k] == 0)
+			for (j = 0; j < n; j++) m[j] = c[j] - aik;
+		    else if (method == 0)
+			for (j = 0; j < n; j++) m[j] = aik - c[j];
+		    else if (obj[k] == 0)
+			for (j = 0; j < n; j++) m[j] = c[j] / aik;
+		    else
+			for (j = 0; j < n; j++) m[j] = aik / c[j];
+		    continue;
+		}
+		if (method == 0 && obj[k] == 0)
+		    for (j = 0; j < n; j++) {
+			double  t = c[j] - aik;
+			m[j] = m[j] < t ? t : m[j];
+		    }
+		else if (method == 0)
+		    for (j = 0; j < n; j++) {
+			double  t = aik - c[j];
+			m[j] = m[j] < t ? t : m[j];
+		    }
+		else if (obj[k] == 0)
+		    for (j = 0; j < n; j++) {
+			double  t = c[j] / aik;
+			m[j] = m[j] < t ? t : m[j];
+		    }
+		else
+		    for (j = 0; j < n; j++) {
+			double  t = aik / c[j];
+			m[j] = m[j] < t ? t : m[j];
+		    }
+	    }
+	    for (j = 0; j < n; j++)
+		if ((start == 0 && j == 0) || eps_j > m[j])
+		    eps_j = m[j];
+	}
+	if (i == 0 || eps < eps_j)
+	    eps = eps_j;
+    }
+
+    free(column);
+    free(m);
+    return eps;
+}
+
+template <int D>
+double  eps_value(double  *a, int  size_a, double  *b, int  size_b,
+		  const int  *obj, int  method)
+{
+    int  sign[D];
+
+    if (size_a == 0)
+	return method == 0 ? DBL_MIN : 0;
+    if (size_b == 0)
+	return DBL_MAX;
+    if (method != 0)
+	check_signs(a, size_a, b, size_b, D, sign);
+    if (D == 2)
+	return eps_2d(a, size_a, b, size_b, obj, method, sign);
+    return eps_columns<D>(a, size_a, b, size_b, D, obj, method);
+}
+
+template double  eps_value<2>(double  *a, int  size_a, double  *b, int  size_b,
+			       const int  *obj, int  method);
+template double  eps_value<3>(double  *a, int  size_a, double  *b, int  size_b,
+			       const int  *obj, int  method);
+
+double  eps_ind_value(double  *a, int  size_a, double  *b, int  size_b,
+		      int  dim, const int  *obj, int  method)
+{
+    int  *sign;
+    double  eps;
+
+    if (dim == 2)
+	return eps_value<2>(a, size_a, b, size_b, obj, method);
+    if (dim == 3)
+	return eps_value<3>(a, size_a, b, size_b, obj, method);
+
+    if (method == 0)
+	eps = DBL_MIN;
+    else
+	eps= 0;
+    if (size_a == 0)
+	return eps;
+    if (size_b == 0)
+	return DBL_MAX;
+
+    sign = (int *) malloc(dim * sizeof(int));
+    error(sign == NULL, "memory overflow");
+    if (method != 0)
+	check_signs(a, size_a, b, size_b, dim, sign);
+    free(sign);
+    return eps_columns<0>(a, size_a, b, size_b, dim, obj, method);
+}
@@ -0,0 +1,34 @@
+/*===========================================================================*
+ * eps.h: epsilon indicator kernel shared by eps_ind, sts-pipeline and libsts
+ *
+ * The number of objectives, the objective senses and the indicator
+ * version are passed explicitly, so the kernel does not depend on any
+ * global state. Points are stored row-major, i.e. objective k of point i
+ * is found at a[i * dim + k].
+ *===========================================================================*/
+
+#ifndef EPS_H
+#define EPS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* returns the epsilon value needed to make the set 'b' weakly dominate
+   every point of 'a' (in eps_ind, 'a' is the reference set and 'b' the
+   approximation set); obj[k] = 0 means objective k is minimized; method
+   0 selects the additive, method 1 the multiplicative version */
+double  eps_ind_value(double  *a, int  size_a, double  *b, int  size_b,
+		      int  dim, const int  *obj, int  method);
+
+#ifdef __cplusplus
+}
+
+/* eps_ind_value() for D = 2 or 3 objectives (dim = D); eps_ind_value()
+   calls these for 2 and 3 objectives */
+template <int D>
+double  eps_value(double  *a, int  size_a, double  *b, int  size_b,
+		  const int  *obj, int  method);
+#endif
+
+#endif
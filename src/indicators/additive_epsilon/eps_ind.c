@@ -6,7 +6,8 @@
  *            Transactions on Evolutionary Computation, 7(2), 117-132.
  *
  * Compile:
- *   gcc -lm -o eps_ind eps_ind.c
+ *   gcc -I../../utils/reader -I../../utils/trace -o eps_ind eps_ind.c eps.cc \
+ *     ../../utils/reader/reader.cc ../../utils/trace/trace.cc -lstdc++ -lm
  *
  * Usage:
  *   eps_ind [<param_file>] <data_file> <reference_set> <output_file>
@@ -35,7 +36,11 @@
  *     format is the same as for the data file.
  *
  *   <output_file> defines the name of the file to which the computed
- *     indicator values are written to.
+ *     indicator values are written to; if its name ends in .bin, the values
+ *     are written as a one-dimensional binary file with a single run.
+ *
+ *   The data file and the reference set may also be binary files written
+ *   by normalize or filter (see utils/reader/reader.h).
  *
  * IMPORTANT:
  *   To make the epsilon indicator work for mixed optimization problems
@@ -59,6 +64,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "reader.h"
+#include "eps.h"
+#include "trace.h"
+
 #define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
 
 #define MAX_LINE_LENGTH  2048 /* maximal length of lines in the files */
@@ -69,56 +78,6 @@ int  *obj;  /* obj[i] = 0 means objective i is to be minimized */
 int  method;  /* 0 = additive, 1 = multiplicative */
 
 
-double  calc_ind_value(double  *a, int  size_a, double  *b, int  size_b)
-{
-    int  i, j, k;
-    double  eps, eps_j, eps_k, eps_temp;
-
-    if (method == 0)
-	eps = DBL_MIN;
-    else
-	eps= 0;
-    
-    for (i = 0; i < size_a; i++) {
-	for (j = 0; j < size_b; j++) {
-	    for (k = 0; k < dim; k++) {
-		switch (method) {
-		case 0:
-		    if (obj[k] == 0)
-			eps_temp = b[j * dim + k] - a[i * dim + k];
-		    else
-			eps_temp = a[i * dim + k] - b[j * dim + k];
-		    break;
-		default:
-		    error((a[i * dim + k] < 0 && b[j * dim + k] > 0) ||
-			  (a[i * dim + k] > 0 && b[j * dim + k] < 0) ||
-			  a[i * dim + k] == 0 || b[j * dim + k] == 0,
-			  "error in data file");
-		    if (obj[k] == 0)
-			eps_temp = b[j * dim + k] / a[i * dim + k];
-		    else
-			eps_temp = a[i * dim + k] / b[j * dim + k];
-		    break;
-		}
-		if (k == 0)
-		    eps_k = eps_temp;
-		else if (eps_k < eps_temp)
-		    eps_k = eps_temp;
-	    }
-	    if (j == 0)
-		eps_j = eps_k;
-	    else if (eps_j > eps_k)
-		eps_j = eps_k;
-	}
-	if (i == 0)
-	    eps = eps_j;
-	else if (eps < eps_j)
-	    eps = eps_j;
-    }
-    
-    return eps;
-}
-
 void  read_params(FILE  *fp)
 {
     char str[MAX_STR_LENGTH];
@@ -160,50 +119,6 @@ void  set_params(void)
     method = 0;
 }
 
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp)
-    /* determines the maximum number of points and the number of runs
-       for the data resp. the reference set file; if the array v is
-       specified, the data read in will be stored in v
-    */
-{
-    char  line[MAX_STR_LENGTH];
-    int  i, j;
-    int  new_run;
-    int  no_points;
-    double  number;
-
-    no_points = 0;
-    *max_pointsp = 0;
-    *no_runsp = 0;
-    new_run = 1;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-	if (sscanf(line, "%lf", &number) != 1)
-	    new_run = 1;
-	else {
-	    if (new_run == 1)
-	    {
-		(*no_runsp)++;
-		if (*max_pointsp < no_points)
-		    *max_pointsp = no_points;
-		no_points = 0;
-	    }
-	    new_run = 0;
-	    i = 0;
-	    for (j = 1; j < dim; j++) {
-		while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		    i++;
-		error(sscanf(&(line[i]), "%lf", &number) <= 0,
-		      "error in data or reference set file");
-		while (line[i] == ' ' && line[i] != '\0')
-		    i++;
-	    }
-	    no_points++;
-	}
-    }
-    if (*max_pointsp < no_points)
-	*max_pointsp = no_points;
-}
-
 int  determine_dim(FILE  *fp)
 {
     char  line[MAX_STR_LENGTH];
@@ -230,50 +145,33 @@ int  determine_dim(FILE  *fp)
     return no_obj;
 }
 
-void  read_file(FILE  *fp, int  *no_pointsp, double  *points)
+void  write_values(const char  *path, const point_file  *values)
 {
-    char  line[MAX_STR_LENGTH];
-    int  i, j, k;
-    int  reading;
-    double  number;
+    FILE  *out_fp;
+    int  i;
 
-    k = 0;
-    reading = 0;
-    *no_pointsp = 0;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-        if (sscanf(line, "%lf", &number) != 1) {
-	    if (reading)
-	        break;
-	}
-	else {
-	    reading = 1;
-	    points[k++] = number;
-	    i = 0;
-	    for (j = 1; j < dim; j++) {
-		while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		    i++;
-		error(sscanf(&(line[i]), "%lf", &number) <= 0,
-		      "error in data or reference set file");
-		points[k++] = number;
-		while (line[i] == ' ' && line[i] != '\0')
-		    i++;
-	    }
-	    (*no_pointsp)++;
-	}
-    } 
+    if (binary_file_name(path)) {
+	error(!write_point_file(path, values, NULL),
+	      "output file could not be generated");
+	return;
+    }
+    out_fp = fopen(path, "w");
+    error(out_fp == NULL, "output file could not be generated");
+    for (i = 0; i < values->no_points; i++)
+	fprintf(out_fp, "%.9e\n", values->points[i]);
+    fclose(out_fp);
 }
 
 int  main(int  argc, char  *argv[])
 {
-    int  i;
-    int  no_runs;  /* number of runs */
-    int  max_points;  /* maximum number of points per run */
-    int  ref_set_size;  /* number of points in the reference set */
-    int  curr_run_size;  /* number of points associated with the current run */
-    double  *ref_set;  /* reference set */
-    double  *curr_run; /* objective vectors fur current run */
+    int  i, r;
+    point_file  ref_set;  /* reference set */
+    point_file  data;  /* objective vectors of all runs */
+    point_file  values;  /* indicator value of each run */
     double  ind_value;
-    FILE  *fp, *out_fp;
+    FILE  *fp;
+    const char  *data_path;
+    trace_span  span;
     
     error(argc != 4 && argc != 5,
 	  "Epsilon indicator - wrong number of arguments:\neps_ind [parFile] datFile refSet outFile");
@@ -288,7 +186,8 @@ int  main(int  argc, char  *argv[])
     else {
 	fp = fopen(argv[1], "r");
 	error(fp == NULL, "data file not found");
-	dim = determine_dim(fp);
+	if ((dim = point_file_header(argv[1], NULL)) == 0)
+	    dim = determine_dim(fp);
 	error(dim < 1, "error in data file");
 	fclose(fp);
 	obj = malloc(dim * sizeof(int));
@@ -299,45 +198,39 @@ int  main(int  argc, char  *argv[])
     }
 
     /* read reference set */
-    if (argc == 5)
-	fp = fopen(argv[3], "r");
-    else
-	fp = fopen(argv[2], "r");
-    error(fp == NULL, "reference set file not found");
-    check_file(fp, &no_runs, &max_points);
-    error(no_runs != 1 || max_points < 1, "error in reference set file");
-    ref_set = malloc(dim * max_points * sizeof(double));
-    error(ref_set == NULL, "memory overflow");
-    rewind(fp);
-    read_file(fp, &ref_set_size, ref_set);
-    fclose(fp);
-    no_runs = 0;
-    max_points = 0;
+    data_path = argv[argc == 5 ? 2 : 1];
+    trace_begin(&span, "parse");
+    error(!read_point_file(argv[argc == 5 ? 3 : 2], dim, 1, &ref_set),
+	  "reference set file not found");
+    error(ref_set.no_runs != 1 || ref_set.no_points < 1,
+	  "error in reference set file");
     
-    /* check data file */
-    if (argc == 5)
-	fp = fopen(argv[2], "r");
-    else
-	fp = fopen(argv[1], "r");
-    error(fp == NULL, "data file not found");
-    check_file(fp, &no_runs, &max_points);
-    error(no_runs < 1 || max_points < 1, "error in data file");
-    curr_run = malloc(dim * max_points * sizeof(double));
-    rewind(fp);
+    /* read data file */
+    error(!read_point_file(data_path, dim, 1, &data),
+	  "data file not found");
+    error(data.no_runs < 1, "error in data file");
+    trace_end(&span, NULL, data_path, data.no_points);
 
     /* process data */
-    if (argc == 5)
-	out_fp = fopen(argv[4], "w");
-    else
-	out_fp = fopen(argv[3], "w");
-    error(out_fp == NULL, "output file could not be generated");
-    while (no_runs > 0) {
-	read_file(fp, &curr_run_size, curr_run);
-	ind_value = calc_ind_value(ref_set, ref_set_size,
-				   curr_run, curr_run_size);
-	fprintf(out_fp, "%.9e\n", ind_value);
-	no_runs--;
+    trace_begin(&span, "epsilon");
+    values.dim = 1;
+    values.no_runs = 1;
+    values.no_points = data.no_runs;
+    values.points = malloc((data.no_runs + 1) * sizeof(double));
+    values.run_start = malloc(2 * sizeof(int));
+    error(values.points == NULL || values.run_start == NULL, "memory overflow");
+    values.run_start[0] = 0;
+    values.run_start[1] = data.no_runs;
+    for (r = 0; r < data.no_runs; r++) {
+	ind_value = eps_ind_value(ref_set.points, ref_set.no_points,
+				  &(data.points[data.run_start[r] * dim]),
+				  data.run_start[r + 1] - data.run_start[r],
+				  dim, obj, method);
+	values.points[r] = ind_value;
     }
-    fclose(out_fp);
-    fclose(fp);
+    write_values(argv[argc == 5 ? 4 : 3], &values);
+    trace_end(&span, NULL, data_path, data.no_points);
+    free_point_file(&values);
+    free_point_file(&ref_set);
+    free_point_file(&data);
 }
@@ -0,0 +1,245 @@
+/*===========================================================================*
+ * ind_batch.cc: computes the hypervolume, epsilon and IGD indicators of
+ *               the runs of several algorithms in one pass
+ *
+ *   The program does what one call of hyp_ind, eps_ind and igd per data
+ *   file does, but the reference set is read only once and the values
+ *   derived from it (the hypervolume of the reference set for method 1 of
+ *   hyp_ind) are computed only once for all data files. The values agree
+ *   bit for bit with the ones of the single tools.
+ *
+ * Compile:
+ *   g++ -I../../utils/reader -I../../utils/trace -I../hypervolume \
+ *     -I../additive_epsilon -I../igd -o ind_batch ind_batch.cc \
+ *     ../hypervolume/hv.cc ../additive_epsilon/eps.cc ../igd/igd.cc \
+ *     ../../utils/reader/reader.cc ../../utils/trace/trace.cc -lm
+ *
+ * Usage:
+ *   ind_batch <hyp_param_file> <eps_param_file> <igd_param_file>
+ *     <reference_set> <output_file> [<name>=]<data_file> ...
+ *
+ *   <hyp_param_file>, <eps_param_file> and <igd_param_file> are the
+ *     parameter files of hyp_ind, eps_ind and igd; they have to agree in
+ *     the number of objectives.
+ *
+ *   <reference_set> is the name of a file that contains the reference set
+ *     according to which the indicator values are calculated; as for
+ *     hyp_ind and eps_ind, it has to consist of a single set.
+ *
+ *   <output_file> defines the name of the file to which the table of
+ *     indicator values is written; the file has the format
+ *
+ *       alg run hv eps igd
+ *       <name> <run> <hv> <eps> <igd>
+ *       ...
+ *
+ *     with one line per run of every data file, in the order of the
+ *     command line. The run is counted from 1, the hypervolume and epsilon
+ *     values are written as hyp_ind and eps_ind write them and the IGD
+ *     value as igd writes it; the last column is called igd+ if the igd
+ *     parameter file selects method 1.
+ *
+ *   <data_file> specifies a file that contains the output of one or
+ *     several runs of an algorithm, in the format of the other indicator
+ *     tools; <name> is the name of the algorithm in the table (default:
+ *     the position of the data file on the command line, counted from 1).
+ *
+ *   The data files and the reference set may also be binary files written
+ *   by normalize or filter (see utils/reader/reader.h).
+ *===========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "reader.h"
+#include "hv.h"
+#include "eps.h"
+#include "igd.h"
+#include "trace.h"
+
+using namespace std;
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+#define MAX_STR_LENGTH  256 /* maximal length of strings in the files */
+
+int  dim;  /* number of objectives */
+int  *hyp_obj, *eps_obj, *igd_obj;  /* obj[i] = 0: objective i is minimized */
+int  hyp_method;  /* 0 = no reference set, 1 = with respect to reference set */
+int  eps_method;  /* 0 = additive, 1 = multiplicative */
+int  igd_method;  /* 0 = IGD, 1 = IGD+ */
+double  *nadir;  /* reference point for hypervolume calculation */
+
+
+FILE  *open_params(const char  *path)
+{
+    FILE  *fp;
+
+    fp = fopen(path, "r");
+    error(fp == NULL, "parameter file not found");
+    return fp;
+}
+
+int  *read_objectives(FILE  *fp)
+{
+    /* reads the "dim <n>" and "obj <+|-> ..." lines of a parameter file */
+    char str[MAX_STR_LENGTH];
+    int  i, n, *obj;
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "dim") != 0, "error in parameter file");
+    fscanf(fp, "%d", &n);
+    error(n <= 0, "error in parameter file");
+    error(dim != 0 && n != dim, "the parameter files differ in the number of objectives");
+    dim = n;
+    obj = (int *)malloc(dim * sizeof(int));
+    error(obj == NULL, "memory overflow");
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "obj") != 0, "error in parameter file");
+    for (i = 0; i < dim; i++) {
+	fscanf(fp, "%s", str);
+	error(str[0] != '-' && str[0] != '+', "error in parameter file");
+	if (str[0] == '-')
+	    obj[i] = 0;
+	else
+	    obj[i] = 1;
+    }
+    return obj;
+}
+
+int  read_method(FILE  *fp)
+{
+    char str[MAX_STR_LENGTH];
+    int  method;
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "method") != 0, "error in parameter file");
+    fscanf(fp, "%d", &method);
+    error(method != 0 && method != 1, "error in parameter file");
+    return method;
+}
+
+void  read_params(const char  *hyp_path, const char  *eps_path,
+		  const char  *igd_path)
+{
+    char str[MAX_STR_LENGTH];
+    int  i;
+    FILE  *fp;
+
+    fp = open_params(hyp_path);
+    hyp_obj = read_objectives(fp);
+    hyp_method = read_method(fp);
+    nadir = (double *)malloc(dim * sizeof(double));
+    error(nadir == NULL, "memory overflow");
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "nadir") != 0, "error in parameter file");
+    for (i = 0; i < dim; i++)
+	error(fscanf(fp, "%lf", &(nadir[i])) != 1, "error in parameter file");
+    fclose(fp);
+
+    fp = open_params(eps_path);
+    eps_obj = read_objectives(fp);
+    eps_method = read_method(fp);
+    fclose(fp);
+
+    fp = open_params(igd_path);
+    igd_obj = read_objectives(fp);
+    igd_method = read_method(fp);
+    fclose(fp);
+}
+
+int  main(int  argc, char  *argv[])
+{
+    int  i, r;
+    point_file  ref_set;  /* reference set */
+    point_file  data;  /* objective vectors of all runs of one data file */
+    double  ref_set_value = 0;
+    char  buf[64];
+    FILE  *out_fp;
+    trace_span  span;
+
+    error(argc < 7,
+	  "Batch indicators - wrong number of arguments:\nind_batch hypParFile epsParFile igdParFile refSet outFile [name=]datFile ...");
+
+    read_params(argv[1], argv[2], argv[3]);
+
+    /* read reference set */
+    trace_begin(&span, "parse");
+    error(!read_point_file(argv[4], dim, 1, &ref_set),
+	  "reference set file not found");
+    error(ref_set.no_runs != 1 || ref_set.no_points < 1,
+	  "error in reference set file");
+    trace_end(&span, NULL, argv[4], ref_set.no_points);
+    if (hyp_method == 1) {
+	trace_begin(&span, "hypervolume");
+	vector<double>  tmp(ref_set.points, ref_set.points + (size_t)ref_set.no_points * dim);
+	ref_set_value = hv_ind_value(tmp.data(), ref_set.no_points, dim,
+				     hyp_obj, nadir);
+	trace_end(&span, NULL, argv[4], ref_set.no_points);
+    }
+
+    out_fp = fopen(argv[5], "w");
+    error(out_fp == NULL, "output file could not be generated");
+    fprintf(out_fp, "alg run hv eps %s\n", igd_method == 0 ? "igd" : "igd+");
+
+    /* process data files */
+    for (i = 6; i < argc; i++) {
+	string  name = to_string(i - 5);
+	const char  *path = argv[i];
+	const char  *eq = strchr(argv[i], '=');
+	if (eq != NULL) {
+	    name.assign(argv[i], eq - argv[i]);
+	    path = eq + 1;
+	}
+	trace_begin(&span, "parse");
+	error(!read_point_file(path, dim, 1, &data), "data file not found");
+	error(data.no_runs < 1, "error in data file");
+	trace_end(&span, NULL, path, data.no_points);
+
+	/* one pass over the runs per indicator, so that each of them is a
+	   stage of its own in the records of trace.h */
+	vector<double>  hv(data.no_runs), eps(data.no_runs), igd(data.no_runs);
+	trace_begin(&span, "hypervolume");
+	for (r = 0; r < data.no_runs; r++) {
+	    double  *run = &(data.points[data.run_start[r] * dim]);
+	    int  size = data.run_start[r + 1] - data.run_start[r];
+
+	    vector<double>  tmp(run, run + (size_t)size * dim);
+	    hv[r] = hv_ind_value(tmp.data(), size, dim, hyp_obj, nadir);
+	    hv[r] = (hyp_method == 1 ? ref_set_value - hv[r] : -hv[r]);
+	}
+	trace_end(&span, NULL, path, data.no_points);
+	trace_begin(&span, "epsilon");
+	for (r = 0; r < data.no_runs; r++)
+	    eps[r] = eps_ind_value(ref_set.points, ref_set.no_points,
+				   &(data.points[data.run_start[r] * dim]),
+				   data.run_start[r + 1] - data.run_start[r],
+				   dim, eps_obj, eps_method);
+	trace_end(&span, NULL, path, data.no_points);
+	trace_begin(&span, "igd");
+	for (r = 0; r < data.no_runs; r++) {
+	    const double  *run = &(data.points[data.run_start[r] * dim]);
+	    int  size = data.run_start[r + 1] - data.run_start[r];
+
+	    if (igd_method == 0)
+		igd[r] = igd_value(ref_set.points, ref_set.no_points, run, size, dim);
+	    else
+		igd[r] = igd_plus_value(ref_set.points, ref_set.no_points, run, size,
+					dim, igd_obj);
+	}
+	trace_end(&span, NULL, path, data.no_points);
+
+	for (r = 0; r < data.no_runs; r++) {
+	    igd_format(igd[r], buf, sizeof(buf));
+	    fprintf(out_fp, "%s %d %.9e %.9e %s\n", name.c_str(), r + 1, hv[r], eps[r], buf);
+	}
+	free_point_file(&data);
+    }
+    fclose(out_fp);
+    free_point_file(&ref_set);
+    return 0;
+}
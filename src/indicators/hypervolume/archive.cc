@@ -0,0 +1,166 @@
+/* archive.cc
+
+The incremental hypervolume archive, see archive.h.
+
+*/
+
+#include <algorithm>
+#include <iterator>
+#include "archive.h"
+
+using namespace std;
+
+bool staircase::insert(double x, double y, const double *given)
+{
+  // the step at or after x has the largest y of all steps from x on
+  map<double, step>::iterator it = steps.lower_bound(x);
+  if (it != steps.end() && it->second.y >= y)
+    return false;
+
+  // the area below the front between the step left of the new point and x
+  // is replaced by the rectangle below the new point; on (x_left, x] the
+  // front has the height of the first step at or after each position
+  double cur_x = x;
+  double cur_h = 0.0;
+  double covered = 0.0;
+  if (it != steps.end())
+    {
+      cur_h = it->second.y;
+      if (it->first == x)  // dominated by the new point
+	it = steps.erase(it);
+    }
+  while (it != steps.begin())
+    {
+      map<double, step>::iterator left = prev(it);
+      if (left->second.y > y)
+	break;
+      covered += (cur_x - left->first)*cur_h;
+      cur_x = left->first;
+      cur_h = left->second.y;
+      steps.erase(left);
+    }
+  double x_left = it == steps.begin() ? 0.0 : prev(it)->first;
+  covered += (cur_x - x_left)*cur_h;
+  area += (x - x_left)*y - covered;
+
+  step s;
+  s.y = y;
+  s.given[0] = given != NULL ? given[0] : x;
+  s.given[1] = given != NULL ? given[1] : y;
+  steps.insert(it, make_pair(x, s));
+  return true;
+}
+
+double box_union(vector<const double *> &boxes)
+{
+  // a sweep over decreasing values of the third objective
+  sort(boxes.begin(), boxes.end(),
+       [](const double *a, const double *b) { return a[2] > b[2]; });
+  staircase s;
+  double volume = 0.0;
+  for (size_t i = 0; i < boxes.size(); i++)
+    {
+      s.insert(boxes[i][0], boxes[i][1]);
+      double below = i+1 < boxes.size() ? boxes[i+1][2] : 0.0;
+      volume += s.dominated_area()*(boxes[i][2] - below);
+    }
+  return volume;
+}
+
+template <int D>
+hv_archive<D>::hv_archive(const int *obj_, const double *nadir_) : volume(0.0)
+{
+  for (int k = 0; k < D; k++)
+    {
+      obj[k] = obj_[k];
+      nadir[k] = nadir_[k];
+    }
+}
+
+template <int D>
+bool hv_archive<D>::insert(const double *point)
+{
+  double v[D];
+
+  // relative to the reference point, as in hv_ind_value()
+  for (int k = 0; k < D; k++)
+    {
+      v[k] = obj[k] == 0 ? nadir[k] - point[k] : point[k] - nadir[k];
+      if (!(v[k] > 0))
+	return false;
+    }
+
+  if constexpr (D == 2)
+    {
+      if (!front2.insert(v[0], v[1], point))
+	return false;
+      volume = front2.dominated_area();
+      return true;
+    }
+  else
+    {
+      size_t i;
+      int k;
+      for (i = 0; i < front3.size(); i++)
+	{
+	  for (k = 0; k < 3 && front3[i].v[k] >= v[k]; k++)
+	    ;
+	  if (k == 3)
+	    return false;
+	}
+
+      // the part of the box of the point that the archive covers
+      vector<double> limited(3*front3.size());
+      vector<const double *> boxes(front3.size());
+      for (i = 0; i < front3.size(); i++)
+	{
+	  for (k = 0; k < 3; k++)
+	    limited[3*i+k] = min(front3[i].v[k], v[k]);
+	  boxes[i] = &limited[3*i];
+	}
+      volume += v[0]*v[1]*v[2] - box_union(boxes);
+
+      // the points the new point dominates now lie within its box
+      size_t n = 0;
+      for (i = 0; i < front3.size(); i++)
+	{
+	  for (k = 0; k < 3 && front3[i].v[k] <= v[k]; k++)
+	    ;
+	  if (k < 3)
+	    front3[n++] = front3[i];
+	}
+      front3.resize(n);
+      entry e;
+      for (k = 0; k < 3; k++)
+	{
+	  e.v[k] = v[k];
+	  e.given[k] = point[k];
+	}
+      front3.push_back(e);
+      return true;
+    }
+}
+
+template <int D>
+size_t hv_archive<D>::size() const
+{
+  if constexpr (D == 2)
+    return front2.size();
+  else
+    return front3.size();
+}
+
+template <int D>
+void hv_archive<D>::points(vector<double> &out) const
+{
+  out.clear();
+  if constexpr (D == 2)
+    for (const auto &s : front2.front())
+      out.insert(out.end(), s.second.given, s.second.given+2);
+  else
+    for (const entry &e : front3)
+      out.insert(out.end(), e.given, e.given+3);
+}
+
+template class hv_archive<2>;
+template class hv_archive<3>;
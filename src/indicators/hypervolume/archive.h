@@ -0,0 +1,95 @@
+/* archive.h
+
+An archive of nondominated points whose hypervolume is kept up to date as
+points are inserted, for following the hypervolume of a run while points
+arrive instead of recomputing it from the whole front (hv.h).
+
+The objective senses and the reference point are those of hv_ind_value():
+obj[k] = 0 means objective k is minimized, and nadir is the reference
+point. A point enters the archive if it is better than nadir in every
+objective and not weakly dominated by a point of the archive; the points
+of the archive it dominates are removed.
+
+For 2 objectives the front is kept ordered by the first objective in a
+balanced tree (std::map), so an insertion takes O(log n) time plus the
+removal of the points it dominates; the hypervolume changes by the area
+between the new point and the steps of the front it covers. For 3
+objectives an insertion adds the volume of the box of the new point minus
+the hypervolume of the archive limited to that box, which is computed by
+a sweep over the third objective that inserts the points into a
+2-objective front, in O(n log n) time.
+
+The hypervolume is the sum of the changes, so it may differ from
+hv_ind_value() of the same points in the last digits.
+
+*/
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// a 2-objective front, both objectives maximized with the reference point
+// at the origin, and the area it dominates
+class staircase
+{
+ public:
+  staircase() : area(0.0) {}
+
+  // inserts (x, y) with x, y > 0 unless it is weakly dominated; given points
+  // to the objective values to be kept with it
+  bool insert(double x, double y, const double *given = NULL);
+  double dominated_area() const { return area; }
+  std::size_t size() const { return steps.size(); }
+  void clear() { steps.clear(); area = 0.0; }
+
+  struct step
+  {
+    double y;
+    double given[2];
+  };
+  // by increasing x, i.e. decreasing y
+  const std::map<double, step> &front() const { return steps; }
+
+ private:
+  std::map<double, step> steps;  // x -> step
+  double area;
+};
+
+// the volume of the union of the boxes between the origin and the points
+// in boxes (3 objectives, all >= 0), in O(n log n) time; boxes is sorted
+double box_union(std::vector<const double *> &boxes);
+
+// D = 2 or 3 objectives
+template <int D>
+class hv_archive
+{
+ public:
+  hv_archive(const int *obj, const double *nadir);
+
+  // returns true if the point enters the archive
+  bool insert(const double *point);
+  double hypervolume() const { return volume; }
+  std::size_t size() const;
+
+  // the points of the archive, row-major with D objectives each; for 2
+  // objectives by increasing value of the first objective relative to
+  // nadir
+  void points(std::vector<double> &out) const;
+
+ private:
+  int obj[D];
+  double nadir[D];
+  double volume;
+  staircase front2;  // D = 2
+  struct entry
+  {
+    double v[3];      // relative to nadir
+    double given[3];
+  };
+  std::vector<entry> front3;  // D = 3
+};
+
+#endif
@@ -0,0 +1,322 @@
+/* contrib.cc
+
+The hypervolume contributions, see contrib.h.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+#include "hv.h"
+#include "archive.h"
+#include "contrib.h"
+
+using namespace std;
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+static void relative(const double *a, int size_a, int dim, const int *obj,
+		     const double *nadir, vector<double> &v)
+  // the objective values relative to nadir, all maximized, as hv_ind_value()
+  // computes them
+{
+  v.resize((size_t)size_a*dim);
+  for (int i = 0; i < size_a; i++)
+    for (int k = 0; k < dim; k++)
+      {
+	size_t j = (size_t)i*dim + k;
+	if (obj[k] == 0)
+	  {
+	    v[j] = nadir[k] - a[j];
+	    error(v[j] < 0, "error in data or reference set file 4");
+	  }
+	else
+	  {
+	    v[j] = a[j] - nadir[k];
+	    error(v[j] < 0, "error in data or reference set file 3");
+	  }
+      }
+}
+
+static vector<int> by_first_desc(const double *v, int n)
+  // the points of a 2-objective front by decreasing first and then second
+  // objective, the earlier point first among equal ones
+{
+  vector<int> idx(n);
+  for (int i = 0; i < n; i++)
+    idx[i] = i;
+  sort(idx.begin(), idx.end(), [v](int i, int j) {
+      if (v[2*i] != v[2*j])
+	return v[2*i] > v[2*j];
+      if (v[2*i+1] != v[2*j+1])
+	return v[2*i+1] > v[2*j+1];
+      return i < j;
+    });
+  return idx;
+}
+
+static void contributions_2d(const double *v, int n, double *c)
+{
+  // along the front by decreasing first objective, the second one grows;
+  // point j owns the rectangle between its successor in the first and its
+  // predecessor in the second objective, less the part of it that the
+  // points dominated by j alone cover
+  vector<int> idx = by_first_desc(v, n);
+  vector<int> front;
+  vector<char> dup;
+  vector<vector<int> > below;
+  vector<double> w;
+  double top = -1;
+
+  for (int i = 0; i < n; i++)
+    c[i] = 0;
+  for (int i : idx)
+    {
+      if (!front.empty() && v[2*i] == v[2*front.back()] && v[2*i+1] == v[2*front.back()+1])
+	dup.back() = 1;
+      else if (v[2*i+1] > top)
+	{
+	  front.push_back(i);
+	  dup.push_back(0);
+	  top = v[2*i+1];
+	}
+      else
+	{
+	  // the rectangle it reaches into is the one of the last point of the
+	  // front with a first objective not below its own
+	  size_t lo = 0, hi = front.size();
+	  while (hi - lo > 1)
+	    {
+	      size_t mid = (lo + hi)/2;
+	      if (v[2*front[mid]] >= v[2*i])
+		lo = mid;
+	      else
+		hi = mid;
+	    }
+	  if (lo > 0 && v[2*front[lo-1]+1] >= v[2*i+1])
+	    continue;
+	  below.resize(front.size());
+	  below[lo].push_back(i);
+	}
+    }
+  below.resize(front.size());
+  for (size_t j = 0; j < front.size(); j++)
+    {
+      double x_next = j+1 < front.size() ? v[2*front[j+1]] : 0.0;
+      double y_prev = j > 0 ? v[2*front[j-1]+1] : 0.0;
+      if (dup[j])
+	continue;
+      w.clear();
+      for (int i : below[j])
+	{
+	  w.push_back(v[2*i] - x_next);
+	  w.push_back(v[2*i+1] - y_prev);
+	}
+      c[front[j]] = (v[2*front[j]] - x_next)*(v[2*front[j]+1] - y_prev)
+	- hv_calc_hypervolume(w.data(), (int)below[j].size(), 2, 2);
+    }
+}
+
+static bool weakly_dominated(const double *v, int dim, int p, int q)
+  // true if point q weakly dominates point p
+{
+  for (int k = 0; k < dim; k++)
+    if (v[(size_t)q*dim+k] < v[(size_t)p*dim+k])
+      return false;
+  return true;
+}
+
+static double exclusive(const double *v, int n, int dim, int p,
+			const vector<char> &alive, vector<double> &w)
+  // the volume of the box of point p less the union of the boxes of the
+  // other points left (alive) within it
+{
+  const double *o = &v[(size_t)p*dim];
+  double volume = 1.0;
+  int m = 0;
+
+  w.clear();
+  for (int i = 0; i < n; i++)
+    if (i != p && alive[i])
+      {
+	for (int k = 0; k < dim; k++)
+	  w.push_back(min(v[(size_t)i*dim+k], o[k]));
+	m++;
+      }
+  for (int k = 0; k < dim; k++)
+    volume *= o[k];
+  if (dim != 3)
+    return volume - hv_calc_hypervolume(w.data(), m, dim, dim);
+  vector<const double *> boxes(m);
+  for (int i = 0; i < m; i++)
+    boxes[i] = &w[3*(size_t)i];
+  return volume - box_union(boxes);
+}
+
+static double contribution(const double *v, int n, int dim, int p,
+			   const vector<char> &alive, vector<double> &w)
+  // the contribution of point p among the points left; 0 if one of them
+  // weakly dominates it
+{
+  for (int q = 0; q < n; q++)
+    if (q != p && alive[q] && weakly_dominated(v, dim, p, q))
+      return 0;
+  return exclusive(v, n, dim, p, alive, w);
+}
+
+static void contributions(const double *v, int n, int dim, double *c)
+{
+  vector<char> alive(n, 1);
+  vector<double> w;
+
+  if (dim == 2)
+    contributions_2d(v, n, c);
+  else
+    for (int p = 0; p < n; p++)
+      c[p] = contribution(v, n, dim, p, alive, w);
+}
+
+void hv_contributions(const double *a, int size_a, int dim, const int *obj,
+		      const double *nadir, double *contrib)
+{
+  vector<double> v;
+  relative(a, size_a, dim, obj, nadir, v);
+  if (size_a > 0)
+    contributions(v.data(), size_a, dim, contrib);
+}
+
+static int reduce_2d(const double *v, int n, int size, int *keep)
+{
+  // the front as a doubly linked list of its distinct points, by
+  // decreasing first objective; the queue holds (contribution, -point)
+  // for the dominated points and for one copy of every point of the front
+  struct node
+  {
+    double x, y;
+    vector<int> copies;  // by increasing index
+    int prev, next;
+    pair<double, int> key;
+  };
+  vector<node> front;
+  vector<int> owner(n, -1);
+  set<pair<double, int> > queue;
+  vector<int> idx = by_first_desc(v, n);
+  double top = -1;
+
+  for (int i : idx)
+    if (!front.empty() && v[2*i] == front.back().x && v[2*i+1] == front.back().y)
+      {
+	front.back().copies.push_back(i);
+	owner[i] = (int)front.size()-1;
+      }
+    else if (v[2*i+1] > top)
+      {
+	node e;
+	e.x = v[2*i];
+	e.y = top = v[2*i+1];
+	e.copies.push_back(i);
+	e.prev = (int)front.size()-1;
+	e.next = (int)front.size()+1;
+	owner[i] = (int)front.size();
+	front.push_back(e);
+      }
+    else
+      queue.insert(make_pair(0.0, -i));
+  if (!front.empty())
+    front.back().next = -1;
+
+  auto key = [&](int k) {
+    node &e = front[k];
+    if (e.copies.size() > 1)
+      return make_pair(0.0, -e.copies.back());
+    double x_next = e.next >= 0 ? front[e.next].x : 0.0;
+    double y_prev = e.prev >= 0 ? front[e.prev].y : 0.0;
+    return make_pair((e.x - x_next)*(e.y - y_prev), -e.copies[0]);
+  };
+  auto requeue = [&](int k) {
+    queue.erase(front[k].key);
+    front[k].key = key(k);
+    queue.insert(front[k].key);
+  };
+  for (size_t k = 0; k < front.size(); k++)
+    {
+      front[k].key = key((int)k);
+      queue.insert(front[k].key);
+    }
+
+  int left = n;
+  for (int i = 0; i < n; i++)
+    keep[i] = 1;
+  while (left > size)
+    {
+      int i = -queue.begin()->second;
+      queue.erase(queue.begin());
+      keep[i] = 0;
+      left--;
+      int k = owner[i];
+      if (k < 0)
+	continue;
+      node &e = front[k];
+      e.copies.pop_back();
+      if (!e.copies.empty())
+	{
+	  e.key = key(k);
+	  queue.insert(e.key);
+	  continue;
+	}
+      if (e.prev >= 0)
+	front[e.prev].next = e.next;
+      if (e.next >= 0)
+	front[e.next].prev = e.prev;
+      if (e.prev >= 0)
+	requeue(e.prev);
+      if (e.next >= 0)
+	requeue(e.next);
+    }
+  return left;
+}
+
+int hv_reduce(const double *a, int size_a, int dim, const int *obj,
+	      const double *nadir, int size, int *keep)
+{
+  vector<double> v;
+  relative(a, size_a, dim, obj, nadir, v);
+  if (dim == 2)
+    return reduce_2d(v.data(), size_a, size, keep);
+
+  // the contributions only grow as points are removed, so a value computed
+  // before the last removal is a lower bound of the current one: the point
+  // with the least value is removed if its value is up to date, and
+  // evaluated again otherwise
+  vector<char> alive(size_a, 1);
+  vector<int> stamp(size_a, 0);
+  vector<double> w, c(size_a);
+  set<pair<double, int> > queue;
+  int left = size_a, removed = 0;
+
+  if (size_a > 0)
+    contributions(v.data(), size_a, dim, c.data());
+  for (int i = 0; i < size_a; i++)
+    {
+      keep[i] = 1;
+      queue.insert(make_pair(c[i], -i));
+    }
+  while (left > size)
+    {
+      int i = -queue.begin()->second;
+      queue.erase(queue.begin());
+      if (stamp[i] == removed)
+	{
+	  keep[i] = alive[i] = 0;
+	  left--;
+	  removed++;
+	  continue;
+	}
+      stamp[i] = removed;
+      queue.insert(make_pair(contribution(v.data(), size_a, dim, i, alive, w), -i));
+    }
+  return left;
+}
@@ -0,0 +1,52 @@
+/* contrib.h
+
+The exclusive hypervolume contribution of every point of a front, i.e. the
+hypervolume the front loses if the point is removed, and the reduction of a
+front to a given size by removing the point of least contribution again
+and again (hyp_ind --contributions and --reduce, libsts).
+
+The objective senses and the reference point are those of hv_ind_value()
+(hv.h): obj[k] = 0 means objective k is minimized, and nadir is the
+reference point; a point worse than nadir in some objective is an error,
+as it is there. A point that is weakly dominated by another point of the
+front, or that occurs more than once, contributes 0.
+
+For 2 objectives the contributions are found by one sort and a pass over
+the front, in O(n log n) time: a point of the front owns the rectangle
+between its two neighbours, less the part of it the points dominated by it
+alone cover. Otherwise the contribution of a point is the volume of its box
+less the union of the boxes of the other points within it, which takes a
+sweep over the third objective through a 2-objective front for 3
+objectives (archive.h), in O(n log n) time per point, and the hypervolume
+of hv.h for more.
+
+*/
+
+#ifndef CONTRIB_H
+#define CONTRIB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* contrib[i] = the exclusive contribution of point i of the size_a points
+   in 'a' (row-major, dim objectives); 'a' is not modified */
+void  hv_contributions(const double  *a, int  size_a, int  dim, const int  *obj,
+		       const double  *nadir, double  *contrib);
+
+/* removes the point of least contribution from the size_a points in 'a'
+   as long as more than 'size' points are left, the later point first if
+   several have the same contribution; keep[i] = 1 for the points left and
+   0 for the others; returns the number of points left. For 2 objectives
+   only the neighbours of a removed point are evaluated again, in O(n log n)
+   time in all; otherwise, as a contribution never shrinks when a point is
+   removed, only the point of least contribution is evaluated again until
+   its value is found up to date */
+int  hv_reduce(const double  *a, int  size_a, int  dim, const int  *obj,
+	       const double  *nadir, int  size, int  *keep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,186 @@
+/* estimate.cc
+
+The Monte Carlo estimate of the hypervolume, see estimate.h.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "hv.h"
+#include "estimate.h"
+#include "resample.h"
+#include "pvalues.h"
+
+using namespace std;
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+// GCC vector types, as in scale.cc: four points are compared at once (with
+// two SSE2 operations each on x86-64 unless AVX is enabled)
+typedef double v4d __attribute__((vector_size(32)));
+typedef long long v4i __attribute__((vector_size(32)));
+
+static const int batch = 1024;  // samples per random number stream
+static const int round_batches = 64;  // batches between two checks of the target
+
+void hv_estimate_defaults(hv_estimate_options *opt)
+{
+  opt->seed = 1;
+  opt->target = 0.001;
+  opt->confidence = 0.95;
+  opt->max_samples = 1000000000LL;
+  opt->threads = 0;
+}
+
+static double normal_quantile(double confidence)
+{
+  // z with P(X > z) = (1 - confidence)/2 for the standard normal
+  // distribution, by bisection
+  double lo = 0.0, hi = 40.0, tail = (1.0 - confidence)/2;
+  for (int i = 0; i < 200; i++)
+    {
+      double mid = (lo + hi)/2, upper;
+      normal_tails(&mid, 1, NULL, &upper);
+      if (upper > tail)
+	lo = mid;
+      else
+	hi = mid;
+    }
+  return (lo + hi)/2;
+}
+
+static void wilson(long long hits, long long n, double z, double *lower, double *upper)
+{
+  // the Wilson score interval of the share of hits
+  double p = (double)hits/n, z2 = z*z/n;
+  double center = (p + z2/2)/(1 + z2);
+  double half = z/(1 + z2)*sqrt(p*(1 - p)/n + z2/(4*n));
+  *lower = max(0.0, center - half);
+  *upper = min(1.0, center + half);
+}
+
+static long long batch_hits(const double *P, int npad, int dim, const double *ideal,
+			    unsigned long long seed, unsigned long long stream,
+			    long long b, int nsamples, double *u)
+  // the number of samples of batch b dominated by a point of the front,
+  // which is stored objective by objective in P, npad values each
+{
+  counter_rng rng(seed, stream, b);
+  long long hits = 0;
+
+  for (int s = 0; s < nsamples; s++)
+    {
+      for (int k = 0; k < dim; k++)
+	u[k] = ideal[k]*((double)(rng.next() >> 11)*0x1.0p-53);
+      for (int i = 0; i < npad; i += 4)
+	{
+	  v4i m = {-1, -1, -1, -1};
+	  int k;
+	  for (k = 0; k < dim; k++)
+	    {
+	      v4d p;
+	      memcpy(&p, P + (size_t)k*npad + i, sizeof(p));
+	      m &= (v4i)(p >= u[k]);
+	      if ((m[0] | m[1] | m[2] | m[3]) == 0)
+		break;
+	    }
+	  if (k == dim)
+	    {
+	      hits++;
+	      break;
+	    }
+	}
+    }
+  return hits;
+}
+
+void hv_estimate(const double *a, int size_a, int dim, const int *obj,
+		 const double *nadir, const hv_estimate_options *opt,
+		 unsigned long long stream, hv_estimate_result *res)
+{
+  res->value = res->lower = res->upper = 0.0;
+  res->samples = 0;
+  if (dim <= HV_EXACT_DIM)
+    {
+      vector<double> tmp(a, a + (size_t)size_a*dim);
+      res->value = res->lower = res->upper = hv_ind_value(tmp.data(), size_a, dim, obj, nadir);
+      return;
+    }
+
+  // the points relative to nadir, all maximized, as hv_ind_value() has
+  // them, and the ideal point, the upper corner of the sampled box
+  vector<double> v((size_t)size_a*dim), ideal(dim, 0.0), volume(size_a, 1.0);
+  double box = 1.0;
+  for (int i = 0; i < size_a; i++)
+    for (int k = 0; k < dim; k++)
+      {
+	size_t j = (size_t)i*dim + k;
+	v[j] = obj[k] == 0 ? nadir[k] - a[j] : a[j] - nadir[k];
+	error(v[j] < 0, obj[k] == 0 ? "error in data or reference set file 4"
+	      : "error in data or reference set file 3");
+	ideal[k] = max(ideal[k], v[j]);
+	volume[i] *= v[j];
+      }
+  for (int k = 0; k < dim; k++)
+    box *= ideal[k];
+  if (size_a == 0 || box == 0)
+    return;
+
+  // the points of larger boxes first, as they dominate more samples; the
+  // padding of the last four never dominates a sample
+  vector<int> order(size_a);
+  for (int i = 0; i < size_a; i++)
+    order[i] = i;
+  sort(order.begin(), order.end(), [&](int x, int y) {
+      return volume[x] > volume[y] || (volume[x] == volume[y] && x < y);
+    });
+  int npad = (size_a + 3)/4*4;
+  vector<double> P((size_t)dim*npad, -1.0);
+  for (int k = 0; k < dim; k++)
+    for (int i = 0; i < size_a; i++)
+      P[(size_t)k*npad + i] = v[(size_t)order[i]*dim + k];
+
+  int nthreads = opt->threads > 0 ? opt->threads : max(1, (int)thread::hardware_concurrency());
+  double z = normal_quantile(opt->confidence), lower = 0.0, upper = 1.0;
+  long long nbatches = (opt->max_samples + batch - 1)/batch, hits = 0, n = 0;
+  vector<long long> h(round_batches);
+
+  for (long long b0 = 0; b0 < nbatches; b0 += round_batches)
+    {
+      int nb = (int)min<long long>(round_batches, nbatches - b0);
+      atomic<int> next(0);
+      auto work = [&]() {
+	vector<double> u(dim);
+	for (int j; (j = next++) < nb; )
+	  {
+	    long long b = b0 + j;
+	    int ns = (int)min<long long>(batch, opt->max_samples - b*batch);
+	    h[j] = batch_hits(P.data(), npad, dim, ideal.data(), opt->seed, stream, b, ns, u.data());
+	  }
+      };
+      vector<thread> t;
+      for (int k = 1; k < min(nthreads, nb); k++)
+	t.push_back(thread(work));
+      work();
+      for (size_t k = 0; k < t.size(); k++)
+	t[k].join();
+      for (int j = 0; j < nb; j++)
+	{
+	  hits += h[j];
+	  n += min<long long>(batch, opt->max_samples - (b0 + j)*batch);
+	}
+      wilson(hits, n, z, &lower, &upper);
+      if (hits > 0 && (upper - lower)/2 <= opt->target*hits/n)
+	break;
+    }
+  res->value = box*hits/n;
+  res->lower = box*lower;
+  res->upper = box*upper;
+  res->samples = n;
+}
@@ -0,0 +1,71 @@
+/* estimate.h
+
+A Monte Carlo estimate of the hypervolume, with a confidence interval, for
+fronts with too many objectives for hv_ind_value() (hyp_ind --estimate).
+
+The objective senses and the reference point are those of hv_ind_value()
+(hv.h), and so is the check of the points against nadir. Relative to
+nadir, every point dominates a box between the origin and itself, and all
+of them lie in the box between the origin and the ideal point of the
+front, which is sampled uniformly: the hypervolume is the volume of that
+box times the share of the samples some point of the front dominates. The
+share is given with its Wilson score interval at the requested confidence
+level, which stays within [0, 1] even if (almost) no sample is a hit.
+
+The samples are drawn in batches of a fixed size, every batch from a
+counter-based random number stream of its own (resample.h), identified by
+the seed, the stream given by the caller and the number of the batch.
+Rounds of a fixed number of batches are spread over the threads, and after
+every round the interval is checked against the target; the estimate thus
+only depends on the points, the options and the stream, not on the number
+of threads. The front is stored objective by objective, with the points in
+order of decreasing box volume, and every sample is tested against four
+points at a time with vector comparisons (as scale.cc does), until a point
+dominating it is found.
+
+With no more than HV_EXACT_DIM objectives, hv_ind_value() is fast enough
+and is called instead; the interval is then the exact value itself.
+
+*/
+
+#ifndef ESTIMATE_H
+#define ESTIMATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HV_EXACT_DIM  4
+
+typedef struct
+{
+    unsigned long long  seed;  /* of the random number streams */
+    double  target;  /* sampling stops once the half-width of the interval
+			is at most target times the estimate */
+    double  confidence;  /* the level of the interval, in (0, 1) */
+    long long  max_samples;  /* sampling stops after at most this many */
+    int  threads;  /* <= 0 uses one thread per hardware thread */
+} hv_estimate_options;
+
+typedef struct
+{
+    double  value;  /* the estimate */
+    double  lower, upper;  /* its confidence interval */
+    long long  samples;  /* drawn; 0 if the value is exact */
+} hv_estimate_result;
+
+/* seed 1, target 0.001, confidence 0.95, max_samples 10^9, one thread per
+   hardware thread */
+void  hv_estimate_defaults(hv_estimate_options  *opt);
+
+/* the hypervolume of the size_a points in 'a' (row-major, dim objectives);
+   'a' is not modified */
+void  hv_estimate(const double  *a, int  size_a, int  dim, const int  *obj,
+		  const double  *nadir, const hv_estimate_options  *opt,
+		  unsigned long long  stream, hv_estimate_result  *res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
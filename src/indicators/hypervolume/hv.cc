@@ -0,0 +1,337 @@
+/*===========================================================================*
+ * hv.cc: hypervolume kernel shared by hyp_ind, sts-pipeline and libsts
+ *
+ * The algorithm is chosen by the number of objectives:
+ *
+ *   2 objectives: the points are sorted once by the second objective and
+ *     swept in ascending order; this visits the same slices (with the same
+ *     floating-point operations) as the recursive slicing scheme of
+ *       Zitzler, E., and Thiele, L. (1998): Multiobjective Optimization
+ *       Using Evolutionary Algorithms - A Comparative Case Study.
+ *       Parallel Problem Solving from Nature (PPSN-V), 292-301,
+ *     but takes O(n log n) instead of O(n^3) time;
+ *
+ *   3 or more objectives: the WFG algorithm of
+ *       While, L., Bradstreet, L., and Barone, L. (2012): A Fast Way of
+ *       Calculating Exact Hypervolumes. IEEE Transactions on Evolutionary
+ *       Computation, 16(1), 86-95,
+ *     i.e. the sum of the exclusive hypervolumes of the points, each one
+ *     computed from the nondominated part of the points added before it,
+ *     limited by the point itself; the recursion ends in the 2 objective
+ *     sweep.
+ *
+ * The code originally was part of hyp_ind.c (Eckart Zitzler, February 3,
+ * 2005 / last update August 9, 2005); it has been moved here with the
+ * number of objectives passed as an argument instead of being read from
+ * a global variable.
+ *
+ * The functions are templates on the number of objectives D, 0 standing
+ * for a number only known at run time, so that the loops over the
+ * objectives of 2 and 3 objective fronts are unrolled by the compiler;
+ * the WFG recursion for D objectives continues with D - 1. The C
+ * functions dispatch to the instances for 2, 3 and any number.
+ *===========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hv.h"
+
+/* the number of objectives of a D objective template, and the one of the
+   next level of the WFG recursion */
+#define OBJECTIVES(D, n)  ((D) > 0 ? (D) : (n))
+#define NEXT(D)  ((D) > 0 ? (D) - 1 : 0)
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+static int  compare_second(const void  *a, const void  *b)
+    /* sorts point pointers in ascending order of the second objective */
+{
+    double  x = (*(double * const *) a)[1];
+    double  y = (*(double * const *) b)[1];
+
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static int  compare_first_desc(const void  *a, const void  *b)
+    /* sorts point pointers in descending order of the first objective */
+{
+    double  x = (*(double * const *) a)[0];
+    double  y = (*(double * const *) b)[0];
+
+    return (x > y) ? -1 : (x < y) ? 1 : 0;
+}
+
+static double  hv_2d(const double  *front, int  no_points, int  dim)
+    /* hypervolume of the points 0..no_points-1 in 'front' regarding the
+       first two objectives; the slices are visited in ascending order of
+       the second objective, as in the slicing scheme, and the width of a
+       slice is the largest first objective among the points reaching it */
+{
+    const double  **p;
+    double  *width;
+    double  volume, distance;
+    int  i;
+
+    if (no_points < 1)
+	return 0;
+    p = (const double **) malloc(no_points * sizeof(double *));
+    width = (double *) malloc(no_points * sizeof(double));
+    error(p == NULL || width == NULL, "memory overflow");
+    for (i = 0; i < no_points; i++)
+	p[i] = &(front[i * dim]);
+    qsort(p, no_points, sizeof(double *), compare_second);
+
+    width[no_points - 1] = p[no_points - 1][0];
+    for (i = no_points - 2; i >= 0; i--)
+	width[i] = (p[i][0] > width[i + 1]) ? p[i][0] : width[i + 1];
+
+    volume = 0;
+    distance = 0;
+    for (i = 0; i < no_points; i++) {
+	if (i > 0 && p[i][1] == distance)
+	    continue;
+	volume += width[i] * (p[i][1] - distance);
+	distance = p[i][1];
+    }
+
+    free(p);
+    free(width);
+    return volume;
+}
+
+template <int D>
+static int  weakly_dominates(const double  *point1, const double  *point2,
+			     int  no_objectives)
+{
+    int  k;
+
+    for (k = 0; k < OBJECTIVES(D, no_objectives); k++)
+	if (point1[k] < point2[k])
+	    return 0;
+    return 1;
+}
+
+template <int D>
+static int  nondominated(const double  **p, int  no_points, int  no_objectives,
+			 double  *out)
+    /* copies the nondominated points among p[0..no_points-1] (duplicates
+       only once) to 'out' with stride 'no_objectives', in descending order
+       of the first objective; 'p' is resorted and the number of points
+       copied is returned */
+{
+    int  i, j, k, n;
+
+    no_objectives = OBJECTIVES(D, no_objectives);
+    qsort(p, no_points, sizeof(double *), compare_first_desc);
+    n = 0;
+    for (i = 0; i < no_points; i++) {
+	const double  *q = p[i];
+	int  dominated = 0;
+
+	for (j = 0; j < n && !dominated; j++)
+	    if (weakly_dominates<D>(&(out[j * no_objectives]), q, no_objectives))
+		dominated = 1;
+	if (dominated)
+	    continue;
+	/* a kept point can only be dominated by 'q' if both have the same
+	   first objective; the order of the kept points is preserved */
+	for (j = 0, k = 0; j < n; j++)
+	    if (!weakly_dominates<D>(q, &(out[j * no_objectives]), no_objectives)) {
+		if (k < j)
+		    memcpy(&(out[k * no_objectives]), &(out[j * no_objectives]),
+			   no_objectives * sizeof(double));
+		k++;
+	    }
+	n = k;
+	memcpy(&(out[n * no_objectives]), q, no_objectives * sizeof(double));
+	n++;
+    }
+    return n;
+}
+
+template <int D>
+static double  wfg(const double  *front, int  no_points, int  no_objectives)
+    /* hypervolume of the points in 'front' regarding all 'no_objectives'
+       (>= 3) objectives; the points are nondominated and stored with
+       stride 'no_objectives' in descending order of the first objective.
+       The points are taken in ascending order of the first objective;
+       the exclusive volume of a point regarding the remaining objectives
+       is taken against the points with a larger first objective (those
+       before it in 'front'), limited by the point, and weighted by its
+       value of the first objective */
+{
+    double  *limited, *reduced;
+    const double  **p;
+    double  volume;
+    int  i, j, k, m, n;
+
+    if (no_points < 1)
+	return 0;
+    no_objectives = OBJECTIVES(D, no_objectives);
+    m = no_objectives - 1;
+    n = (no_points > 1) ? no_points - 1 : 1;
+    limited = (double *) malloc(n * m * sizeof(double));
+    reduced = (double *) malloc(n * m * sizeof(double));
+    p = (const double **) malloc(n * sizeof(double *));
+    error(limited == NULL || reduced == NULL || p == NULL, "memory overflow");
+
+    volume = 0;
+    for (i = no_points - 1; i >= 0; i--) {
+	const double  *point = &(front[i * no_objectives]);
+	double  incl, excl;
+
+	incl = 1;
+	for (k = 1; k < no_objectives; k++)
+	    incl *= point[k];
+	if (incl == 0)
+	    continue;
+
+	/* points 0..i-1 limited by 'point' and projected onto the objectives
+	   1..no_objectives-1; points without volume are left out */
+	n = 0;
+	for (j = 0; j < i; j++) {
+	    const double  *q = &(front[j * no_objectives]);
+	    double  *l = &(limited[n * m]);
+	    int  empty = 0;
+
+	    for (k = 0; k < m; k++) {
+		l[k] = (q[k + 1] < point[k + 1]) ? q[k + 1] : point[k + 1];
+		if (l[k] <= 0)
+		    empty = 1;
+	    }
+	    if (!empty)
+		p[n++] = l;
+	}
+
+	if (n == 0)
+	    excl = incl;
+	else if (D == 3 || m == 2)
+	    excl = incl - hv_2d(limited, n, m);
+	else if constexpr (D != 3) {
+	    n = nondominated<NEXT(D)>(p, n, m, reduced);
+	    excl = incl - wfg<NEXT(D)>(reduced, n, m);
+	}
+	volume += point[0] * excl;
+    }
+
+    free(limited);
+    free(reduced);
+    free(p);
+    return volume;
+}
+
+template <int D>
+static double  hypervolume(const double  *front, int  no_points,
+			   int  no_objectives, int  dim)
+    /* hv_calc_hypervolume() for 3 or more objectives */
+{
+    double  *reduced;
+    const double  **p;
+    double  volume;
+    int  i, n;
+
+    no_objectives = OBJECTIVES(D, no_objectives);
+    reduced = (double *) malloc(no_points * no_objectives * sizeof(double));
+    p = (const double **) malloc(no_points * sizeof(double *));
+    error(reduced == NULL || p == NULL, "memory overflow");
+    for (i = 0; i < no_points; i++)
+	p[i] = &(front[i * dim]);
+    n = nondominated<D>(p, no_points, no_objectives, reduced);
+    volume = wfg<D>(reduced, n, no_objectives);
+    free(reduced);
+    free(p);
+
+    return volume;
+}
+
+double  hv_calc_hypervolume(double  *front, int  no_points, int  no_objectives,
+			    int  dim)
+{
+    double  volume;
+    int  i;
+
+    if (no_points < 1)
+	return 0;
+    if (no_objectives == 2)
+	return hv_2d(front, no_points, dim);
+    if (no_objectives < 2) {
+	volume = 0;
+	for (i = 0; i < no_points; i++)
+	    if (front[i * dim] > volume)
+		volume = front[i * dim];
+	return volume;
+    }
+    if (no_objectives == 3)
+	return hypervolume<3>(front, no_points, 3, dim);
+    return hypervolume<0>(front, no_points, no_objectives, dim);
+}
+
+template <int D>
+double  hv_value(double  *a, int  size_a, const int  *obj, const double  *nadir)
+{
+    int  i, k, dim = D;
+    double  temp;
+
+    /* re-calculate objective values relative to reference point */
+    for (i = 0; i < size_a; i++) {
+        for (k = 0; k < D; k++) {
+	    switch (obj[k]) {
+	    case 0:
+	        temp = nadir[k] - a[i * dim + k];
+		error(temp < 0, "error in data or reference set file 4");
+		a[i * dim + k] = temp;
+		break;
+	    default:
+	        temp = a[i * dim + k] - nadir[k];
+		error(temp < 0, "error in data or reference set file 3");
+		a[i * dim + k] = temp;
+		break;
+	    }
+	}
+    }
+    /* calculate indicator values */
+    if (size_a < 1)
+	return 0;
+    if (D == 2)
+	return hv_2d(a, size_a, 2);
+    return hypervolume<D>(a, size_a, D, D);
+}
+
+template double  hv_value<2>(double  *a, int  size_a, const int  *obj,
+			      const double  *nadir);
+template double  hv_value<3>(double  *a, int  size_a, const int  *obj,
+			      const double  *nadir);
+
+double  hv_ind_value(double  *a, int  size_a, int  dim, const int  *obj,
+		     const double  *nadir)
+{
+    int  i, k;
+    double  temp;
+
+    if (dim == 2)
+	return hv_value<2>(a, size_a, obj, nadir);
+    if (dim == 3)
+	return hv_value<3>(a, size_a, obj, nadir);
+
+    /* re-calculate objective values relative to reference point */
+    for (i = 0; i < size_a; i++) {
+        for (k = 0; k < dim; k++) {
+	    switch (obj[k]) {
+	    case 0:
+	        temp = nadir[k] - a[i * dim + k];
+		error(temp < 0, "error in data or reference set file 4");
+		a[i * dim + k] = temp;
+		break;
+	    default:
+	        temp = a[i * dim + k] - nadir[k];
+		error(temp < 0, "error in data or reference set file 3");
+		a[i * dim + k] = temp;
+		break;
+	    }
+	}
+    }
+    /* calculate indicator values */
+    return hv_calc_hypervolume(a, size_a, dim, dim);
+}
@@ -0,0 +1,43 @@
+/*===========================================================================*
+ * hv.h: hypervolume kernel shared by hyp_ind, sts-pipeline and libsts
+ *
+ * The functions below do not touch any global state; the number of
+ * objectives and the objective senses are passed explicitly, so the kernel
+ * can be called for several fronts (and several parameter sets) within one
+ * process.
+ *
+ * Points are stored row-major, i.e. objective k of point i is found at
+ * front[i * dim + k].
+ *===========================================================================*/
+
+#ifndef HV_H
+#define HV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* computes the hypervolume dominated by the points 0..no_points-1 in
+   'front' regarding the first 'no_objectives' objectives, assuming that all
+   objectives are to be maximized and that the reference point is the
+   origin; 2 objectives take O(n log n) time, more objectives use the WFG
+   algorithm; 'front' is not modified */
+double  hv_calc_hypervolume(double  *front, int  no_points, int  no_objectives,
+			    int  dim);
+
+/* re-calculates the objective values of the points in 'a' relative to the
+   reference point 'nadir' (obj[k] = 0 means objective k is minimized) and
+   returns the hypervolume of 'a'; 'a' is overwritten */
+double  hv_ind_value(double  *a, int  size_a, int  dim, const int  *obj,
+		     const double  *nadir);
+
+#ifdef __cplusplus
+}
+
+/* hv_ind_value() for D = 2 or 3 objectives (dim = D); hv_ind_value()
+   calls these for 2 and 3 objectives */
+template <int D>
+double  hv_value(double  *a, int  size_a, const int  *obj, const double  *nadir);
+#endif
+
+#endif
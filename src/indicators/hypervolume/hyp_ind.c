@@ -1,484 +1,419 @@
-/*===========================================================================*
- * hyp_ind.c: implements the unary hypervolume indicator as proposed in
- *            Zitzler, E., and Thiele, L. (1998): Multiobjective Optimization
- *            Using Evolutionary Algorithms - A Comparative Case Study.
- *            Parallel Problem Solving from Nature (PPSN-V), 292-301; a more
- *            detailed discussion can be found in
- *            Zitzler, E., Thiele, L., Laumanns, M., Fonseca, C., and
- *            Grunert da Fonseca, V (2003): Performance Assessment of
- *            Multiobjective Optimizers: An Analysis and Review. IEEE
- *            Transactions on Evolutionary Computation, 7(2), 117-132.
- *
- * Compile:
- *   gcc -lm -o hyp_ind hyp_ind.c
- *
- * Usage:
- *   hyp_ind [<param_file>] <data_file> <reference_set> <output_file>
- *
- *   <param_file> specifies the name of the parameter file for eps_ind; the
- *     file has the following format:
- *
- *       dim <integer>
- *       obj <+|-> <+|-> ...
- *       method <0|1>
- *       nadir <real> <real> ...
- *
- *     The first line defines the number of objectives, the second for each
- *     objective whether it is minimized (-) or maximized, the third
- *     line determines whether the hypervolume is calculated relative to
- *     the reference set (1) or not (0), and the last line gives the worst
- *     value for each objective (reference point).
- *     If the parameter file is omitted, the number of objectives is determined
- *     from the data file and it is assumed that all objectives are to be
- *     minimized, that the nadir point is (2.1, 2.1, ..., 2.1), and that a
- *     a reference set is given (method=1).
- *
- *   <data_file> specifies a file that contains the output of one or
- *     several runs of a selector/variator pair; the format corresponds to
- *     the one defined in the specification of the PISA monitor program.
- *
- *   <reference_set> is the name of a file that contains the reference set
- *     according to which the indicator values are calculated; the file
- *     format is the same as for the data file.
- *
- *   <output_file> defines the name of the file to which the computed
- *     indicator values are written to.
- *
- * IMPORTANT: In order to make the output of this tool consistent with
- *   the other indicator tools, for method 0 (no reference set) the
- *   negative hypervolume is outputted as indicator value. Thus,
- *   independently of which type of problem (minimization,
- *   maximization, mixed minimization/maximization) and of which type
- *   of method (with or without reference set) one considers, a lower
- *   indicator value corresponds to a better approximation set.
- *
- * Author:
- *   Eckart Zitzler, February 3, 2005 / last update August 9, 2005 */
-
-#include <float.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
-
-#define MAX_LINE_LENGTH  2048 /* maximal length of lines in the files */
-#define MAX_STR_LENGTH  256 /* maximal length of strings in the files */
-
-int  dim;  /* number of objectives */
-int  *obj;  /* obj[i] = 0 means objective i is to be minimized */
-int  method;  /* 0 = no reference set, 1 = with respect to reference set */
-double  *nadir;  /* reference point for hypervolume calculation */
-
-
-int  dominates(double  *point1, double  *point2, int  no_objectives)
-    /* returns true if 'point1' dominates 'points2' with respect to the
-       to the first 'no_objectives' objectives
-    */
-{
-    int  i;
-    int  better_in_any_objective, worse_in_any_objective;
-    
-    better_in_any_objective = 0;
-    worse_in_any_objective = 0;
-    for (i = 0; i < no_objectives && !worse_in_any_objective; i++)
-      if (point1[i] > point2[i])
-	better_in_any_objective = 1;
-      else if (point1[i] < point2[i])
-	worse_in_any_objective = 1;
-    return (!worse_in_any_objective && better_in_any_objective);
-}
-
-int  weakly_dominates(double  *point1, double  *point2, int  no_objectives)
-    /* returns true if 'point1' weakly dominates 'points2' with respect to the
-       to the first 'no_objectives' objectives
-    */
-{
-    int  i;
-    int  worse_in_any_objective;
-    
-    worse_in_any_objective = 0;    
-    for (i = 0; i < no_objectives &&  !worse_in_any_objective; i++)
-      if (point1[i] < point2[i])
-	worse_in_any_objective = 1;
-    return (!worse_in_any_objective);
-} 
-
-void  swap(double  *front, int  i, int  j)
-{
-    int  k;
-    double  temp;
-
-    for (k = 0; k < dim; k++) {
-	temp = front[i * dim + k];
-	front[i * dim + k] = front[j * dim + k];
-	front[j * dim + k] = temp;
-    }
-}
-
-int  filter_nondominated_set(double  *front, int  no_points,
-			     int  no_objectives)
-    /* all nondominated points regarding the first 'no_objectives' dimensions
-       are collected; the points 0..no_points-1 in 'front' are
-       considered; the points in 'front' are resorted, such that points
-       [0..n-1] represent the nondominated points; n is returned
-    */
-{
-    int  i, j;
-    int  n;
-    
-    n = no_points;
-    i = 0;
-    while (i < n) {
-	j = i + 1;
-	while (j < n) {
-	    if (dominates(&(front[i * dim]), &(front[j * dim]),
-			  no_objectives)) {
-		/* remove point 'j' */
-		n--;
-		swap(front, j, n);
-	    }
-	    else if (dominates(&(front[j * dim]), &(front[i * dim]),
-			       no_objectives)) {
-		/* remove point 'i'; ensure that the point copied to index 'i'
-		   is considered in the next outer loop (thus, decrement i) */
-		n--;
-		swap(front, i, n);
-		i--;
-		break;
-	    }
-	    else
-		j++;
-	}
-	i++;
-    }
-    return n;
-}
-
-double  surface_unchanged_to(double  *front, int  no_points, int  objective)
-     /* calculate next value regarding dimension 'objective'; consider
-	points 0..no_points-1 in 'front'
-     */
-{
-  int     i;
-  double  min, value;
-
-  error(no_points < 1, "run-time error");
-  min = front[objective];
-  for (i = 1; i < no_points; i++) {
-    value = front[i * dim + objective];
-    if (value < min)  min = value;
-  }
-  
-  return min;
-} 
-
-int  reduce_nondominated_set(double  *front, int  no_points, int  objective,
-			     double  threshold)
-    /* remove all points which have a value <= 'threshold' regarding the
-       dimension 'objective'; the points [0..no_points-1] in 'front' are
-       considered; 'front' is resorted, such that points [0..n-1] represent
-       the remaining points; 'n' is returned
-    */
-{
-    int  n;
-    int  i;
-    
-    n = no_points;
-    for (i = 0; i < n; i++)
-	if (front[i * dim + objective] <= threshold) {
-	    n--;
-	    swap(front, i, n);
-	}
-    
-    return n;
-} 
-
-double  calc_hypervolume(double  *front, int  no_points, int  no_objectives)
-{
-    int     n;
-    double  volume, distance;
-
-    volume = 0;
-    distance = 0;
-    n = no_points;
-    while (n > 0) {
-	int     no_nondominated_points;
-	double  temp_vol, temp_dist;
-
-	no_nondominated_points = filter_nondominated_set(front, n,
-							 no_objectives - 1);
-	temp_vol = 0;
-	if (no_objectives < 3) {
-	    error(no_nondominated_points < 1, "run-time error");
-	    temp_vol = front[0];
-	}
-	else
-	    temp_vol = calc_hypervolume(front, no_nondominated_points,
-					no_objectives - 1);
-	temp_dist = surface_unchanged_to(front, n, no_objectives - 1);
-	volume += temp_vol * (temp_dist - distance);
-	distance = temp_dist;
-	n = reduce_nondominated_set(front, n, no_objectives - 1, distance);
-    }
-    
-    return volume;
-}
-
-double  calc_ind_value(double  *a, int  size_a)
-{
-    int  i, k;
-    double  temp;
-    
-    /* re-calculate objective values relative to reference point */
-    for (i = 0; i < size_a; i++) {
-        for (k = 0; k < dim; k++) {
-	    switch (obj[k]) {
-	    case 0:
-	        temp = nadir[k] - a[i * dim + k];
-		error(temp < 0, "error in data or reference set file 4");
-		a[i * dim + k] = temp;
-		break;
-	    default:
-	        temp = a[i * dim + k] - nadir[k];
-		error(temp < 0, "error in data or reference set file 3");
-		a[i * dim + k] = temp;
-		break;
-	    }
-	}
-    }
-    /* calculate indicator values */
-    return calc_hypervolume(a, size_a, dim);
-}
-
-void  read_params(FILE  *fp)
-{
-    char str[MAX_STR_LENGTH];
-    int  i;
-    
-    fscanf(fp, "%s", str);
-    error(strcmp(str, "dim") != 0, "error in parameter file");
-    fscanf(fp, "%d", &dim);
-    error(dim <= 0, "error in parameter file");
-    obj = malloc(dim * sizeof(int));
-    nadir = malloc(dim * sizeof(double));
-    error(obj == NULL || nadir == NULL, "memory overflow");
-
-    fscanf(fp, "%s", str);
-    error(strcmp(str, "obj") != 0, "error in parameter file");
-    for (i = 0; i < dim; i++) {
-	fscanf(fp, "%s", str);
-	error(str[0] != '-' && str[0] != '+', "error in parameter file");
-	if (str[0] == '-')
-	    obj[i] = 0;
-	else
-	    obj[i] = 1;
-    }
-
-    fscanf(fp, "%s", str);
-    error(strcmp(str, "method") != 0, "error in parameter file");
-    fscanf(fp, "%d", &method);
-    error(method != 0 && method != 1, "error in parameter file");
-
-    fscanf(fp, "%s", str);
-    error(strcmp(str, "nadir") != 0, "error in parameter file");
-    for (i = 0; i < dim; i++)
-	error(fscanf(fp, "%lf", &(nadir[i])) != 1, "error in parameter file");
-}
-
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp)
-    /* determines the maximum number of points and the number of runs
-       for the data resp. the reference set file; if the array v is
-       specified, the data read in will be stored in v
-    */
-{
-    char  line[MAX_STR_LENGTH];
-    int  i, j;
-    int  new_run;
-    int  no_points;
-    double  number;
-
-    no_points = 0;
-    *max_pointsp = 0;
-    *no_runsp = 0;
-    new_run = 1;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-	if (sscanf(line, "%lf", &number) != 1)
-	    new_run = 1;
-	else {
-	    if (new_run == 1)
-	    {
-		(*no_runsp)++;
-		if (*max_pointsp < no_points)
-		    *max_pointsp = no_points;
-		no_points = 0;
-	    }
-	    new_run = 0;
-	    i = 0;
-	    for (j = 1; j < dim; j++) {
-		while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		    i++;
-		error(sscanf(&(line[i]), "%lf", &number) <= 0,
-		      "error in data or reference set file 2");
-		while (line[i] == ' ' && line[i] != '\0')
-		    i++;
-	    }
-	    no_points++;
-	}
-    }
-    if (*max_pointsp < no_points)
-	*max_pointsp = no_points;
-}
-
-int  determine_dim(FILE  *fp)
-{
-    char  line[MAX_STR_LENGTH];
-    int  i, no_obj;
-    int  line_found, number_found;
-    double  number;
-    
-    no_obj = 0;
-    line_found = 0;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL && !line_found)
-        line_found = sscanf(line, "%lf", &number);
-    if (line_found) {
-	i = 0;
-	do {
-	    no_obj++;
-	    while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		i++;
-	    number_found = sscanf(&(line[i]), "%lf", &number);
-	    while (line[i] == ' ' && line[i] != '\0')
-		i++;
-	} while (number_found == 1);
-    }
-    
-    return no_obj;
-}
-
-void  read_file(FILE  *fp, int  *no_pointsp, double  *points)
-{
-    char  line[MAX_STR_LENGTH];
-    int  i, j, k;
-    int  reading;
-    double  number;
-
-    k = 0;
-    reading = 0;
-    *no_pointsp = 0;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-	if (sscanf(line, "%lf", &number) != 1) {
-	    if (reading)
-		break;
-	}
-	else {
-	    reading = 1;
-	    points[k++] = number;
-	    i = 0;
-	    for (j = 1; j < dim; j++) {
-		while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		    i++;
-		error(sscanf(&(line[i]), "%lf", &number) <= 0,
-		      "error in data or reference set file 1");
-		points[k++] = number;
-		while (line[i] == ' ' && line[i] != '\0')
-		    i++;
-	    }
-	    (*no_pointsp)++;
-	}
-    } 
-}
-
-int  main(int  argc, char  *argv[])
-{
-    int  i;
-    int  no_runs;  /* number of runs */
-    int  max_points;  /* maximum number of points per run */
-    int  ref_set_size;  /* number of points in the reference set */
-    int  curr_run_size;  /* number of points associated with the current run */
-    double  *ref_set;  /* reference set */
-    double  *curr_run; /* objective vectors fur current run */
-    double  ref_set_value;
-    double  ind_value;
-    FILE  *fp, *out_fp;
-    
-    error(argc != 4 && argc != 5,
-	  "Hypervolume indicator - wrong number of arguments:\nhyp_ind parFile datFile refSet outFile");
-
-    /* set parameters */
-    //printf("Valor : %d\n", argc);
-    if (argc == 5) {    
-	fp = fopen(argv[1], "r");
-	error(fp == NULL, "parameter file not found");
-	read_params(fp);
-	fclose(fp);
-    }
-    else {
-	fp = fopen(argv[1], "r");
-	error(fp == NULL, "data file not found");
-	dim = determine_dim(fp);
-	error(dim < 1, "error in data file 55");
-	fclose(fp);
-	obj = malloc(dim * sizeof(int));
-	nadir = malloc(dim * sizeof(double));
-	error(obj == NULL || nadir == NULL, "memory overflow");
-	for (i = 0; i < dim; i++) {
-	    obj[i] = 0;
-	    nadir[i] = 2.1;
-	}
-	method = 1;	
-    }
-
-    /* read reference set */
-    if (method == 1){
-	if (argc == 5){
-	    fp = fopen(argv[3], "r");
-	}
-	else
-	    fp = fopen(argv[2], "r");
-	error(fp == NULL, "reference set file not found");
-	check_file(fp, &no_runs, &max_points);
-	error(no_runs != 1 || max_points < 1, "error in reference set file");
-	ref_set = malloc(dim * max_points * sizeof(double));
-	error(ref_set == NULL, "memory overflow");
-	rewind(fp);
-	read_file(fp, &ref_set_size, ref_set);
-	fclose(fp);
-	no_runs = 0;
-	max_points = 0;
-	ref_set_value = calc_ind_value(ref_set, ref_set_size);
-    }
-    else {
-	ref_set = NULL;
-	ref_set_size = 0;
-    }
-    
-    /* check data file */
-    if (argc == 5)
-	fp = fopen(argv[2], "r");
-    else
-	fp = fopen(argv[1], "r");
-    error(fp == NULL, "data file not found");
-    check_file(fp, &no_runs, &max_points);
-    error(no_runs < 1 || max_points < 1, "error in data file 1");
-    curr_run = malloc(dim * max_points * sizeof(double));
-    rewind(fp);
-
-    /* process data */
-    if (argc == 5)
-	out_fp = fopen(argv[4], "w");
-    else
-	out_fp = fopen(argv[3], "w");
-    error(out_fp == NULL, "output file could not be generated");
-    while (no_runs > 0) {
-	read_file(fp, &curr_run_size, curr_run);
-	ind_value = calc_ind_value(curr_run, curr_run_size);
-	if (method == 1)
-	  fprintf(out_fp, "%.9e\n", ref_set_value - ind_value);
-	else
-	  fprintf(out_fp, "%.9e\n", -ind_value);
-	no_runs--;
-    }
-    fclose(out_fp);
-    fclose(fp);
-}
+/*===========================================================================*
+ * hyp_ind.c: implements the unary hypervolume indicator as proposed in
+ *            Zitzler, E., and Thiele, L. (1998): Multiobjective Optimization
+ *            Using Evolutionary Algorithms - A Comparative Case Study.
+ *            Parallel Problem Solving from Nature (PPSN-V), 292-301; a more
+ *            detailed discussion can be found in
+ *            Zitzler, E., Thiele, L., Laumanns, M., Fonseca, C., and
+ *            Grunert da Fonseca, V (2003): Performance Assessment of
+ *            Multiobjective Optimizers: An Analysis and Review. IEEE
+ *            Transactions on Evolutionary Computation, 7(2), 117-132.
+ *
+ * Compile:
+ *   gcc -I../../utils/reader -I../../utils/trace -o hyp_ind hyp_ind.c hv.cc \
+ *     contrib.cc archive.cc estimate.cc ../permutation/resample.cc \
+ *     ../../utils/dcdflib/pvalues.cc ../../utils/dcdflib/dcdflib.cc \
+ *     ../../utils/reader/reader.cc ../../utils/trace/trace.cc -pthread \
+ *     -lstdc++ -lm
+ *
+ * Usage:
+ *   hyp_ind [<param_file>] <data_file> <reference_set> <output_file>
+ *   hyp_ind --contributions [<param_file>] <data_file> <output_file>
+ *   hyp_ind --reduce <size> [<param_file>] <data_file> <output_file>
+ *   hyp_ind --estimate <error> [--seed <s>] [--samples <n>] [--threads <t>]
+ *     [--confidence <level>] [<param_file>] <data_file> <reference_set>
+ *     <output_file>
+ *
+ *   <param_file> specifies the name of the parameter file for eps_ind; the
+ *     file has the following format:
+ *
+ *       dim <integer>
+ *       obj <+|-> <+|-> ...
+ *       method <0|1>
+ *       nadir <real> <real> ...
+ *
+ *     The first line defines the number of objectives, the second for each
+ *     objective whether it is minimized (-) or maximized, the third
+ *     line determines whether the hypervolume is calculated relative to
+ *     the reference set (1) or not (0), and the last line gives the worst
+ *     value for each objective (reference point).
+ *     If the parameter file is omitted, the number of objectives is determined
+ *     from the data file and it is assumed that all objectives are to be
+ *     minimized, that the nadir point is (2.1, 2.1, ..., 2.1), and that a
+ *     a reference set is given (method=1).
+ *
+ *   <data_file> specifies a file that contains the output of one or
+ *     several runs of a selector/variator pair; the format corresponds to
+ *     the one defined in the specification of the PISA monitor program.
+ *
+ *   <reference_set> is the name of a file that contains the reference set
+ *     according to which the indicator values are calculated; the file
+ *     format is the same as for the data file.
+ *
+ *   <output_file> defines the name of the file to which the computed
+ *     indicator values are written to; if its name ends in .bin, the values
+ *     are written as a one-dimensional binary file with a single run.
+ *
+ *   The data file and the reference set may also be binary files written
+ *   by normalize or filter (see utils/reader/reader.h).
+ *
+ *   With --contributions, the exclusive hypervolume contribution of every
+ *   point of every run is written instead, i.e. the hypervolume the run
+ *   loses without the point (see contrib.h), one line per point and a
+ *   blank line after each run. With --reduce, the point of least
+ *   contribution is removed from each run as long as it has more than
+ *   <size> points, and the points left are written in the format of
+ *   filter, e.g. to limit the size of a reference set. Neither needs a
+ *   reference set, and the method of the parameter file is ignored.
+ *
+ *   With --estimate, fronts of more than HV_EXACT_DIM (4) objectives are
+ *   evaluated by Monte Carlo sampling (see estimate.h), for every run and
+ *   the reference set, until the half-width of the confidence interval at
+ *   the given level (default 0.95) is at most <error> times the estimate,
+ *   or <n> samples (default 10^9) have been drawn. The samples come from
+ *   the random number streams of seed <s> (default 1), so the values do not
+ *   change between calls or with the number of threads <t> (default: one
+ *   per hardware thread). The values are written as without --estimate;
+ *   a line "run value lower upper samples" per run goes to stdout, with
+ *   the interval of the indicator value (for method 1 the one of the
+ *   difference, from the intervals of both hypervolumes). With fewer
+ *   objectives the exact values are computed, with samples 0.
+ *
+ * IMPORTANT: In order to make the output of this tool consistent with
+ *   the other indicator tools, for method 0 (no reference set) the
+ *   negative hypervolume is outputted as indicator value. Thus,
+ *   independently of which type of problem (minimization,
+ *   maximization, mixed minimization/maximization) and of which type
+ *   of method (with or without reference set) one considers, a lower
+ *   indicator value corresponds to a better approximation set.
+ *
+ * Author:
+ *   Eckart Zitzler, February 3, 2005 / last update August 9, 2005 */
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reader.h"
+#include "hv.h"
+#include "contrib.h"
+#include "estimate.h"
+#include "trace.h"
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+#define MAX_LINE_LENGTH  2048 /* maximal length of lines in the files */
+#define MAX_STR_LENGTH  256 /* maximal length of strings in the files */
+
+int  dim;  /* number of objectives */
+int  *obj;  /* obj[i] = 0 means objective i is to be minimized */
+int  method;  /* 0 = no reference set, 1 = with respect to reference set */
+double  *nadir;  /* reference point for hypervolume calculation */
+
+
+void  read_params(FILE  *fp)
+{
+    char str[MAX_STR_LENGTH];
+    int  i;
+    
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "dim") != 0, "error in parameter file");
+    fscanf(fp, "%d", &dim);
+    error(dim <= 0, "error in parameter file");
+    obj = malloc(dim * sizeof(int));
+    nadir = malloc(dim * sizeof(double));
+    error(obj == NULL || nadir == NULL, "memory overflow");
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "obj") != 0, "error in parameter file");
+    for (i = 0; i < dim; i++) {
+	fscanf(fp, "%s", str);
+	error(str[0] != '-' && str[0] != '+', "error in parameter file");
+	if (str[0] == '-')
+	    obj[i] = 0;
+	else
+	    obj[i] = 1;
+    }
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "method") != 0, "error in parameter file");
+    fscanf(fp, "%d", &method);
+    error(method != 0 && method != 1, "error in parameter file");
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "nadir") != 0, "error in parameter file");
+    for (i = 0; i < dim; i++)
+	error(fscanf(fp, "%lf", &(nadir[i])) != 1, "error in parameter file");
+}
+
+int  determine_dim(FILE  *fp)
+{
+    char  line[MAX_STR_LENGTH];
+    int  i, no_obj;
+    int  line_found, number_found;
+    double  number;
+    
+    no_obj = 0;
+    line_found = 0;
+    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL && !line_found)
+        line_found = sscanf(line, "%lf", &number);
+    if (line_found) {
+	i = 0;
+	do {
+	    no_obj++;
+	    while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
+		i++;
+	    number_found = sscanf(&(line[i]), "%lf", &number);
+	    while (line[i] == ' ' && line[i] != '\0')
+		i++;
+	} while (number_found == 1);
+    }
+    
+    return no_obj;
+}
+
+void  write_values(const char  *path, const point_file  *values)
+{
+    FILE  *out_fp;
+    int  i;
+
+    if (binary_file_name(path)) {
+	error(!write_point_file(path, values, NULL),
+	      "output file could not be generated");
+	return;
+    }
+    out_fp = fopen(path, "w");
+    error(out_fp == NULL, "output file could not be generated");
+    for (i = 0; i < values->no_points; i++)
+	fprintf(out_fp, "%.9e\n", values->points[i]);
+    fclose(out_fp);
+}
+
+void  write_runs(const char  *path, const point_file  *pf)
+    /* the points of every run followed by a blank line, as filter writes
+       them */
+{
+    FILE  *out_fp;
+    int  *minmax;
+    int  i, k, r;
+
+    if (binary_file_name(path)) {
+	minmax = malloc(pf->dim * sizeof(int));
+	error(minmax == NULL, "memory overflow");
+	for (k = 0; k < pf->dim; k++)
+	    minmax[k] = (pf->dim == dim && obj[k] == 1) ? 1 : -1;
+	error(!write_point_file(path, pf, minmax),
+	      "output file could not be generated");
+	free(minmax);
+	return;
+    }
+    out_fp = fopen(path, "w");
+    error(out_fp == NULL, "output file could not be generated");
+    for (r = 0; r < pf->no_runs; r++) {
+	for (i = pf->run_start[r]; i < pf->run_start[r + 1]; i++) {
+	    for (k = 0; k < pf->dim; k++)
+		fprintf(out_fp, "%.9e ", pf->points[i * pf->dim + k]);
+	    fprintf(out_fp, "\n");
+	}
+	fprintf(out_fp, "\n");
+    }
+    fclose(out_fp);
+}
+
+void  contribution_mode(const point_file  *data, int  size, const char  *path)
+    /* --contributions (size = 0) and --reduce <size> */
+{
+    point_file  out;  /* contributions or the points left */
+    int  *keep;
+    int  i, k, r, n;
+
+    out.dim = (size == 0) ? 1 : dim;
+    out.no_runs = data->no_runs;
+    out.points = malloc(((size_t)data->no_points * out.dim + 1) * sizeof(double));
+    out.run_start = malloc((data->no_runs + 1) * sizeof(int));
+    keep = malloc((data->no_points + 1) * sizeof(int));
+    error(out.points == NULL || out.run_start == NULL || keep == NULL,
+	  "memory overflow");
+    n = 0;
+    for (r = 0; r < data->no_runs; r++) {
+	const double  *run = &(data->points[data->run_start[r] * dim]);
+	int  size_r = data->run_start[r + 1] - data->run_start[r];
+
+	out.run_start[r] = n;
+	if (size == 0) {
+	    hv_contributions(run, size_r, dim, obj, nadir, &(out.points[n]));
+	    n += size_r;
+	    continue;
+	}
+	hv_reduce(run, size_r, dim, obj, nadir, size, keep);
+	for (i = 0; i < size_r; i++)
+	    if (keep[i]) {
+		for (k = 0; k < dim; k++)
+		    out.points[n * dim + k] = run[i * dim + k];
+		n++;
+	    }
+    }
+    out.run_start[data->no_runs] = n;
+    out.no_points = n;
+    write_runs(path, &out);
+    free(keep);
+    free_point_file(&out);
+}
+
+int  main(int  argc, char  *argv[])
+{
+    int  i, r;
+    int  size = -1;  /* -1 = indicator values, 0 = --contributions,
+			otherwise the size of --reduce */
+    int  first = 1;  /* the first argument after the option */
+    int  nfiles;  /* the number of files besides the parameter file */
+    int  estimate = 0;  /* --estimate */
+    hv_estimate_options  opt;
+    hv_estimate_result  est, ref_est;
+    point_file  ref_set;  /* reference set */
+    point_file  data;  /* objective vectors of all runs */
+    point_file  values;  /* indicator value of each run */
+    double  ref_set_value = 0;
+    double  ind_value;
+    FILE  *fp;
+    const char  *param_path, *data_path, *ref_path, *out_path;
+    trace_span  span;
+    
+    if (argc > 1 && strcmp(argv[1], "--contributions") == 0) {
+	size = 0;
+	first = 2;
+    }
+    else if (argc > 2 && strcmp(argv[1], "--reduce") == 0) {
+	size = atoi(argv[2]);
+	error(size < 1, "the size of --reduce must be at least 1");
+	first = 3;
+    }
+    else if (argc > 2 && strcmp(argv[1], "--estimate") == 0) {
+	estimate = 1;
+	hv_estimate_defaults(&opt);
+	opt.target = atof(argv[2]);
+	error(opt.target < 0, "the error of --estimate must not be negative");
+	for (first = 3; first + 1 < argc; first += 2)
+	    if (strcmp(argv[first], "--seed") == 0)
+		opt.seed = strtoull(argv[first + 1], NULL, 10);
+	    else if (strcmp(argv[first], "--samples") == 0)
+		opt.max_samples = atoll(argv[first + 1]);
+	    else if (strcmp(argv[first], "--threads") == 0)
+		opt.threads = atoi(argv[first + 1]);
+	    else if (strcmp(argv[first], "--confidence") == 0)
+		opt.confidence = atof(argv[first + 1]);
+	    else
+		break;
+	error(opt.max_samples < 1, "the number of samples must be at least 1");
+	error(opt.confidence <= 0 || opt.confidence >= 1,
+	      "the confidence level must be in (0,1)");
+    }
+    nfiles = (size < 0) ? 3 : 2;
+    error(argc - first != nfiles && argc - first != nfiles + 1,
+	  "Hypervolume indicator - wrong number of arguments:\nhyp_ind parFile datFile refSet outFile\nhyp_ind --contributions [parFile] datFile outFile\nhyp_ind --reduce size [parFile] datFile outFile\nhyp_ind --estimate error [--seed s] [--samples n] [--threads t] [--confidence level] [parFile] datFile refSet outFile");
+    param_path = (argc - first == nfiles + 1) ? argv[first++] : NULL;
+    data_path = argv[first];
+    ref_path = (size < 0) ? argv[first + 1] : NULL;
+    out_path = argv[argc - 1];
+
+    /* set parameters */
+    //printf("Valor : %d\n", argc);
+    if (param_path != NULL) {    
+	fp = fopen(param_path, "r");
+	error(fp == NULL, "parameter file not found");
+	read_params(fp);
+	fclose(fp);
+    }
+    else {
+	fp = fopen(data_path, "r");
+	error(fp == NULL, "data file not found");
+	if ((dim = point_file_header(data_path, NULL)) == 0)
+	    dim = determine_dim(fp);
+	error(dim < 1, "error in data file 55");
+	fclose(fp);
+	obj = malloc(dim * sizeof(int));
+	nadir = malloc(dim * sizeof(double));
+	error(obj == NULL || nadir == NULL, "memory overflow");
+	for (i = 0; i < dim; i++) {
+	    obj[i] = 0;
+	    nadir[i] = 2.1;
+	}
+	method = 1;	
+    }
+    if (size >= 0)
+	method = 0;  /* no reference set */
+
+    /* read reference set */
+    trace_begin(&span, "parse");
+    if (method == 1){
+	error(!read_point_file(ref_path, dim, 1, &ref_set),
+	      "reference set file not found");
+	error(ref_set.no_runs != 1 || ref_set.no_points < 1,
+	      "error in reference set file");
+    }
+    
+    /* read data file */
+    error(!read_point_file(data_path, dim, 1, &data),
+	  "data file not found");
+    error(data.no_runs < 1, "error in data file 1");
+    trace_end(&span, NULL, data_path, data.no_points);
+
+    if (size >= 0) {
+	trace_begin(&span, size == 0 ? "contributions" : "reduce");
+	contribution_mode(&data, size, out_path);
+	trace_end(&span, NULL, data_path, data.no_points);
+	free_point_file(&data);
+	return 0;
+    }
+
+    /* process data */
+    trace_begin(&span, "hypervolume");
+    if (method == 1 && estimate) {
+	hv_estimate(ref_set.points, ref_set.no_points, dim, obj, nadir, &opt, 0,
+		    &ref_est);
+	ref_set_value = ref_est.value;
+	free_point_file(&ref_set);
+    }
+    else if (method == 1) {
+	ref_set_value = hv_ind_value(ref_set.points, ref_set.no_points, dim,
+				     obj, nadir);
+	free_point_file(&ref_set);
+    }
+    if (estimate)
+	printf("run value lower upper samples\n");
+    values.dim = 1;
+    values.no_runs = 1;
+    values.no_points = data.no_runs;
+    values.points = malloc((data.no_runs + 1) * sizeof(double));
+    values.run_start = malloc(2 * sizeof(int));
+    error(values.points == NULL || values.run_start == NULL, "memory overflow");
+    values.run_start[0] = 0;
+    values.run_start[1] = data.no_runs;
+    for (r = 0; r < data.no_runs; r++) {
+	if (estimate) {
+	    /* the stream of the reference set is 0 */
+	    hv_estimate(&(data.points[data.run_start[r] * dim]),
+			data.run_start[r + 1] - data.run_start[r], dim, obj,
+			nadir, &opt, r + 1, &est);
+	    ind_value = est.value;
+	}
+	else
+	    ind_value = hv_ind_value(&(data.points[data.run_start[r] * dim]),
+				     data.run_start[r + 1] - data.run_start[r],
+				     dim, obj, nadir);
+	if (method == 1)
+	  values.points[r] = ref_set_value - ind_value;
+	else
+	  values.points[r] = -ind_value;
+	if (estimate)
+	    printf("%d %.9e %.9e %.9e %lld\n", r + 1, values.points[r],
+		   method == 1 ? ref_est.lower - est.upper : -est.upper,
+		   method == 1 ? ref_est.upper - est.lower : -est.lower,
+		   est.samples);
+    }
+    write_values(out_path, &values);
+    trace_end(&span, NULL, data_path, data.no_points);
+    free_point_file(&values);
+    free_point_file(&data);
+}
@@ -0,0 +1,357 @@
+/* igd.cc
+
+Inverted generational distance kernel shared by igd and sts-pipeline, see
+igd.h.
+
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <charconv>
+#include <vector>
+#include "igd.h"
+
+#define PW_BLOCKSIZE 128
+#define NN_BLOCK 256      // points of a per pass of the brute force search
+#define KD_LEAF 16        // points per leaf of the k-d tree
+#define KD_MIN_POINTS 64  // both sets need this many points for the tree
+#define KD_MAX_DIM 8      // beyond this the tree rarely prunes
+
+static double pairwise_sum(const double *a, int n)
+{
+  // numpy's pairwise summation (numpy/core/src/umath/loops_utils.h)
+  if(n<8)
+    {
+      double res=0.;
+      for(int i=0;i<n;i++)
+	res+=a[i];
+      return res;
+    }
+  else if(n<=PW_BLOCKSIZE)
+    {
+      double r[8], res;
+      int i;
+      for(i=0;i<8;i++)
+	r[i]=a[i];
+      for(i=8;i<n-(n%8);i+=8)
+	for(int j=0;j<8;j++)
+	  r[j]+=a[i+j];
+      res=((r[0]+r[1])+(r[2]+r[3]))+((r[4]+r[5])+(r[6]+r[7]));
+      for(;i<n;i++)
+	res+=a[i];
+      return res;
+    }
+  else
+    {
+      int n2=n/2;
+      n2-=n2%8;
+      return pairwise_sum(a, n2)+pairwise_sum(a+n2, n-n2);
+    }
+}
+
+// Both distances are sqrt(sum_k t_k^2); for IGD t_k = ref_k - a_k, for IGD+
+// (all objectives turned into minimized ones) t_k = max(a_k - ref_k, 0).
+// The sums are compared before the square root is taken, which selects the
+// same minimum because sqrt() is monotone.
+
+static inline double term(double r, double a, bool plus)
+{
+  if(!plus)
+    return r-a;
+  double t=a-r;
+  return t<0 ? 0. : t;
+}
+
+static void nearest_columns(const double *ref, int size_ref, const double *a,
+			    int size_a, int dim, bool plus, double *dmin)
+{
+  // brute force over the columns of a; the loops over the points of a
+  // block have no branches and are vectorized
+  double *col=(double *)malloc(((size_t)dim*size_a+1)*sizeof(double));
+  double s[NN_BLOCK];
+  if(col==NULL)
+    fprintf(stderr, "memory overflow\n"), exit(1);
+  for(int j=0;j<size_a;j++)
+    for(int k=0;k<dim;k++)
+      col[(size_t)k*size_a+j]=a[(size_t)j*dim+k];
+
+  for(int i=0;i<size_ref;i++)
+    {
+      const double *r=&ref[(size_t)i*dim];
+      double best=INFINITY;
+      for(int start=0;start<size_a;start+=NN_BLOCK)
+	{
+	  int n=size_a-start<NN_BLOCK ? size_a-start : NN_BLOCK;
+	  for(int j=0;j<n;j++)
+	    s[j]=0.;
+	  for(int k=0;k<dim;k++)
+	    {
+	      const double *c=&col[(size_t)k*size_a+start];
+	      const double rk=r[k];
+	      if(plus)
+		for(int j=0;j<n;j++)
+		  {
+		    double t=c[j]-rk;
+		    t=t<0 ? 0. : t;
+		    s[j]+=t*t;
+		  }
+	      else
+		for(int j=0;j<n;j++)
+		  {
+		    double t=rk-c[j];
+		    s[j]+=t*t;
+		  }
+	    }
+	  for(int j=0;j<n;j++)
+	    best=s[j]<best ? s[j] : best;
+	}
+      dmin[i]=best;
+    }
+  free(col);
+}
+
+// k-d tree over the points of the approximation set: node i splits its
+// points by objective axis[i] at the value split[i] (the median); the
+// points of the left child are not larger, those of the right child not
+// smaller. Leaves hold up to KD_LEAF points, stored contiguously.
+
+struct kd_tree
+{
+  int dim;
+  bool plus;
+  std::vector<double> p;
+  std::vector<int> lo, hi, axis, left, right;
+  std::vector<double> split;
+};
+
+static int kd_build(kd_tree *t, std::vector<int> &idx, const double *a,
+		    int lo, int hi)
+{
+  int node=(int)t->lo.size();
+  t->lo.push_back(lo);
+  t->hi.push_back(hi);
+  t->axis.push_back(-1);
+  t->split.push_back(0.);
+  t->left.push_back(-1);
+  t->right.push_back(-1);
+  if(hi-lo<=KD_LEAF)
+    return node;
+
+  // split the objective of the largest spread
+  int dim=t->dim, best_k=0;
+  double best_spread=-1.;
+  for(int k=0;k<dim;k++)
+    {
+      double mn=INFINITY, mx=-INFINITY;
+      for(int j=lo;j<hi;j++)
+	{
+	  double v=a[(size_t)idx[j]*dim+k];
+	  mn=v<mn ? v : mn;
+	  mx=v>mx ? v : mx;
+	}
+      if(mx-mn>best_spread)
+	best_spread=mx-mn, best_k=k;
+    }
+  int mid=lo+(hi-lo)/2;
+  std::nth_element(idx.begin()+lo, idx.begin()+mid, idx.begin()+hi,
+		   [&](int x, int y) { return a[(size_t)x*dim+best_k]<a[(size_t)y*dim+best_k]; });
+  t->axis[node]=best_k;
+  t->split[node]=a[(size_t)idx[mid]*dim+best_k];
+  int l=kd_build(t, idx, a, lo, mid);
+  int r=kd_build(t, idx, a, mid, hi);
+  t->left[node]=l;
+  t->right[node]=r;
+  return node;
+}
+
+static void kd_search(const kd_tree *t, int node, const double *r, double *best)
+{
+  const int dim=t->dim;
+  if(t->axis[node]<0)
+    {
+      for(int j=t->lo[node];j<t->hi[node];j++)
+	{
+	  const double *p=&t->p[(size_t)j*dim];
+	  double sum=0.;
+	  for(int k=0;k<dim;k++)
+	    {
+	      double d=term(r[k], p[k], t->plus);
+	      sum+=d*d;
+	    }
+	  if(sum<*best)
+	    *best=sum;
+	}
+      return;
+    }
+
+  // every term of a point beyond the split is at least the term of the
+  // split value (the rounding is monotone), and so is the whole sum
+  int k=t->axis[node];
+  double d=r[k]-t->split[node];
+  bool go_left=d<0;
+  kd_search(t, go_left ? t->left[node] : t->right[node], r, best);
+  double bound;
+  if(!t->plus)
+    bound=d*d;
+  else if(go_left)
+    {
+      // the right child holds a_k >= split > r_k
+      double e=term(r[k], t->split[node], true);
+      bound=e*e;
+    }
+  else
+    bound=0.;
+  if(bound<*best)
+    kd_search(t, go_left ? t->right[node] : t->left[node], r, best);
+}
+
+static void nearest_kd_tree(const double *ref, int size_ref, const double *a,
+			    int size_a, int dim, bool plus, double *dmin)
+{
+  kd_tree t;
+  std::vector<int> idx(size_a);
+  for(int j=0;j<size_a;j++)
+    idx[j]=j;
+  t.dim=dim;
+  t.plus=plus;
+  kd_build(&t, idx, a, 0, size_a);
+  t.p.resize((size_t)size_a*dim);
+  for(int j=0;j<size_a;j++)
+    memcpy(&t.p[(size_t)j*dim], &a[(size_t)idx[j]*dim], dim*sizeof(double));
+
+  for(int i=0;i<size_ref;i++)
+    {
+      double best=INFINITY;
+      kd_search(&t, 0, &ref[(size_t)i*dim], &best);
+      dmin[i]=best;
+    }
+}
+
+static double mean_distance(const double *ref, int size_ref, const double *a,
+			    int size_a, int dim, bool plus)
+{
+  double *dmin=(double *)malloc((size_ref+1)*sizeof(double));
+  if(dmin==NULL)
+    fprintf(stderr, "memory overflow\n"), exit(1);
+
+  if(size_a>=KD_MIN_POINTS && size_ref>=KD_MIN_POINTS && dim<=KD_MAX_DIM)
+    nearest_kd_tree(ref, size_ref, a, size_a, dim, plus, dmin);
+  else
+    nearest_columns(ref, size_ref, a, size_a, dim, plus, dmin);
+  for(int i=0;i<size_ref;i++)
+    dmin[i]=sqrt(dmin[i]);
+
+  double value=pairwise_sum(dmin, size_ref)/size_ref;
+  free(dmin);
+  return value;
+}
+
+double igd_value(const double *ref, int size_ref, const double *a, int size_a,
+		 int dim)
+{
+  return mean_distance(ref, size_ref, a, size_a, dim, false);
+}
+
+double igd_plus_value(const double *ref, int size_ref, const double *a,
+		      int size_a, int dim, const int *obj)
+{
+  // a maximized objective is negated in both sets, which turns ref_k - a_k
+  // into (-a_k) - (-ref_k) without changing its value
+  bool any_max=false;
+  for(int k=0;k<dim;k++)
+    any_max=any_max || obj[k]!=0;
+  if(!any_max)
+    return mean_distance(ref, size_ref, a, size_a, dim, true);
+
+  std::vector<double> r(ref, ref+(size_t)size_ref*dim), b(a, a+(size_t)size_a*dim);
+  for(int k=0;k<dim;k++)
+    if(obj[k]!=0)
+      {
+	for(int i=0;i<size_ref;i++)
+	  r[(size_t)i*dim+k]=-r[(size_t)i*dim+k];
+	for(int j=0;j<size_a;j++)
+	  b[(size_t)j*dim+k]=-b[(size_t)j*dim+k];
+      }
+  return mean_distance(r.data(), size_ref, b.data(), size_a, dim, true);
+}
+
+void igd_format(double v, char *buf, size_t size)
+{
+  // Python picks the shortest digit string that round-trips (like
+  // to_chars) and prints it in exponent notation if the decimal point
+  // would be more than 16 places right or 4 places left of it.
+  char digits[32];
+  char sci[64];
+
+  if(isnan(v))
+    {
+      snprintf(buf, size, "nan");
+      return;
+    }
+  if(isinf(v))
+    {
+      snprintf(buf, size, v<0 ? "-inf" : "inf");
+      return;
+    }
+
+  std::to_chars_result r=std::to_chars(sci, sci+sizeof(sci)-1, v, std::chars_format::scientific);
+  *r.ptr='\0';
+
+  const char *s=sci;
+  bool negative=(*s=='-');
+  if(negative)
+    s++;
+  int nd=0;
+  for(;*s!='e';s++)
+    if(*s!='.')
+      digits[nd++]=*s;
+  digits[nd]='\0';
+  int decpt=atoi(s+1)+1;
+
+  char *out=buf;
+  char *end=buf+size-1;
+#define PUT(c) do { if(out<end) *out++=(c); } while(0)
+  if(negative)
+    PUT('-');
+  if(v==0.0)
+    {
+      PUT('0'); PUT('.'); PUT('0');
+    }
+  else if(decpt<=-4||decpt>16)
+    {
+      PUT(digits[0]);
+      if(nd>1)
+	{
+	  PUT('.');
+	  for(int i=1;i<nd;i++)
+	    PUT(digits[i]);
+	}
+      char exp[16];
+      snprintf(exp, sizeof(exp), "e%+03d", decpt-1);
+      for(char *e=exp;*e;e++)
+	PUT(*e);
+    }
+  else if(decpt<=0)
+    {
+      PUT('0'); PUT('.');
+      for(int i=0;i<-decpt;i++)
+	PUT('0');
+      for(int i=0;i<nd;i++)
+	PUT(digits[i]);
+    }
+  else
+    {
+      for(int i=0;i<decpt;i++)
+	PUT(i<nd ? digits[i] : '0');
+      PUT('.');
+      if(decpt>=nd)
+	PUT('0');
+      for(int i=decpt;i<nd;i++)
+	PUT(digits[i]);
+    }
+#undef PUT
+  *out='\0';
+}
@@ -0,0 +1,38 @@
+/* igd.h
+
+Inverted generational distance kernel shared by igd and sts-pipeline. The
+value is computed the way pymoo's IGD (used by igd.py) computes it, i.e. as
+the mean, over all reference points, of the Euclidean distance to the
+nearest point of the approximation set, with the mean accumulated by
+numpy's pairwise summation so that the results agree bit for bit. IGD+ is
+computed like pymoo's IGDPlus, where only the amounts by which a point is
+worse than the reference point count.
+
+The nearest point is searched by a pass over the approximation set stored
+column by column for small sets, and by a k-d tree over the approximation
+set when both sets are large. Either way the distances are computed, in the
+same order of the objectives, as the plain double loop does, so the choice
+does not change the result.
+
+*/
+
+#ifndef IGD_H
+#define IGD_H
+
+#include <stddef.h>
+
+// returns the IGD of the size_a points in a with respect to the size_ref
+// points in ref; points are stored row-major with dim objectives each
+double igd_value(const double *ref, int size_ref, const double *a, int size_a,
+		 int dim);
+
+// returns the IGD+ of a with respect to ref; obj[k] = 0 means objective k
+// is minimized, any other value that it is maximized
+double igd_plus_value(const double *ref, int size_ref, const double *a,
+		      int size_a, int dim, const int *obj);
+
+// writes v to buf the way Python's repr() prints a float, which is the
+// format igd.py uses for its output files
+void igd_format(double v, char *buf, size_t size);
+
+#endif
@@ -0,0 +1,221 @@
+/*===========================================================================*
+ * igd_ind.cc: computes the inverted generational distance (IGD) and its
+ *             modified version IGD+ as proposed in
+ *             Ishibuchi, H., Masuda, H., Tanigaki, Y., and Nojima, Y. (2015):
+ *             Modified Distance Calculation in Generational Distance and
+ *             Inverted Generational Distance. Evolutionary Multi-Criterion
+ *             Optimization (EMO 2015), 110-125.
+ *
+ *   The program replaces igd.py; the values agree bit for bit with the
+ *   ones of pymoo's IGD and IGDPlus (see igd.h) and are written in the same
+ *   format as igd.py writes them.
+ *
+ * Compile:
+ *   g++ -I../../utils/reader -I../../utils/trace -o igd igd_ind.cc igd.cc \
+ *     ../../utils/reader/reader.cc ../../utils/trace/trace.cc -lm
+ *
+ * Usage:
+ *   igd [<param_file>] <data_file> <reference_set> <output_file>
+ *
+ *   <param_file> specifies the name of the parameter file for igd; the
+ *     file has the following format:
+ *
+ *       dim <integer>
+ *       obj <+|-> <+|-> ...
+ *       method <0|1>
+ *
+ *     The first line defines the number of objectives, the second for each
+ *     objective whether it is minimized (-) or maximized, and the third
+ *     line determines whether IGD (0) or IGD+ (1) is computed; the
+ *     objective senses only matter for IGD+.
+ *     If the parameter file is omitted, default parameters are taken (all
+ *     objectives are to be minimized, method = 0) and the number of
+ *     objectives is determined from the data file.
+ *
+ *   <data_file> specifies a file that contains the output of one or
+ *     several runs of a selector/variator pair; the format corresponds to
+ *     the one defined in the specification of the PISA monitor program.
+ *
+ *   <reference_set> is the name of a file that contains the reference set
+ *     according to which the indicator values are calculated; the file
+ *     format is the same as for the data file, and as in igd.py all of its
+ *     points form one set.
+ *
+ *   <output_file> defines the name of the file to which the computed
+ *     indicator values are written to; if its name ends in .bin, the values
+ *     are written as a one-dimensional binary file with a single run.
+ *
+ *   The data file and the reference set may also be binary files written
+ *   by normalize or filter (see utils/reader/reader.h).
+ *
+ *   As for the other indicators, a lower value corresponds to a better
+ *   approximation set.
+ *===========================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reader.h"
+#include "igd.h"
+#include "trace.h"
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+#define MAX_LINE_LENGTH  2048 /* maximal length of lines in the files */
+#define MAX_STR_LENGTH  256 /* maximal length of strings in the files */
+
+int  dim;  /* number of objectives */
+int  *obj;  /* obj[i] = 0 means objective i is to be minimized */
+int  method;  /* 0 = IGD, 1 = IGD+ */
+
+
+void  read_params(FILE  *fp)
+{
+    char str[MAX_STR_LENGTH];
+    int  i;
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "dim") != 0, "error in parameter file");
+    fscanf(fp, "%d", &dim);
+    error(dim <= 0, "error in parameter file");
+    obj = (int *)malloc(dim * sizeof(int));
+    error(obj == NULL, "memory overflow");
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "obj") != 0, "error in parameter file");
+    for (i = 0; i < dim; i++) {
+	fscanf(fp, "%s", str);
+	error(str[0] != '-' && str[0] != '+', "error in parameter file");
+	if (str[0] == '-')
+	    obj[i] = 0;
+	else
+	    obj[i] = 1;
+    }
+
+    fscanf(fp, "%s", str);
+    error(strcmp(str, "method") != 0, "error in parameter file");
+    fscanf(fp, "%d", &method);
+    error(method != 0 && method != 1, "error in parameter file");
+}
+
+int  determine_dim(FILE  *fp)
+{
+    char  line[MAX_LINE_LENGTH];
+    int  i, no_obj;
+    int  line_found, number_found;
+    double  number;
+
+    no_obj = 0;
+    line_found = 0;
+    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL && !line_found)
+        line_found = sscanf(line, "%lf", &number);
+    if (line_found) {
+	i = 0;
+	do {
+	    no_obj++;
+	    while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
+		i++;
+	    number_found = sscanf(&(line[i]), "%lf", &number);
+	    while (line[i] == ' ' && line[i] != '\0')
+		i++;
+	} while (number_found == 1);
+    }
+
+    return no_obj;
+}
+
+void  write_values(const char  *path, const point_file  *values)
+{
+    FILE  *out_fp;
+    char  buf[64];
+    int  i;
+
+    if (binary_file_name(path)) {
+	error(!write_point_file(path, values, NULL),
+	      "output file could not be generated");
+	return;
+    }
+    out_fp = fopen(path, "w");
+    error(out_fp == NULL, "output file could not be generated");
+    for (i = 0; i < values->no_points; i++) {
+	igd_format(values->points[i], buf, sizeof(buf));
+	fprintf(out_fp, "%s\n", buf);
+    }
+    fclose(out_fp);
+}
+
+int  main(int  argc, char  *argv[])
+{
+    int  i, r;
+    point_file  ref_set;  /* reference set */
+    point_file  data;  /* objective vectors of all runs */
+    point_file  values;  /* indicator value of each run */
+    FILE  *fp;
+    const char  *data_path;
+    trace_span  span;
+
+    error(argc != 4 && argc != 5,
+	  "IGD indicator - wrong number of arguments:\nigd [parFile] datFile refSet outFile");
+
+    /* set parameters */
+    if (argc == 5) {
+	fp = fopen(argv[1], "r");
+	error(fp == NULL, "parameter file not found");
+	read_params(fp);
+	fclose(fp);
+    }
+    else {
+	fp = fopen(argv[1], "r");
+	error(fp == NULL, "data file not found");
+	if ((dim = point_file_header(argv[1], NULL)) == 0)
+	    dim = determine_dim(fp);
+	error(dim < 1, "error in data file");
+	fclose(fp);
+	obj = (int *)malloc(dim * sizeof(int));
+	error(obj == NULL, "memory overflow");
+	for (i = 0; i < dim; i++)
+	    obj[i] = 0;
+	method = 0;
+    }
+
+    /* read reference set */
+    data_path = argv[argc == 5 ? 2 : 1];
+    trace_begin(&span, "parse");
+    error(!read_point_file(argv[argc == 5 ? 3 : 2], dim, 0, &ref_set),
+	  "reference set file not found");
+    error(ref_set.no_points < 1, "error in reference set file");
+
+    /* read data file */
+    error(!read_point_file(data_path, dim, 1, &data),
+	  "data file not found");
+    error(data.no_runs < 1, "error in data file");
+    trace_end(&span, NULL, data_path, data.no_points);
+
+    /* process data */
+    trace_begin(&span, "igd");
+    values.dim = 1;
+    values.no_runs = 1;
+    values.no_points = data.no_runs;
+    values.points = (double *)malloc((data.no_runs + 1) * sizeof(double));
+    values.run_start = (int *)malloc(2 * sizeof(int));
+    error(values.points == NULL || values.run_start == NULL, "memory overflow");
+    values.run_start[0] = 0;
+    values.run_start[1] = data.no_runs;
+    for (r = 0; r < data.no_runs; r++) {
+	const double  *run = &(data.points[data.run_start[r] * dim]);
+	int  size = data.run_start[r + 1] - data.run_start[r];
+	if (method == 0)
+	    values.points[r] = igd_value(ref_set.points, ref_set.no_points,
+					 run, size, dim);
+	else
+	    values.points[r] = igd_plus_value(ref_set.points, ref_set.no_points,
+					      run, size, dim, obj);
+    }
+    write_values(argv[argc == 5 ? 4 : 3], &values);
+    trace_end(&span, NULL, data_path, data.no_points);
+    free_point_file(&values);
+    free_point_file(&ref_set);
+    free_point_file(&data);
+    return 0;
+}
@@ -0,0 +1,140 @@
+/* kruskal.cc
+
+Kruskal-Wallis test kernel shared by kruskal-wallis and sts-pipeline.
+See kruskal-wallis.cc (C) Joshua Knowles, 2005 for a description of the test,
+as described in W.J.Conover (1999) "Practical Nonparametric Statistics (3rd Edition)", Wiley.
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "pvalues.h"
+#include "kruskal.h"
+
+void kruskal_wallis(D *d, int N, int ndist, int *Nsamp, double alpha,
+		    bool verbose, FILE *log, FILE *err, FILE *out)
+{
+  int i, j;
+
+  for( i=0;i<ndist;i++)
+    if(Nsamp[i]<20)
+      {
+	fprintf(err, "Warning: Sample population %d is of size %d. This software is not using a correction for small samples. Your samples should contain at least 20 values: the p-values returned for tests with this sample will be approximate.\n", i+1, Nsamp[i]);
+      }
+
+  rank_engine r;
+  r.rank(d, N, ndist, false);
+  int t = r.ties;
+
+  if(verbose)
+    {
+      for( i=0;i<N;i++)
+	{
+	  fprintf(log, "%g %d %.2g\n", d[i].value, d[i].label, d[i].rank);
+	}
+      fprintf(log,"Total number of ties =%d\n", t);
+    }
+
+  if(verbose)
+    for( j=0;j<ndist;j++)
+      fprintf(log, "Number of samples = %d; sum = %g\n", Nsamp[j], r.sum[j]);
+
+  double T;
+  T=Tvalue(r);
+
+  if(verbose)
+    fprintf(log, "Corrected T value =%g\n", T );
+
+  double allsame;
+  chi_tails(&T, 1, ndist-1, NULL, &allsame);
+
+  if(verbose)
+    fprintf(log, "p-value to accept the null hypothesis that all distribution functions are identical = %.9g\n", allsame);
+
+  if(allsame<=alpha)
+    {
+      // fprintf(out, "Overall p-value = %g. Null hypothesis rejected (alpha %g)\n", allsame, alpha);
+      std::vector<double> q(ndist*ndist);
+      kruskal_pairs(r, T, q.data());
+      for( i=0;i<ndist;i++)
+	for( j=0;j<ndist;j++)
+	  {
+	    if(i==j)
+	      continue;
+	    fprintf(out, "%d better than %d with a p-value of %g\n", j+1,i+1, q[i*ndist+j]);
+	  }
+
+    }
+  else
+    fprintf(out, "H0");
+}
+
+void kruskal_pairs(const rank_engine &r, double T, double *q)
+{
+  // pairwise(j, i) is -pairwise(i, j), so the p-value of j against i is
+  // the lower tail of pairwise(i, j); all pairs are evaluated at once
+  int i, j, k=0, ndist = r.ndist;
+  double S2 = S_squared(r);
+  std::vector<double> t, lower(ndist*ndist), upper(ndist*ndist);
+
+  for( i=0;i<ndist;i++)
+    for( j=i+1;j<ndist;j++)
+      t.push_back(pairwise(i, j, r, S2, T));
+  t_tails(t.data(), (int)t.size(), r.N-ndist, lower.data(), upper.data());
+  for( i=0;i<ndist;i++)
+    {
+      q[i*ndist+i] = 0.0;
+      for( j=i+1;j<ndist;j++, k++)
+	{
+	  q[i*ndist+j] = upper[k];
+	  q[j*ndist+i] = lower[k];
+	}
+    }
+}
+
+double pairwise(int a, int b, const rank_engine &r, double S2, double T)
+{
+  // Implements Equation 6, page 290 of Conover (1999).
+  double value;
+  int N = r.N, ndist = r.ndist;
+
+  value = (r.sum[a]/double(r.n[a])) - (r.sum[b]/double(r.n[b]));
+
+  double denom;
+  denom = sqrt(S2*(N-1.0-T)/(N-ndist)) * sqrt(1.0/r.n[a]+1.0/r.n[b]);
+
+  return(value/denom);
+
+}
+
+double Tvalue(const rank_engine &r)
+{
+  // Equation 3, page 289 Conover (1999)
+
+  double T;
+  double S2;
+  int i, N = r.N;
+
+  S2 = S_squared(r);
+
+  double sum=0.0;
+  for(i=0;i<r.ndist;i++)
+    {
+      sum += (r.sum[i]*r.sum[i])/double(r.n[i]);
+    }
+
+  T = (1.0/S2)*(sum - ((N*(N+1.0)*(N+1.0))/4.0));
+
+  return(T);
+
+}
+
+
+double S_squared(const rank_engine &r)
+{
+  // Equation 4, page 289 of Conover (1999)
+  int N = r.N;
+  return ( (1.0/(N-1.0))*(r.sum_squared - ((N*(N+1.0)*(N+1.0))/4.0)) );
+}
@@ -0,0 +1,33 @@
+/* kruskal.h
+
+Kruskal-Wallis test kernel shared by kruskal-wallis and sts-pipeline.
+The functions were split out of kruskal-wallis.cc (C) Joshua Knowles, 2005;
+the number of sample populations is passed as an argument instead of being
+read from a global variable. The values are ranked once by rank_engine
+(ranks.h), which also holds the rank sums every statistic below needs; the
+p-values of all pairs are evaluated in one batch (pvalues.h).
+
+*/
+
+#ifndef KRUSKAL_H
+#define KRUSKAL_H
+
+#include <stdio.h>
+#include "ranks.h"
+
+double Tvalue(const rank_engine &r);
+double S_squared(const rank_engine &r);
+double pairwise(int a, int b, const rank_engine &r, double S2, double T);
+
+// q[i*ndist+j] = the one-tailed p-value of the pair-wise test of sample j
+// being better than sample i, for the ranked samples of r and the corrected
+// T value T; q holds ndist*ndist values, the diagonal is set to 0
+void kruskal_pairs(const rank_engine &r, double T, double *q);
+
+// Runs the complete test on the N labelled values in d (which are sorted
+// and ranked in place). The pair-wise p-values, or "H0", are written to out,
+// warnings to err and, with verbose set, the intermediate results to log.
+void kruskal_wallis(D *d, int N, int ndist, int *Nsamp, double alpha,
+		    bool verbose, FILE *log, FILE *err, FILE *out);
+
+#endif
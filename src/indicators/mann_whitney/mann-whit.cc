@@ -2,9 +2,11 @@
 
 Implements a nonparametric test for differences between precisely two independent samples,
 as described in W.J.Conover (1999) "Practical Nonparametric Statistics (3rd Edition)", Wiley.
-The version here uses T1 - the equation to correct for ties in the inputs. However, it does
-not compute corrections for small samples. Instead, a warning is issued if either
-sample is smaller than 20.
+For two samples of at most 20 values without ties between them, the p-value is taken from
+the exact distribution of the rank-sum statistic, which is tabulated at compile time (see
+utils/ranks/exact.h). Otherwise the version here uses T1 - the equation to correct for ties
+in the inputs - and the normal approximation, and a warning is issued for a sample smaller
+than 20 that is tested this way.
 
 This version accepts multiple (more than two) samples. In that case, the test is
 carried out for each pair and a warning, which advises the p-values are not
@@ -15,7 +17,7 @@ accurate because the samples are no longer independent random samples, is issued
 Compile and link with the attached Makefile:
    make mann-whit
    OU
-   g++ mann-whit.cc dcdflib.o -o mann-whit // by Felipe
+   g++ mann-whit.cc mwu.cc ranks.o exact.o pvalues.o dcdflib.o -o mann-whit // by Felipe
 
 Run:
    ./mann-whit <indicator_file> <param_file> <output_file>
@@ -42,43 +44,34 @@ Output:
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
-#include "../../utils/dcdflib/dcdflib.h"
+#include <vector>
+#include "reader.h"
+#include "ranks.h"
+#include "mwu.h"
+#include "trace.h"
 // using namespace std;
 
 #define RN rand()/(RAND_MAX+1.0)
 #define MAX_STR_LENGTH 100
 #define MAX_LINE_LENGTH 100
-#define MAX_DISTS 30
 #define VERBOSE true
 
-typedef struct data
-{
-  double value;
-  int label;
-  double rank;
-}D;
-
 D *d;
-D *pair;
 int N; // the total number of values in the input
 int *Nsamp; // the number of values in each sample population
 int ndist; // the number of sample populations
 FILE *fp;
+point_file values; // the contents of the indicator file
 
 double myabs(double v);
-double myZ(double x);
-int compare(const void *, const void *);
-int assign_ranks(D *d, int N);
-double sum_of_ranks(D *d, int index, int N);
-double sum_squared_ranks(D *d, int N);
-double corrected_Tvalue(D *d, int n, int m, int N, int idx);
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp, int *Nsamp);
-void  read_file(FILE  *fp, int  *no_pointsp, D *d);
+void print_pair(FILE *out, const D *d, const std::vector<int> &a, const std::vector<int> &b);
+void  read_samples(const point_file *pf, int *no_runsp, int *totalp, int *Nsamp, D *d);
 
 int main(int argc, char **argv)
 {
     int i, j, k;
   int test=1;
+  trace_span span;
   
   if(argc!=4)
     {
@@ -94,15 +87,16 @@ int main(int argc, char **argv)
     }
 
 
-  Nsamp = (int *)malloc(MAX_DISTS*sizeof(int));
-  for(j=0;j<MAX_DISTS;j++) Nsamp[j] = 0;
-
-  if((fp=fopen(argv[1],"rb")))
+  trace_begin(&span, "parse");
+  if(read_point_file(argv[1], 1, 1, &values))
     {
-      check_file(fp, &ndist, &N, Nsamp);
+      d = (D *)malloc((values.no_points+1) *sizeof(D));
+      Nsamp = (int *)malloc((values.no_runs+1)*sizeof(int));
+      for(j=0;j<=values.no_runs;j++) Nsamp[j] = 0;
+      read_samples(&values, &ndist, &N, Nsamp, d);
+      free_point_file(&values);
       if(VERBOSE)
     fprintf(stdout, "Number of samples (populations) = %d. Total number of values in the input = %d\n", ndist, N);
-      rewind(fp);
       if(VERBOSE)
     {
       fprintf(stdout,"Numbers of values in each sample = ");
@@ -110,33 +104,46 @@ int main(int argc, char **argv)
         fprintf(stdout,"%d ", Nsamp[j]);
       fprintf(stdout,"\n");
     }      
-      d = (D *)malloc(N *sizeof(D));
-      pair = (D *)malloc(N *sizeof(D));
-      read_file(fp, &N, d);
-      fclose(fp);
     }
   else
     {
       fprintf(stderr,"Couldn't open %s for reading\n", argv[1]);
       exit(1);
     }
+  trace_end(&span, NULL, argv[1], N);
   
 
+  trace_begin(&span, "mann-whitney");
+  // all values are ranked once; the rank sums of every pair of samples
+  // follow from the joint ranking (see ranks.h)
+  rank_engine r;
+  r.rank(d, N, ndist, true);
+  std::vector<std::vector<int> > sorted(ndist); // the values of each sample in sorted order
+  for(i=0;i<N;i++)
+    sorted[d[i].label].push_back(i);
+
   for(i=0;i<ndist;i++)
     if(Nsamp[i]<20)
       {
-    fprintf(stderr, "Warning: Sample population %d is of size %d. This software is not using a correction for small samples. Your samples should contain at least 20 values: the p-values returned for tests with this sample will be approximate.\n", i+1, Nsamp[i]);
+    for(k=0;k<ndist;k++)
+      if(k!=i && !exact_pair(r, i, k))
+        break;
+    if(k<ndist)
+      fprintf(stderr, "Warning: Sample population %d is of size %d. This software is not using a correction for small samples. Your samples should contain at least 20 values: the p-values returned for tests with this sample will be approximate.\n", i+1, Nsamp[i]);
       }
 
-  if((fp=fopen(argv[3],"w")))
-    fclose(fp);
-  else
+  // the results are written through a single stream, opened once
+  FILE *out;
+  if(!(out=fopen(argv[3],"w")))
     {
       fprintf(stderr,"Couldn't open %s for writing.\n", argv[3]);
       exit(1);
     }
   
 
+  std::vector<mwu_pair> pairs;
+  mann_whitney_pairs(r, pairs);
+
   for(j=0;j<ndist;j++)
     {
       for(k=0;k<ndist;k++)
@@ -145,195 +152,74 @@ int main(int argc, char **argv)
         continue;
       if(VERBOSE)
         fprintf(stdout, "\n\n**** Test %d between %d and %d ****\n", test++, j+1, k+1);
-      int start=0;
-      for(i=0;i<j;i++)
-        start+=Nsamp[i];
-      for(i=0;i<Nsamp[j];i++)
-        {
-          pair[i].value = d[i+start].value;
-          pair[i].label = j;
-        }
-      start=0;
-      for(i=0;i<k;i++)
-        start+=Nsamp[i];
-      for(i=0;i<Nsamp[k];i++)
-        {
-          pair[i+Nsamp[j]].value = d[i+start].value;
-          pair[i+Nsamp[j]].label = k;
-        }
-
-      qsort(pair, Nsamp[j]+Nsamp[k], sizeof(D), compare);
-      int t = assign_ranks(pair, Nsamp[j]+Nsamp[k]);
 
       if(VERBOSE)
         {
-          for(i=0;i<Nsamp[j]+Nsamp[k];i++)
-        {
-          fprintf(stdout, "%g %d %.2g\n", pair[i].value, pair[i].label, pair[i].rank);
-        }
-          fprintf(stdout,"Total number of ties =%d\n", t);
+          print_pair(stdout, d, sorted[j], sorted[k]);
+          fprintf(stdout,"Total number of ties =%d\n", r.pair_ties(j, k));
         }
       
       if(VERBOSE)
         {
-          fprintf(stdout, "Number of samples = %d; sum = %g\n", Nsamp[j], sum_of_ranks(pair, j, Nsamp[j]));
-          fprintf(stdout, "Number of samples = %d; sum = %g\n", Nsamp[k], sum_of_ranks(pair, k, Nsamp[k]));
+          fprintf(stdout, "Number of samples = %d; sum = %g\n", Nsamp[j], r.pair_rank_sum(j, k));
+          fprintf(stdout, "Number of samples = %d; sum = %g\n", Nsamp[k], r.pair_rank_sum(k, j));
         }
       
-      double T;
-      double p_value;
-      T=corrected_Tvalue(pair, Nsamp[j], Nsamp[k], Nsamp[j]+Nsamp[k], j);
-      p_value= (1.0-myZ(T));
+      const mwu_pair &t = pairs[j*ndist+k];
+      double p_value = t.p_value;
       if(VERBOSE)
-        fprintf(stdout, "Corrected T value =%g\n", T );
-      if(VERBOSE)
-        fprintf(stdout, "One-tailed p-value = %.9g\n", p_value);
-      if((fp=fopen(argv[3],"a")))
-        {
-          fprintf(fp, "%d better than %d with a p-value of  %.9g\n", k+1, j+1, p_value);
-          fclose(fp);
-        }
-      else
         {
-          fprintf(stderr, "Couldn't open output file for writing\n");
-          exit(1);
+          if(t.exact)
+            fprintf(stdout, "Using the exact distribution of the rank-sum statistic; U =%g\n", t.statistic);
+          else
+            fprintf(stdout, "Corrected T value =%g\n", t.statistic );
         }
+      if(VERBOSE)
+        fprintf(stdout, "One-tailed p-value = %.9g\n", p_value);
+      fprintf(out, "%d better than %d with a p-value of  %.9g\n", k+1, j+1, p_value);
+    }
     }
+  if(fclose(out)!=0)
+    {
+      fprintf(stderr, "Couldn't open output file for writing\n");
+      exit(1);
     }
   if(ndist>2)
     fprintf(stderr, "Warning: the p-values for accepting the null hypothesis that these are two samples from the same underlying distribution are not correct because multiple tests have been carried out using the same sample. Therefore, these values should only be used in preliminary (explorative) tests, and do not indicate true probabilities. Consider collecting new, independent random samples for each statistical test to be performed. Alternatively, use the Kruskal-Wallis test.\n");
+  trace_end(&span, NULL, argv[1], N);
  
   return(0);
 }
 
-double myZ(double x)
-{ 
-  // returns the p-value that a normal random variate with mean 0 and SD 1 would have a value <= x
-  int which=1;
-  double p;
-  double q;
-  double mean=0.0;
-  double sd=1.0;
-  int status;
-  double bound;
-  cdfnor(&which, &p, &q, &x, &mean, &sd, &status, &bound); // library function for computing the cdf of the normal Z distribution
-  return(p);
-}
-
-double corrected_Tvalue(D *d, int n, int m, int N, int idx)
-{
-  // Equation 2, page 273 of Conover (1999)
-  double T;
-  double T1;
-  double denom;
-  double ssR; // sum of squared Ranks
-
-  T = sum_of_ranks(d,idx,N);
-  ssR = sum_squared_ranks(d, N);
-
-  
-  T1 = (T - ((n*(N+1))/2.0));
-
-  denom = (double(n*m)/double(N*(N-1))*ssR) - double((m*n*(N+1)*(N+1))/double(4*(N-1)));
-  if (T1 == 0.0) return 0.0;
-  
-  return(T1/sqrt(denom));
-  
-}
-
-double sum_squared_ranks(D *d, int N)
-{
-  double sum=0.0;
-  int i;
-  
-  for(i=0;i<N;i++)
-    sum += pow(d[i].rank,2.0);
-  return(sum);
-}
-
-double sum_of_ranks(D *d, int index, int N)
+void print_pair(FILE *out, const D *d, const std::vector<int> &a, const std::vector<int> &b)
 {
-  double sum=0.0;
-  int i;
-  
-  for(i=0;i<N;i++)
-    {
-      if(d[i].label == index)
-    sum+=d[i].rank;
-    }
-
-  return(sum);
-}
-
-int assign_ranks(D *d, int N)
-{
-  // assign ranks to the N values, giving the same (averaged) rank to any tied values
-  // NOTE: the N values in d must be in sorted order
-  int i,j;
+  // prints the values of two samples ranked on their own, as qsort() and
+  // assign_ranks() rank the values of a followed by those of b: the sorted
+  // values are merged, tied values of a ahead of those of b, and every
+  // block of tied values gets the average of its ranks
+  std::vector<int> block;
+  size_t i=0, j=0;
   int crank=1;
-  int totalrank;
-  int count;
-  int total_ties=0;
-  
-  double dtr;
-  double dcount;
-
-  D *ahead;
 
-  i=0;
-  while(i<N)
+  while(i<a.size() || j<b.size())
     {
-      ahead = &(d[i+1]);
-      if(ahead->value == d[i].value)
-    {   
-      totalrank=crank;
-      count=0;
+      block.clear();
       do
         {
-          ahead++;
-          count++;
-          totalrank+=(crank+count);
-          //  printf("i+count=%d\n", i+count);
-        }while((ahead->value == d[i].value)&&(i+count<N-1));
-      // set all the ranks to the average value
-      dtr = (double)totalrank;
-      dcount = (double)(count+1);
-      //      printf("%g\n", dtr/dcount);
-      for(j=0;j<=count;j++)
-        {
-          d[i+j].rank = dtr/dcount; //(double(totalrank)/double(count+1));
-          //  printf("%g\n", d[i+j].rank);
+          if(j==b.size() || (i<a.size() && !(d[b[j]].value < d[a[i]].value)))
+            block.push_back(a[i++]);
+          else
+            block.push_back(b[j++]);
         }
-      i+=count+1;
-      crank+=count+1;
-      total_ties+=count;
+      while((i<a.size() && d[a[i]].value == d[block[0]].value)
+            || (j<b.size() && d[b[j]].value == d[block[0]].value));
+      int count = (int)block.size()-1, totalrank = 0;
+      for(int c=0;c<=count;c++)
+        totalrank += crank+c;
+      for(int c=0;c<=count;c++)
+        fprintf(out, "%g %d %.2g\n", d[block[c]].value, d[block[c]].label, double(totalrank)/double(count+1));
+      crank += count+1;
     }
-      else
-    {
-      d[i].rank=crank;
-      crank++;
-      i++;
-    }
-    }  
-  return(total_ties);
-
-}
-
-
-int compare(const void *i, const void *j)
-{
-  double x;
-  x = (*(D *)i).value - (*(D *)j).value;
-  
-  if(x<0)
-    return(-1);
-
-  else if (x>0)
-    return(1);
-  
-  else
-    return(0);
-
 }
 
 double myabs(double v)
@@ -344,54 +230,20 @@ double myabs(double v)
     return -v;
 }
 
-
-void  check_file(FILE  *fp, int  *no_runsp, int  *totalp, int *Nsamp)
+void  read_samples(const point_file *pf, int *no_runsp, int *totalp, int *Nsamp, D *d)
 {
-  char  line[MAX_STR_LENGTH];
-  double  number;
-  int new_run;
-  
-  *totalp = 0;
-  *no_runsp = 0;
-  new_run = 1;
+  // every run of the indicator file is one sample population
+  int i, j;
 
-  while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-      if (sscanf(line, "%lf", &number) != 1) {
-            new_run = 1;
-      } else {
-            if (new_run == 1) (*no_runsp)++;
-            new_run = 0;
-            (*totalp)++;
-            if(*no_runsp<=MAX_DISTS) {
-                (Nsamp[*no_runsp-1])++;
-            } else {
-                fprintf(stderr,"Please edit MAX_DISTS. Number of sample distributions exceeded the current setting.\n");
-                exit(1);
-            }
-      }
-    
-  }
-  
-}
-
-void  read_file(FILE  *fp, int  *no_pointsp, D *d)
-{
-  char  line[MAX_STR_LENGTH];
-  double  number;
-  int clabel=0;
-  
-  *no_pointsp = 0;
-  while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) 
-    {
-      if (sscanf(line, "%lf", &number) != 1)
-    {
-      clabel++;
-    }
-      else 
+  *no_runsp = pf->no_runs;
+  *totalp = pf->no_points;
+  for(j=0;j<pf->no_runs;j++)
     {
-      d[*no_pointsp].value = number;
-      d[*no_pointsp].label = clabel;
-      (*no_pointsp)++;
+      Nsamp[j] = pf->run_start[j+1]-pf->run_start[j];
+      for(i=pf->run_start[j];i<pf->run_start[j+1];i++)
+	{
+	  d[i].value = pf->points[i];
+	  d[i].label = j;
+	}
     }
-    } 
 }
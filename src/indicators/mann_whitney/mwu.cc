@@ -0,0 +1,69 @@
+/* mwu.cc
+
+Mann-Whitney test kernel shared by mann-whit and libsts.
+See mann-whit.cc (C) Joshua Knowles, 2005 for a description of the test,
+as described in W.J.Conover (1999) "Practical Nonparametric Statistics (3rd Edition)", Wiley.
+
+*/
+
+#include <math.h>
+#include "exact.h"
+#include "pvalues.h"
+#include "mwu.h"
+
+void mann_whitney_pairs(const rank_engine &r, std::vector<mwu_pair> &pairs)
+{
+  int j, k, ndist = r.ndist;
+  const std::vector<int> &Nsamp = r.n;
+
+  // the normal approximations of all pairs are evaluated at once
+  std::vector<double> T(ndist*ndist, 0.0), Z(ndist*ndist, 0.0);
+  for(j=0;j<ndist;j++)
+    for(k=0;k<ndist;k++)
+      if(j!=k && !exact_pair(r, j, k))
+        T[j*ndist+k]=corrected_Tvalue(r.pair_rank_sum(j, k), r.pair_sum_squared(j, k), Nsamp[j], Nsamp[k], Nsamp[j]+Nsamp[k]);
+  normal_tails(T.data(), ndist*ndist, Z.data(), NULL);
+
+  pairs.assign(ndist*ndist, mwu_pair());
+  for(j=0;j<ndist;j++)
+    for(k=0;k<ndist;k++)
+      {
+	mwu_pair &p = pairs[j*ndist+k];
+	p.exact = false;
+	p.statistic = 0.0;
+	p.p_value = 0.0;
+	if(j==k)
+	  continue;
+	if(exact_pair(r, j, k))
+	  {
+	    // P(U >= u) for U = T - n(n+1)/2, the exact counterpart of 1-P(Z <= T1)
+	    p.exact = true;
+	    p.statistic = r.pair_rank_sum(j, k) - Nsamp[j]*(Nsamp[j]+1)/2.0;
+	    p.p_value = rank_sum_upper(Nsamp[j], Nsamp[k], p.statistic);
+	  }
+	else
+	  {
+	    p.statistic = T[j*ndist+k];
+	    p.p_value = 1.0-Z[j*ndist+k];
+	  }
+      }
+}
+
+double corrected_Tvalue(double T, double ssR, int n, int m, int N)
+{
+  double T1;
+  double denom;
+
+  T1 = (T - ((n*(N+1))/2.0));
+
+  denom = (double(n*m)/double(N*(N-1))*ssR) - double((m*n*(N+1)*(N+1))/double(4*(N-1)));
+  if (T1 == 0.0) return 0.0;
+
+  return(T1/sqrt(denom));
+
+}
+
+bool exact_pair(const rank_engine &r, int j, int k)
+{
+  return r.n[j]<=RANK_SUM_MAX_N && r.n[k]<=RANK_SUM_MAX_N && r.pair_ties(j, k)==0;
+}
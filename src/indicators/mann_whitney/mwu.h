@@ -0,0 +1,38 @@
+/* mwu.h
+
+Mann-Whitney test kernel shared by mann-whit and libsts. The statistics
+were split out of mann-whit.cc (C) Joshua Knowles, 2005; the sample sizes
+are taken from the rank_engine (ranks.h) instead of global variables. All
+values are ranked once, and the rank sums of every pair of samples follow
+from the joint ranking; the normal approximations of all pairs are
+evaluated in one batch (pvalues.h).
+
+*/
+
+#ifndef MWU_H
+#define MWU_H
+
+#include <vector>
+#include "ranks.h"
+
+struct mwu_pair
+{
+  bool exact;        // the p-value is taken from the exact distribution
+  double statistic;  // U if exact, the corrected T value (T1) otherwise
+  double p_value;    // one-tailed
+};
+
+// Equation 2, page 273 of Conover (1999); T is the sum of the ranks of the
+// first sample and ssR the sum of the squared ranks of both samples
+double corrected_Tvalue(double T, double ssR, int n, int m, int N);
+
+// true if the exact table holds the distribution of the pair j, k, i.e. for
+// untied samples of at most RANK_SUM_MAX_N values
+bool exact_pair(const rank_engine &r, int j, int k);
+
+// pairs[j*ndist+k] = the test of sample k being better than sample j, for
+// the samples ranked by r.rank(d, N, ndist, true); the diagonal is left
+// with p-value 0
+void mann_whitney_pairs(const rank_engine &r, std::vector<mwu_pair> &pairs);
+
+#endif
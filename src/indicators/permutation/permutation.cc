@@ -0,0 +1,178 @@
+/* permutation.cc
+
+Implements a permutation test for differences between the means (or the medians) of
+independent samples of indicator values, and bootstrap percentile intervals for these
+differences, as described in B. Efron and R.J. Tibshirani (1993) "An Introduction to the
+Bootstrap", Chapman & Hall, chapters 13 and 15. Unlike the rank tests, the p-values do not
+rest on an asymptotic distribution; their accuracy only depends on the number of resamples.
+
+As with mann-whit, the test is carried out for each pair of samples if there are more than
+two, and a warning, which advises the p-values are not accurate because the samples are no
+longer independent random samples, is issued.
+
+The resamples are drawn by several threads from counter-based random number streams (see
+resample.h), so the output only depends on the input, the parameters and the seed, not on
+the number of threads.
+
+Compile and link with the attached Makefile:
+   make permutation
+
+Run:
+   ./permutation <indicator_file> <param_file> <output_file>
+
+   where:
+
+   <indicator_file> is the name of a file containing a single column of
+     indicator values. Blank lines in the file divide the separate sample
+     populations;
+   <param_file> is the name of a file with the following format
+
+       statistic mean
+       resamples 100000
+       confidence 0.95
+       seed 1
+       threads 0
+
+     where statistic is mean or median, resamples is the number of random
+     relabellings of the permutation test and of bootstrap resamples of every
+     pair, confidence is the level of the bootstrap intervals, seed selects the
+     random number streams and threads is the number of threads (0: one per
+     hardware thread);
+   <output_file> is a filename to write to.
+
+Output:
+
+   For each pair, the one-tailed p-value for rejecting the null hypothesis that the samples
+   come from the same distribution, in the format of mann-whit ("k better than j with a
+   p-value of p", a lower indicator value being better), followed by the difference of the
+   statistic of each pair and its bootstrap interval.
+
+   A warning message is output if there are multiple (more than two) samples.
+
+   With VERBOSE set to true, some output to stdout is also given.
+
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "reader.h"
+#include "resample.h"
+#include "trace.h"
+
+#define VERBOSE true
+
+int N; // the total number of values in the input
+int ndist; // the number of sample populations
+FILE *fp;
+point_file values; // the contents of the indicator file
+
+int main(int argc, char **argv)
+{
+  int j, k;
+  char str[100];
+  resample_statistic statistic;
+  long resamples;
+  double confidence;
+  unsigned long long seed;
+  int nthreads;
+  trace_span span;
+
+  if(argc!=4)
+    {
+      fprintf(stderr,"./permutation <indicator_file> <param_file> <output_file>\n");
+      exit(1);
+    }
+
+  if((fp=fopen(argv[2],"rb")))
+    {
+      if(fscanf(fp, "%*s %99s %*s %ld %*s %lg %*s %llu %*s %d", str, &resamples, &confidence, &seed, &nthreads)!=5)
+	fprintf(stderr, "Error occurred in parameter file.\n"), exit(1);
+      fclose(fp);
+    }
+  else
+    {
+      fprintf(stderr,"Couldn't open %s for reading\n", argv[2]);
+      exit(1);
+    }
+  if(strcmp(str, "mean")==0)
+    statistic = RESAMPLE_MEAN;
+  else if(strcmp(str, "median")==0)
+    statistic = RESAMPLE_MEDIAN;
+  else
+    fprintf(stderr, "Error occurred in parameter file: the statistic is mean or median.\n"), exit(1);
+  if(resamples<1 || confidence<=0.0 || confidence>=1.0)
+    fprintf(stderr, "Error occurred in parameter file.\n"), exit(1);
+
+  trace_begin(&span, "parse");
+  if(!read_point_file(argv[1], 1, 1, &values))
+    {
+      fprintf(stderr,"Couldn't open %s for reading\n", argv[1]);
+      exit(1);
+    }
+  ndist = values.no_runs;
+  N = values.no_points;
+  for(j=0;j<ndist;j++)
+    if(values.run_start[j+1]==values.run_start[j])
+      fprintf(stderr, "Sample population %d is empty. Exiting.\n", j+1), exit(1);
+  trace_end(&span, NULL, argv[1], N);
+
+  trace_begin(&span, "permutation");
+
+  resample_engine engine(nthreads, seed);
+  if(VERBOSE)
+    {
+      fprintf(stdout, "Number of samples (populations) = %d. Total number of values in the input = %d\n", ndist, N);
+      fprintf(stdout, "%ld resamples per pair on %d threads\n", resamples, engine.threads());
+    }
+
+  // the two tails of the test of j and k come from the same relabellings,
+  // and stream j*ndist+k is used for the pair j < k
+  std::vector<permutation_result> test(ndist*ndist);
+  std::vector<bootstrap_result> interval(ndist*ndist);
+  for(j=0;j<ndist;j++)
+    for(k=j+1;k<ndist;k++)
+      {
+	const double *a = values.points + values.run_start[j];
+	const double *b = values.points + values.run_start[k];
+	int n = values.run_start[j+1]-values.run_start[j];
+	int m = values.run_start[k+1]-values.run_start[k];
+	test[j*ndist+k] = engine.permutation(a, n, b, m, statistic, resamples, j*ndist+k);
+	interval[j*ndist+k] = engine.bootstrap(a, n, b, m, statistic, resamples, confidence, j*ndist+k);
+	if(VERBOSE)
+	  fprintf(stdout, "Samples %d and %d: difference = %g, p-values %g (upper) %g (lower)\n", j+1, k+1, test[j*ndist+k].difference, test[j*ndist+k].upper, test[j*ndist+k].lower);
+      }
+
+  if((fp=fopen(argv[3],"w")))
+    {
+      for(j=0;j<ndist;j++)
+	for(k=0;k<ndist;k++)
+	  {
+	    if(j==k)
+	      continue;
+	    double p_value = j<k ? test[j*ndist+k].upper : test[k*ndist+j].lower;
+	    fprintf(fp, "%d better than %d with a p-value of %g\n", k+1, j+1, p_value);
+	  }
+      for(j=0;j<ndist;j++)
+	for(k=j+1;k<ndist;k++)
+	  {
+	    const bootstrap_result &r = interval[j*ndist+k];
+	    fprintf(fp, "%d - %d: difference of the %ss %g with a %g%% bootstrap interval of [%g, %g]\n",
+		    j+1, k+1, str, r.difference, 100.0*confidence, r.lower, r.upper);
+	  }
+      fclose(fp);
+    }
+  else
+    {
+      fprintf(stderr,"Couldn't open %s for writing.\n", argv[3]);
+      exit(1);
+    }
+
+  if(ndist>2)
+    fprintf(stderr, "Warning: the p-values for accepting the null hypothesis that these are two samples from the same underlying distribution are not correct because multiple tests have been carried out using the same sample. Therefore, these values should only be used in preliminary (explorative) tests, and do not indicate true probabilities. Consider collecting new, independent random samples for each statistical test to be performed.\n");
+
+  trace_end(&span, NULL, argv[1], N);
+  free_point_file(&values);
+  return(0);
+}
@@ -0,0 +1,202 @@
+/* resample.cc
+
+Permutation tests and bootstrap intervals of permutation.cc, see resample.h.
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <thread>
+#include "resample.h"
+
+using namespace std;
+
+// differences closer than this, relative to the largest absolute value of
+// the samples, count as equal; the sums of the same values in another order
+// can differ in the last bits
+#define TIE_TOLERANCE 1e-9
+
+static inline unsigned long long mix(unsigned long long z)
+{
+  // the SplitMix64 output function
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+counter_rng::counter_rng(unsigned long long seed, unsigned long long stream, unsigned long long index)
+{
+  key = mix(mix(mix(seed) ^ stream) ^ index);
+  counter = 0;
+}
+
+unsigned long long counter_rng::next()
+{
+  return mix(key + ++counter * 0x9e3779b97f4a7c15ULL);
+}
+
+static double block_sum(const double *x, int n)
+{
+  // four independent partial sums, which the compiler keeps in vector
+  // registers; the summation order only depends on n
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  int i;
+
+  for (i = 0; i + 4 <= n; i += 4)
+    {
+      s0 += x[i];
+      s1 += x[i+1];
+      s2 += x[i+2];
+      s3 += x[i+3];
+    }
+  for (; i < n; i++)
+    s0 += x[i];
+  return (s0 + s1) + (s2 + s3);
+}
+
+static double median(double *x, int n)
+{
+  // reorders x
+  int h = n/2;
+  nth_element(x, x + h, x + n);
+  if (n % 2)
+    return x[h];
+  return (*max_element(x, x + h) + x[h])/2.0;
+}
+
+static double statistic(double *x, int n, resample_statistic s)
+{
+  if (s == RESAMPLE_MEAN)
+    return block_sum(x, n)/n;
+  return median(x, n);
+}
+
+static double quantile(vector<double> &x, double q)
+{
+  // linear interpolation between the order statistics (reorders x)
+  double h = q*(x.size() - 1);
+  size_t k = (size_t)floor(h);
+  nth_element(x.begin(), x.begin() + k, x.end());
+  if (k + 1 >= x.size())
+    return x[k];
+  double next = *min_element(x.begin() + k + 1, x.end());
+  return x[k] + (h - k)*(next - x[k]);
+}
+
+static double largest_abs(const double *a, int n, const double *b, int m)
+{
+  double v = 0.0;
+  for (int i = 0; i < n; i++)
+    v = max(v, fabs(a[i]));
+  for (int i = 0; i < m; i++)
+    v = max(v, fabs(b[i]));
+  return v;
+}
+
+resample_engine::resample_engine(int nthreads, unsigned long long seed)
+  : nthreads(nthreads), seed(seed)
+{
+  if (this->nthreads <= 0)
+    this->nthreads = max(1, (int)thread::hardware_concurrency());
+  work.resize(this->nthreads);
+}
+
+template <class F> void resample_engine::blocks(long resamples, F f)
+{
+  int t, T = (int)min<long>(nthreads, max(1L, resamples));
+  vector<thread> threads;
+
+  for (t = 1; t < T; t++)
+    threads.push_back(thread(f, t, resamples*t/T, resamples*(t+1)/T));
+  f(0, 0L, resamples/T);
+  for (t = 0; t < (int)threads.size(); t++)
+    threads[t].join();
+}
+
+permutation_result resample_engine::permutation(const double *a, int n, const double *b, int m,
+						 resample_statistic s, long resamples, int stream)
+{
+  int N = n + m;
+  vector<long> upper(nthreads, 0), lower(nthreads, 0);
+  permutation_result res;
+
+  for (int t = 0; t < nthreads; t++)
+    work[t].resize(2*N);
+  double *x = work[0].data();
+  memcpy(x, a, n*sizeof(double));
+  memcpy(x + n, b, m*sizeof(double));
+  res.difference = statistic(x, n, s) - statistic(x + n, m, s);
+  double tol = TIE_TOLERANCE*largest_abs(a, n, b, m);
+  double D = res.difference;
+
+  blocks(resamples, [&](int t, long begin, long end)
+	 {
+	   // the first N values of the buffer hold a and b, the others the
+	   // relabelled values of the current resample
+	   double *pooled = work[t].data(), *y = pooled + N;
+	   long up = 0, low = 0;
+
+	   memcpy(pooled, a, n*sizeof(double));
+	   memcpy(pooled + n, b, m*sizeof(double));
+	   for (long r = begin; r < end; r++)
+	     {
+	       counter_rng rng(seed, 2*(unsigned long long)stream, r);
+	       memcpy(y, pooled, N*sizeof(double));
+	       // the first n values of a partial Fisher-Yates shuffle are a
+	       // random subset of size n
+	       for (int i = 0; i < n; i++)
+		 swap(y[i], y[i + rng.below(N - i)]);
+	       double d = statistic(y, n, s) - statistic(y + n, m, s);
+	       up += d >= D - tol;
+	       low += d <= D + tol;
+	     }
+	   upper[t] = up;
+	   lower[t] = low;
+	 });
+
+  long up = 0, low = 0;
+  for (int t = 0; t < nthreads; t++)
+    {
+      up += upper[t];
+      low += lower[t];
+    }
+  res.upper = (1.0 + up)/(resamples + 1.0);
+  res.lower = (1.0 + low)/(resamples + 1.0);
+  return res;
+}
+
+bootstrap_result resample_engine::bootstrap(const double *a, int n, const double *b, int m,
+					     resample_statistic s, long resamples, double confidence,
+					     int stream)
+{
+  int N = n + m;
+  bootstrap_result res;
+
+  for (int t = 0; t < nthreads; t++)
+    work[t].resize(N);
+  double *x = work[0].data();
+  memcpy(x, a, n*sizeof(double));
+  memcpy(x + n, b, m*sizeof(double));
+  res.difference = statistic(x, n, s) - statistic(x + n, m, s);
+
+  boot.resize(resamples);
+  blocks(resamples, [&](int t, long begin, long end)
+	 {
+	   double *y = work[t].data();
+	   for (long r = begin; r < end; r++)
+	     {
+	       counter_rng rng(seed, 2*(unsigned long long)stream + 1, r);
+	       for (int i = 0; i < n; i++)
+		 y[i] = a[rng.below(n)];
+	       for (int i = 0; i < m; i++)
+		 y[n + i] = b[rng.below(m)];
+	       boot[r] = statistic(y, n, s) - statistic(y + n, m, s);
+	     }
+	 });
+
+  double alpha = 1.0 - confidence;
+  res.lower = quantile(boot, alpha/2.0);
+  res.upper = quantile(boot, 1.0 - alpha/2.0);
+  return res;
+}
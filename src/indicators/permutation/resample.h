@@ -0,0 +1,83 @@
+/* resample.h
+
+Permutation tests and bootstrap confidence intervals for the difference
+between the means (or medians) of two samples of indicator values, used by
+permutation.cc.
+
+The resamples are spread over several threads. Every random number comes
+from a counter-based generator: the k-th number drawn for resample b of
+stream s is a fixed function of (seed, s, b, k), so the resamples do not
+depend on which thread draws them and the results are the same for any
+number of threads. The statistics are evaluated on contiguous buffers that
+every thread allocates once, so resampling itself does not allocate.
+
+*/
+
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+#include <vector>
+
+enum resample_statistic { RESAMPLE_MEAN, RESAMPLE_MEDIAN };
+
+// the counter-based generator: the numbers of (seed, stream, index) are
+// SplitMix64 outputs of a counter that starts at a key derived from all
+// three, so any number of them can be drawn in any order
+class counter_rng
+{
+ public:
+  counter_rng(unsigned long long seed, unsigned long long stream, unsigned long long index);
+
+  unsigned long long next();
+  // a uniform integer in [0, n)
+  int below(int n) { return (int)(((next() >> 32) * (unsigned long long)n) >> 32); }
+
+ private:
+  unsigned long long key, counter;
+};
+
+struct permutation_result
+{
+  double difference;  // statistic(a) - statistic(b) of the samples themselves
+  double upper;       // p-value of a larger statistic of a: P(D >= difference)
+  double lower;       // p-value of a smaller statistic of a: P(D <= difference)
+};
+
+struct bootstrap_result
+{
+  double difference;  // statistic(a) - statistic(b) of the samples themselves
+  double lower, upper; // the percentile interval of the resampled differences
+};
+
+class resample_engine
+{
+ public:
+  // nthreads <= 0 uses one thread per hardware thread
+  resample_engine(int nthreads, unsigned long long seed);
+
+  int threads() const { return nthreads; }
+
+  // a permutation test of the n values in a against the m values in b with
+  // the given number of random relabellings; the p-values count the
+  // observed labelling, i.e. they are (1 + #{D' >= D}) / (resamples + 1)
+  permutation_result permutation(const double *a, int n, const double *b, int m,
+				 resample_statistic s, long resamples, int stream);
+
+  // a bootstrap percentile interval at the given confidence level of the
+  // difference between the statistics of a and b, both resampled with
+  // replacement
+  bootstrap_result bootstrap(const double *a, int n, const double *b, int m,
+			     resample_statistic s, long resamples, double confidence,
+			     int stream);
+
+ private:
+  int nthreads;
+  unsigned long long seed;
+  std::vector<std::vector<double> > work;  // work[t]: the buffer of thread t
+  std::vector<double> boot;                // the resampled differences
+
+  // runs f(t, begin, end) for thread t and its block of the resamples
+  template <class F> void blocks(long resamples, F f);
+};
+
+#endif
@@ -0,0 +1,227 @@
+/* signrank.cc
+
+Wilcoxon signed-rank test kernel shared by wilcoxon-sign and libsts.
+See wilcoxon-sign.cc (C) Joshua Knowles, 2005 for a description of the test,
+as described in W.J.Conover (1999) "Practical Nonparametric Statistics (3rd Edition)", Wiley.
+
+*/
+
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "exact.h"
+#include "pvalues.h"
+#include "signrank.h"
+
+static double myabs(double v)
+{
+  if(v>=0)
+    return v;
+  else
+    return -v;
+}
+
+static void rank_differences(const double *a, const double *b, int m, signed_diff *p,
+			     int *tiesp)
+{
+  int i;
+
+  // check for pairs that do not differ (ties) and remove them
+  int ties=0;
+  for( i=0;i<m; i++)
+    {
+      p[i].diff = b[i]-a[i];
+      if(p[i].diff==0)
+	{
+	  p[i].diff=10e99;
+	  ties++;
+	}
+    }
+  // assign_ranks() looks one value ahead of the last one
+  p[m].diff = 0.0;
+
+  // stable, as the qsort() of glibc used to be, so that the differences
+  // a - b are put in the same order as b - a
+  std::stable_sort(p, p+m, [](const signed_diff &x, const signed_diff &y) {
+      return comparediff(&x, &y) < 0;
+    });
+  int n=m-ties;
+
+  assign_ranks(p,n);
+
+  for(i=0;i<n;i++)
+    {
+      if(p[i].diff<0)
+	p[i].sigrank=-p[i].rank;
+      else
+	p[i].sigrank=p[i].rank;
+    }
+  *tiesp = ties;
+}
+
+static bool signed_rank_stats(const signed_diff *p, int m, int ties, double sign,
+			      signed_rank_result *res)
+  // the test of the ranked differences in p, times sign: with sign -1,
+  // that of a, b for the differences of b, a
+{
+  int i;
+  int n=m-ties;
+
+  res->n = n;
+  res->ties = ties;
+  res->sum_of_ranks = res->sum_of_sq_ranks = res->Tplus = 0.0;
+  if(n<4)
+    return false;
+
+  if((n>50)||(double(ties)/double(m)>0.5))
+    {
+      res->normal = true;
+      double sum_of_ranks=0.0;
+      double sum_of_sq_ranks=0.0;
+
+      for( i=0;i<n;i++)
+	{
+	  sum_of_ranks+=sign*p[i].sigrank;
+	  sum_of_sq_ranks+=pow(sign*p[i].sigrank,2.0);
+	}
+
+      double z[2], Z[2];
+      z[0] = (sum_of_ranks+1.0)/sqrt(sum_of_sq_ranks); // Equation 7, page 354 of Conover, 1999.
+      z[1] = (sum_of_ranks-1.0)/sqrt(sum_of_sq_ranks); // Equation 8, page 354 of Conover, 1999.
+      normal_tails(z, 2, Z, NULL);
+      res->sum_of_ranks = sum_of_ranks;
+      res->sum_of_sq_ranks = sum_of_sq_ranks;
+      res->lower_p = 1.0-Z[0];
+      res->upper_p = Z[1];
+    }
+  else
+    {
+      res->normal = false;
+      double Tplus=0.0;
+      for( i=0;i<n;i++)
+	{
+	  if(sign*p[i].diff>0)
+	    Tplus += sign*p[i].sigrank;  // Equation 3, page 353 of Conover (1999)
+	}
+
+      // P(T+ <= Tplus), and P(T+ >= Tplus) by the symmetry of T+ about n(n+1)/4
+      res->Tplus = Tplus;
+      res->upper_p = signed_rank_lower(n, Tplus);
+      res->lower_p = signed_rank_lower(n, n*(n+1)/2.0 - Tplus);
+    }
+
+  res->p_value = res->upper_p; // for a 1-tailed test
+  return true;
+}
+
+bool signed_rank_test(const double *a, const double *b, int m, signed_diff *p,
+		      signed_rank_result *res)
+{
+  int ties;
+
+  rank_differences(a, b, m, p, &ties);
+  return signed_rank_stats(p, m, ties, 1.0, res);
+}
+
+bool signed_rank_pairs(const double *values, int m, int ndist, int nthreads,
+		       std::vector<signed_rank_result> &res,
+		       std::vector<signed_diff> &diffs)
+{
+  int npairs = ndist*(ndist-1)/2;
+  std::vector<int> first(npairs), second(npairs);
+  std::vector<char> tested(npairs);
+
+  for(int a=0, k=0;a<ndist;a++)
+    for(int b=a+1;b<ndist;b++, k++)
+      {
+	first[k] = a;
+	second[k] = b;
+      }
+  res.assign((size_t)ndist*ndist, signed_rank_result());
+  diffs.resize((size_t)npairs*(m+1));
+  if(nthreads<=0)
+    nthreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+  std::atomic<int> next(0);
+  auto work = [&]() {
+    for(int k; (k = next++) < npairs; )
+      {
+	int a = first[k], b = second[k], ties;
+	signed_diff *p = &diffs[(size_t)k*(m+1)];
+	rank_differences(values + (size_t)a*m, values + (size_t)b*m, m, p, &ties);
+	// both directions have the same number of non-zero differences
+	tested[k] = signed_rank_stats(p, m, ties, 1.0, &res[a*ndist+b]);
+	signed_rank_stats(p, m, ties, -1.0, &res[b*ndist+a]);
+      }
+  };
+  std::vector<std::thread> t;
+  for(int k=1;k<std::min(nthreads, npairs);k++)
+    t.push_back(std::thread(work));
+  work();
+  for(size_t k=0;k<t.size();k++)
+    t[k].join();
+
+  for(int k=0;k<npairs;k++)
+    if(!tested[k])
+      return false;
+  return true;
+}
+
+int assign_ranks(signed_diff *p, int N)
+{
+  int i,j;
+  int crank=1;
+  int totalrank;
+  int count;
+  int total_ties=0;
+  signed_diff *ahead;
+
+  i=0;
+  while(i<N)
+    {
+      ahead = &(p[i+1]);
+      if(myabs(ahead->diff) == myabs(p[i].diff))
+	{
+	  totalrank=crank;
+	  count=0;
+	  do
+	    {
+	      ahead++;
+	      count++;
+	      totalrank+=(crank+count);
+	    }while((myabs(ahead->diff) == myabs(p[i].diff))&&(i+count<N-1));
+	  // set all the ranks to the average value
+	  for(j=0;j<=count;j++)
+	    p[i+j].rank = (double(totalrank)/double(count+1));
+	  i+=count+1;
+	  crank+=count+1;
+	  total_ties+=count;
+	}
+      else
+	{
+	  p[i].rank=crank;
+	  crank++;
+	  i++;
+	}
+    }
+  return(total_ties);
+
+}
+
+int comparediff(const void *i, const void *j)
+{
+  double x;
+  x = myabs((*(const signed_diff *)i).diff) - myabs((*(const signed_diff *)j).diff);
+
+  if(x<0)
+    return(-1);
+
+  else if (x>0)
+    return(1);
+
+  else
+    return(0);
+
+}
@@ -0,0 +1,75 @@
+/* signrank.h
+
+Wilcoxon signed-rank test kernel shared by wilcoxon-sign and libsts. The
+ranking and the statistics were split out of wilcoxon-sign.cc (C) Joshua
+Knowles, 2005; the samples are passed as arguments instead of being read
+from global variables, so one process may test any number of pairs.
+
+signed_rank_pairs() tests all pairs of a set of samples. The differences of
+a pair a, b are those of b, a negated, and the stable sort by absolute value
+puts both in the same order, so every pair is ranked once and both tests
+follow from the same ranked differences, which are kept for the caller.
+The pairs are spread over threads; the results do not depend on their
+number.
+
+*/
+
+#ifndef SIGNRANK_H
+#define SIGNRANK_H
+
+#include <vector>
+
+struct signed_diff
+{
+  double diff;     // signed difference
+  double rank;     // always positive
+  double sigrank;  // the signed rank
+};
+
+struct signed_rank_result
+{
+  int n;                   // the number of non-zero differences
+  int ties;                // the number of zero differences (left out)
+  bool normal;             // the normal approximation has been used
+  double sum_of_ranks;     // of the signed ranks, if normal
+  double sum_of_sq_ranks;  // if normal
+  double Tplus;            // the sum of the positive ranks, if not normal
+  double upper_p, lower_p;
+  double p_value;          // one-tailed, that b is better than a
+};
+
+// assigns ranks to the N differences in p by their absolute values, giving
+// the same (averaged) rank to any tied values; the differences must be
+// sorted by comparediff(); returns the number of ties
+int assign_ranks(signed_diff *p, int N);
+int comparediff(const void *, const void *);
+
+// tests the m matched values of a and b; p receives the differences b - a
+// in the order of their ranks (the first res->n of them, followed by the
+// zero differences) and must have room for m+1 values. Returns false,
+// leaving res->n set, if fewer than 4 differences are not zero. The normal
+// approximation is used if there are more than 50 non-zero differences or
+// more than half of the differences are zero, the exact distribution
+// (exact.h) otherwise.
+bool signed_rank_test(const double *a, const double *b, int m, signed_diff *p,
+		      signed_rank_result *res);
+
+// the index of the pair a < b among the ndist*(ndist-1)/2 pairs of ndist
+// samples, in the order (0,1), (0,2), ..., (1,2), ...
+inline int signed_rank_pair(int a, int b, int ndist)
+{
+  return a*(2*ndist-a-1)/2 + b-a-1;
+}
+
+// tests every ordered pair of the ndist samples of m matched values, sample
+// s being values[s*m..s*m+m-1]: res[a*ndist+b] receives the result of
+// signed_rank_test(sample a, sample b), the diagonal is left zeroed, and
+// diffs[signed_rank_pair(a, b, ndist)*(m+1)] the m+1 differences p of the
+// pair a < b. The pairs are spread over nthreads threads (<= 0: one per
+// hardware thread). Returns false if some pair has fewer than 4 non-zero
+// differences.
+bool signed_rank_pairs(const double *values, int m, int ndist, int nthreads,
+		       std::vector<signed_rank_result> &res,
+		       std::vector<signed_diff> &diffs);
+
+#endif
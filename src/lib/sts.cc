@@ -0,0 +1,350 @@
+/* sts.cc
+
+libsts, see sts.h. The functions check the input the tools check before
+they call the kernels, which would otherwise end the process, and convert
+the senses to the conventions of the kernels.
+
+*/
+
+#include <vector>
+#include "hv.h"
+#include "archive.h"
+#include "contrib.h"
+#include "eps.h"
+#include "igd.h"
+#include "nondominated.h"
+#include "scale.h"
+#include "ranks.h"
+#include "kruskal.h"
+#include "mwu.h"
+#include "signrank.h"
+#include "pvalues.h"
+#include "sts.h"
+
+using namespace std;
+
+namespace sts
+{
+
+// obj[k] = 0 if objective k is minimized and 1 if it is maximized, the
+// convention of hv.h, eps.h and igd.h
+static vector<int> objectives(const int *senses, int dim)
+{
+  vector<int> obj(dim);
+  for (int k = 0; k < dim; k++)
+    obj[k] = senses[k] > 0 ? 1 : 0;
+  return obj;
+}
+
+static bool within(const double *points, int n, int dim, const int *obj,
+		   const double *ref)
+  // the test of hv_ind_value()
+{
+  for (int i = 0; i < n; i++)
+    for (int k = 0; k < dim; k++)
+      {
+	double t = obj[k] == 0 ? ref[k] - points[i*dim+k] : points[i*dim+k] - ref[k];
+	if (t < 0)
+	  return false;
+      }
+  return true;
+}
+
+static bool same_signs(const double *a, int size_a, const double *b, int size_b,
+		       int dim)
+  // the test of check_signs() in eps.cc
+{
+  for (int k = 0; k < dim; k++)
+    {
+      bool positive = a[k] > 0;
+      for (int i = 0; i < size_a; i++)
+	if (a[i*dim+k] == 0 || (a[i*dim+k] > 0) != positive)
+	  return false;
+      for (int i = 0; i < size_b; i++)
+	if (b[i*dim+k] == 0 || (b[i*dim+k] > 0) != positive)
+	  return false;
+    }
+  return true;
+}
+
+template <int D>
+bool hypervolume(const double *points, int n, const int *senses,
+		 const double *ref, double *value)
+{
+  vector<int> obj = objectives(senses, D);
+  if (!within(points, n, D, obj.data(), ref))
+    return false;
+  vector<double> a(points, points + (size_t)n*D);
+  *value = hv_value<D>(a.data(), n, obj.data(), ref);
+  return true;
+}
+
+template bool hypervolume<2>(const double *points, int n, const int *senses,
+			     const double *ref, double *value);
+template bool hypervolume<3>(const double *points, int n, const int *senses,
+			     const double *ref, double *value);
+
+bool hypervolume(const double *points, int n, int dim, const int *senses,
+		 const double *ref, double *value)
+{
+  if (dim == 2)
+    return hypervolume<2>(points, n, senses, ref, value);
+  if (dim == 3)
+    return hypervolume<3>(points, n, senses, ref, value);
+  vector<int> obj = objectives(senses, dim);
+  if (!within(points, n, dim, obj.data(), ref))
+    return false;
+  vector<double> a(points, points + (size_t)n*dim);
+  *value = hv_ind_value(a.data(), n, dim, obj.data(), ref);
+  return true;
+}
+
+template <int D>
+bool epsilon(const double *a, int size_a, const double *b, int size_b,
+	     const int *senses, bool multiplicative, double *value)
+{
+  if (multiplicative && size_a > 0 && size_b > 0
+      && !same_signs(a, size_a, b, size_b, D))
+    return false;
+  vector<int> obj = objectives(senses, D);
+  *value = eps_value<D>((double *)a, size_a, (double *)b, size_b, obj.data(),
+			multiplicative ? 1 : 0);
+  return true;
+}
+
+template bool epsilon<2>(const double *a, int size_a, const double *b, int size_b,
+			 const int *senses, bool multiplicative, double *value);
+template bool epsilon<3>(const double *a, int size_a, const double *b, int size_b,
+			 const int *senses, bool multiplicative, double *value);
+
+bool epsilon(const double *a, int size_a, const double *b, int size_b,
+	     int dim, const int *senses, bool multiplicative, double *value)
+{
+  if (dim == 2)
+    return epsilon<2>(a, size_a, b, size_b, senses, multiplicative, value);
+  if (dim == 3)
+    return epsilon<3>(a, size_a, b, size_b, senses, multiplicative, value);
+  if (multiplicative && size_a > 0 && size_b > 0
+      && !same_signs(a, size_a, b, size_b, dim))
+    return false;
+  vector<int> obj = objectives(senses, dim);
+  // eps_ind_value() does not modify the sets
+  *value = eps_ind_value((double *)a, size_a, (double *)b, size_b, dim,
+			 obj.data(), multiplicative ? 1 : 0);
+  return true;
+}
+
+bool contributions(const double *points, int n, int dim, const int *senses,
+		   const double *ref, double *contrib)
+{
+  vector<int> obj = objectives(senses, dim);
+  if (!within(points, n, dim, obj.data(), ref))
+    return false;
+  hv_contributions(points, n, dim, obj.data(), ref, contrib);
+  return true;
+}
+
+bool reduce(const double *points, int n, int dim, const int *senses,
+	    const double *ref, int size, bool *keep, int *left)
+{
+  vector<int> obj = objectives(senses, dim);
+  if (!within(points, n, dim, obj.data(), ref))
+    return false;
+  vector<int> k(n);
+  *left = hv_reduce(points, n, dim, obj.data(), ref, size, k.data());
+  for (int i = 0; i < n; i++)
+    keep[i] = k[i] != 0;
+  return true;
+}
+
+front_archive::front_archive(int dim, const int *senses, const double *ref)
+  : a2(NULL), a3(NULL)
+{
+  if (dim != 2 && dim != 3)
+    return;
+  vector<int> obj = objectives(senses, dim);
+  if (dim == 2)
+    a2 = new hv_archive<2>(obj.data(), ref);
+  else
+    a3 = new hv_archive<3>(obj.data(), ref);
+}
+
+front_archive::~front_archive()
+{
+  delete a2;
+  delete a3;
+}
+
+bool front_archive::valid() const
+{
+  return a2 != NULL || a3 != NULL;
+}
+
+bool front_archive::insert(const double *point)
+{
+  if (!valid())
+    return false;
+  return a2 != NULL ? a2->insert(point) : a3->insert(point);
+}
+
+double front_archive::hypervolume() const
+{
+  if (!valid())
+    return 0.0;
+  return a2 != NULL ? a2->hypervolume() : a3->hypervolume();
+}
+
+size_t front_archive::size() const
+{
+  if (!valid())
+    return 0;
+  return a2 != NULL ? a2->size() : a3->size();
+}
+
+void front_archive::points(vector<double> &out) const
+{
+  if (a2 != NULL)
+    a2->points(out);
+  else if (a3 != NULL)
+    a3->points(out);
+  else
+    out.clear();
+}
+
+double igd(const double *ref, int size_ref, const double *a, int size_a,
+	   int dim)
+{
+  return igd_value(ref, size_ref, a, size_a, dim);
+}
+
+double igd_plus(const double *ref, int size_ref, const double *a, int size_a,
+		int dim, const int *senses)
+{
+  vector<int> obj = objectives(senses, dim);
+  return igd_plus_value(ref, size_ref, a, size_a, dim, obj.data());
+}
+
+void nondominated(const double *points, int n, int dim, const int *senses,
+		  bool *dominated)
+{
+  vector<const double *> o(n);
+  for (int i = 0; i < n; i++)
+    o[i] = points + (size_t)i*dim;
+  filter_nondominated(o.data(), n, dim, senses, dominated);
+}
+
+bool bounds(const double *points, size_t n, int dim, const int *senses,
+	    double *lower, double *upper)
+{
+  // the reduction of bound.cc: best and worst start at the first point and
+  // only move on strict comparisons
+  if (n == 0)
+    return false;
+  vector<double> best(points, points + dim), worst(points, points + dim);
+  for (size_t i = 1; i < n; i++)
+    {
+      const double *d = points + i*dim;
+      for (int k = 0; k < dim; k++)
+	{
+	  if (d[k]*senses[k] > best[k]*senses[k])
+	    best[k] = d[k];
+	  if (d[k]*senses[k] < worst[k]*senses[k])
+	    worst[k] = d[k];
+	}
+    }
+  for (int k = 0; k < dim; k++)
+    {
+      lower[k] = senses[k] == -1 ? best[k] : worst[k];
+      upper[k] = senses[k] == -1 ? worst[k] : best[k];
+    }
+  return true;
+}
+
+void normalize(const double *points, double *out, size_t n, int dim,
+	       const int *senses, unify_mode unify, const double *lower,
+	       const double *upper, int *out_senses)
+{
+  static const char *modes[] = { "no", "min", "max" };
+  scale_map m;
+
+  scale_setup(&m, dim, senses, modes[unify], lower, upper);
+  scale_points(m, points, out, n);
+  if (out_senses != NULL)
+    for (int k = 0; k < dim; k++)
+      out_senses[k] = m.senses[k];
+}
+
+static int samples(const double *values, const int *sizes, int nsamples,
+		   vector<D> &d)
+  // the labelled values of the rank tests; returns their number
+{
+  d.clear();
+  for (int a = 0; a < nsamples; a++)
+    for (int i = 0; i < sizes[a]; i++)
+      {
+	D v;
+	v.value = values[d.size()];
+	v.label = a;
+	v.rank = 0;
+	d.push_back(v);
+      }
+  return (int)d.size();
+}
+
+bool kruskal_wallis(const double *values, const int *sizes, int nsamples,
+		    kruskal_result *res)
+{
+  vector<D> d;
+  int N = samples(values, sizes, nsamples, d);
+  if (nsamples < 2 || N <= nsamples)
+    return false;
+
+  rank_engine r;
+  r.rank(d.data(), N, nsamples, false);
+  res->T = Tvalue(r);
+  chi_tails(&res->T, 1, nsamples-1, NULL, &res->p_value);
+  res->pairs.resize((size_t)nsamples*nsamples);
+  kruskal_pairs(r, res->T, res->pairs.data());
+  return true;
+}
+
+bool mann_whitney(const double *values, const int *sizes, int nsamples,
+		  vector<double> &p_value)
+{
+  vector<D> d;
+  int N = samples(values, sizes, nsamples, d);
+  if (nsamples < 2)
+    return false;
+  for (int a = 0; a < nsamples; a++)
+    if (sizes[a] < 1)
+      return false;
+
+  rank_engine r;
+  r.rank(d.data(), N, nsamples, true);
+  vector<mwu_pair> pairs;
+  mann_whitney_pairs(r, pairs);
+  p_value.resize(pairs.size());
+  for (size_t i = 0; i < pairs.size(); i++)
+    p_value[i] = pairs[i].p_value;
+  return true;
+}
+
+bool wilcoxon(const double *values, int size, int nsamples,
+	      vector<double> &p_value)
+{
+  if (nsamples < 2)
+    return false;
+  // every pair is ranked once, in the calling thread
+  vector<signed_rank_result> res;
+  vector<signed_diff> diffs;
+  if (!signed_rank_pairs(values, size, nsamples, 1, res, diffs))
+    return false;
+  p_value.assign((size_t)nsamples*nsamples, 0.0);
+  for (int a = 0; a < nsamples; a++)
+    for (int b = 0; b < nsamples; b++)
+      if (a != b)
+	p_value[a*nsamples+b] = res[a*nsamples+b].p_value;
+  return true;
+}
+
+}
@@ -0,0 +1,150 @@
+/* sts.h
+
+libsts: the kernels of the suite as a library, for programs that compute
+the indicators and run the tests in memory instead of through the tools
+and their files. 'make lib' (run in src/) builds lib/libsts.a and
+lib/libsts.so; a program includes this header and links either of them.
+
+All points are stored row-major, i.e. objective k of point i is found at
+points[i*dim + k], and the objective senses are given as in the parameter
+files of bound and filter: senses[k] = -1 if objective k is minimized and
+1 if it is maximized. The functions keep no state between calls and do not
+read or write any file, so they may be called from several threads at once
+(the t and chi-square distributions of dcdflib are evaluated under a lock,
+see pvalues.h). Invalid input is reported by returning false; the computed
+values are the ones of the tools, bit for bit.
+
+The hypervolume and epsilon indicators are also given as templates on the
+number of objectives, instantiated for 2 and 3, whose loops over the
+objectives are unrolled; the versions with a run-time dim call them for
+2 and 3 objectives.
+
+*/
+
+#ifndef STS_H
+#define STS_H
+
+#include <cstddef>
+#include <vector>
+
+template <int D> class hv_archive;
+
+namespace sts
+{
+
+// the unification of the objective senses by normalize (normalize_param.txt)
+enum unify_mode { UNIFY_NO, UNIFY_MIN, UNIFY_MAX };
+
+// the hypervolume of the n points with respect to the reference point ref
+// (the value of hyp_ind); returns false if a point is worse than ref in
+// some objective
+template <int D>
+bool hypervolume(const double *points, int n, const int *senses,
+		 const double *ref, double *value);
+bool hypervolume(const double *points, int n, int dim, const int *senses,
+		 const double *ref, double *value);
+
+// the additive or multiplicative epsilon value needed to make b weakly
+// dominate every point of a (eps_ind, a being the reference set); returns
+// false if multiplicative is set and the values of an objective are zero
+// or differ in sign
+template <int D>
+bool epsilon(const double *a, int size_a, const double *b, int size_b,
+	     const int *senses, bool multiplicative, double *value);
+bool epsilon(const double *a, int size_a, const double *b, int size_b,
+	     int dim, const int *senses, bool multiplicative, double *value);
+
+// contrib[i] = the hypervolume the n points lose without point i
+// (hyp_ind --contributions, see contrib.h); returns false if a point is
+// worse than ref in some objective
+bool contributions(const double *points, int n, int dim, const int *senses,
+		   const double *ref, double *contrib);
+
+// removes the point of least contribution as long as more than size points
+// are left (hyp_ind --reduce); keep[i] = true for the points left, whose
+// number is returned in *left; returns false as contributions() does
+bool reduce(const double *points, int n, int dim, const int *senses,
+	    const double *ref, int size, bool *keep, int *left);
+
+// an archive of the nondominated points among those inserted, 2 or 3
+// objectives, that keeps their hypervolume with respect to ref up to date
+// (archive.h); insert() returns true if the point enters the archive. For
+// any other dim no archive is built: valid() is false, insert() returns
+// false and the archive stays empty
+class front_archive
+{
+ public:
+  front_archive(int dim, const int *senses, const double *ref);
+  ~front_archive();
+  front_archive(const front_archive &) = delete;
+  front_archive &operator=(const front_archive &) = delete;
+
+  bool valid() const;
+  bool insert(const double *point);
+  double hypervolume() const;
+  std::size_t size() const;
+  void points(std::vector<double> &out) const;  // row-major
+
+ private:
+  hv_archive<2> *a2;  // the one for dim
+  hv_archive<3> *a3;
+};
+
+// the IGD and IGD+ of the size_a points in a with respect to the size_ref
+// points in ref (igd, see igd.h)
+double igd(const double *ref, int size_ref, const double *a, int size_a,
+	   int dim);
+double igd_plus(const double *ref, int size_ref, const double *a, int size_a,
+		int dim, const int *senses);
+
+// dominated[i] = true if filter removes point i, i.e. if it is dominated
+// by or identical to another point; objectives with senses[k] = 0 are
+// ignored
+void nondominated(const double *points, int n, int dim, const int *senses,
+		  bool *dominated);
+
+// the lower and upper bounds bound writes for the n points, i.e. the
+// minimum and maximum of every objective; returns false if n is 0
+bool bounds(const double *points, std::size_t n, int dim, const int *senses,
+	    double *lower, double *upper);
+
+// normalizes the n points to out (which may be points) with the bounds
+// lower and upper, as normalize does; out_senses, if not NULL, receives the
+// senses of the objectives after unification
+void normalize(const double *points, double *out, std::size_t n, int dim,
+	       const int *senses, unify_mode unify, const double *lower,
+	       const double *upper, int *out_senses);
+
+// In the rank tests below, values holds the samples one after another,
+// sample a having sizes[a] values (or size values each for the paired
+// test); p_value[a*nsamples + b] is the one-tailed p-value of sample b
+// being better than sample a, as in the lines "b+1 better than a+1 with a
+// p-value of ..." of the tools, and 0 for a = b.
+
+struct kruskal_result
+{
+  double T;                      // the corrected T value
+  double p_value;                // of all distribution functions being equal
+  std::vector<double> pairs;     // the pair-wise p-values
+};
+
+// the Kruskal-Wallis test (kruskal-wallis); the pair-wise p-values are
+// computed whatever the overall p-value; returns false for fewer than 2
+// samples or fewer values than samples + 1
+bool kruskal_wallis(const double *values, const int *sizes, int nsamples,
+		    kruskal_result *res);
+
+// the Mann-Whitney test of every pair (mann-whit); returns false for fewer
+// than 2 samples or an empty sample
+bool mann_whitney(const double *values, const int *sizes, int nsamples,
+		  std::vector<double> &p_value);
+
+// the Wilcoxon signed-rank test of every pair of matched samples
+// (wilcoxon-sign); returns false for fewer than 2 samples or if a pair has
+// fewer than 4 differences that are not zero
+bool wilcoxon(const double *values, int size, int nsamples,
+	      std::vector<double> &p_value);
+
+}
+
+#endif
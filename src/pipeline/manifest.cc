@@ -0,0 +1,130 @@
+/* manifest.cc
+
+Content hashes and the per-instance manifest of sts-pipeline, see
+manifest.h.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "manifest.h"
+
+using namespace std;
+
+static const digest prime = 0xff51afd7ed558ccdULL;
+
+void hasher::mix(digest w)
+{
+  h ^= w;
+  h *= prime;
+  h ^= h >> 32;
+}
+
+void hasher::update(const void *data, size_t n)
+{
+  const unsigned char *p = (const unsigned char *)data;
+  digest w;
+
+  nbytes += n;
+  while (nbuf > 0 && nbuf < 8 && n > 0)
+    {
+      buf[nbuf++] = *p++;
+      n--;
+    }
+  if (nbuf == 8)
+    {
+      memcpy(&w, buf, 8);
+      mix(w);
+      nbuf = 0;
+    }
+  for (; n >= 8; n -= 8, p += 8)
+    {
+      memcpy(&w, p, 8);
+      mix(w);
+    }
+  memcpy(buf, p, n);
+  nbuf += (int)n;
+}
+
+bool hasher::update_file(const string &path)
+{
+  static const size_t chunk = 1 << 20;
+  FILE *fp = fopen(path.c_str(), "rb");
+  if (fp == NULL)
+    return false;
+  char *data = new char[chunk];
+  size_t n;
+  while ((n = fread(data, 1, chunk, fp)) > 0)
+    update(data, n);
+  delete [] data;
+  bool ok = !ferror(fp);
+  fclose(fp);
+  return ok;
+}
+
+digest hasher::value() const
+{
+  // the pending bytes and the length, then a final avalanche
+  digest w = 0, v;
+  hasher t(*this);
+  memcpy(&w, buf, nbuf);
+  t.mix(w);
+  t.mix(nbytes);
+  v = t.h;
+  v ^= v >> 33;
+  v *= 0xc4ceb9fe1a85ec53ULL;
+  v ^= v >> 33;
+  return v;
+}
+
+digest file_digest(const string &path)
+{
+  hasher h;
+  if (!h.update_file(path))
+    return 0;
+  return h.value();
+}
+
+void manifest::load(const string &path)
+{
+  char stage[256];
+  entry e;
+  FILE *fp = fopen(path.c_str(), "rb");
+
+  stages.clear();
+  if (fp == NULL)
+    return;
+  while (fscanf(fp, "%255s %llx %llx", stage, &e.in, &e.out) == 3)
+    stages[stage] = e;
+  fclose(fp);
+}
+
+bool manifest::save(const string &path) const
+{
+  string tmp = path + ".tmp";
+  FILE *fp = fopen(tmp.c_str(), "wb");
+  if (fp == NULL)
+    return false;
+  for (map<string, entry>::const_iterator i = stages.begin(); i != stages.end(); ++i)
+    fprintf(fp, "%s %016llx %016llx\n", i->first.c_str(), i->second.in, i->second.out);
+  if (fclose(fp) != 0)
+    return false;
+  return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool manifest::unchanged(const string &stage, digest in, digest out) const
+{
+  map<string, entry>::const_iterator i = stages.find(stage);
+  return i != stages.end() && i->second.in == in && i->second.out == out;
+}
+
+void manifest::set(const string &stage, digest in, digest out)
+{
+  entry e = {in, out};
+  stages[stage] = e;
+}
+
+void manifest::erase(const string &stage)
+{
+  stages.erase(stage);
+}
@@ -0,0 +1,79 @@
+/* manifest.h
+
+Content hashes for the incremental re-analysis of sts-pipeline.
+
+For every instance, analysis/<instance>/manifest.txt holds one line
+
+   <stage> <input digest> <output digest>
+
+per stage of the analysis. The input digest is computed from the contents
+of everything the stage depends on (the input fronts, the parameter files,
+the outputs of the stages it reads and the sts-pipeline executable), the
+output digest from the contents of the files the stage has written. A
+stage whose input digest is the same as in the manifest and whose output
+files still have the recorded digest is not run again; its outputs are
+read back instead. Since a stage's input digest contains the output digest
+of the stages it reads, a new bound or reference set invalidates exactly
+the stages below it, and a stage whose inputs were recomputed but came out
+the same is still skipped.
+
+The digests are 64-bit hashes of the bytes; they detect changes, they are
+not meant to resist deliberate collisions.
+
+*/
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <map>
+#include <string>
+
+typedef unsigned long long digest;
+
+class hasher
+{
+ public:
+  hasher() : h(0x9e3779b97f4a7c15ULL), nbytes(0), nbuf(0) {}
+
+  void update(const void *data, size_t n);
+  void update(const std::string &s) { update(s.data(), s.size()); update("", 1); }
+  void update(digest d) { update(&d, sizeof(d)); }
+  // adds the contents of the file path; returns false if it cannot be read
+  bool update_file(const std::string &path);
+  digest value() const;
+
+ private:
+  digest h;
+  digest nbytes;
+  unsigned char buf[8];
+  int nbuf;
+
+  void mix(digest w);
+};
+
+// the digest of the contents of path, or 0 if it cannot be read
+digest file_digest(const std::string &path);
+
+class manifest
+{
+ public:
+  // reads path; a missing or malformed manifest is an empty one
+  void load(const std::string &path);
+  // writes the manifest to path (through a temporary file, so that an
+  // interrupted run leaves the old manifest); returns false on failure
+  bool save(const std::string &path) const;
+
+  // true if stage was recorded with input digest in and output digest out
+  bool unchanged(const std::string &stage, digest in, digest out) const;
+  void set(const std::string &stage, digest in, digest out);
+  void erase(const std::string &stage);
+
+ private:
+  struct entry
+  {
+    digest in, out;
+  };
+  std::map<std::string, entry> stages;
+};
+
+#endif
@@ -0,0 +1,144 @@
+/* pool.cc
+
+Work-stealing thread pool for sts-pipeline, see pool.h.
+
+*/
+
+#include <chrono>
+#include "pool.h"
+
+using namespace std;
+
+// index of the deque owned by the current thread; threads that do not
+// belong to the pool use the deque of the thread that created it
+static thread_local int self_index = 0;
+
+pool::pool(int nthreads)
+  : queued(0), stop(false)
+{
+  if (nthreads < 1)
+    nthreads = 1;
+  for (int i = 0; i < nthreads; i++)
+    queues.push_back(new queue);
+  for (int i = 1; i < nthreads; i++)
+    threads.push_back(thread(&pool::worker, this, i));
+}
+
+pool::~pool()
+{
+  {
+    lock_guard<mutex> lk(sleep_m);
+    stop = true;
+  }
+  sleep_cv.notify_all();
+  for (size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+  for (size_t i = 0; i < queues.size(); i++)
+    delete queues[i];
+}
+
+bool pool::pop(int self, task &t)
+{
+  // newest task of the own deque first ...
+  {
+    queue *q = queues[self];
+    lock_guard<mutex> lk(q->m);
+    if (!q->q.empty())
+      {
+	t = q->q.back();
+	q->q.pop_back();
+	queued--;
+	return true;
+      }
+  }
+  // ... otherwise the oldest task of another thread
+  int n = size();
+  for (int k = 1; k < n; k++)
+    {
+      queue *q = queues[(self+k)%n];
+      lock_guard<mutex> lk(q->m);
+      if (!q->q.empty())
+	{
+	  t = q->q.front();
+	  q->q.pop_front();
+	  queued--;
+	  return true;
+	}
+    }
+  return false;
+}
+
+void pool::run(task &t)
+{
+  (*t.f)(t.i);
+  if (--t.g->pending == 0)
+    {
+      lock_guard<mutex> lk(sleep_m);
+      sleep_cv.notify_all();
+    }
+}
+
+void pool::idle(const group *g)
+{
+  // sleeps until new tasks are queued, the group g is complete or the pool
+  // is shut down; the timeout only guards against missed wake-ups
+  unique_lock<mutex> lk(sleep_m);
+  sleep_cv.wait_for(lk, chrono::milliseconds(10), [&] {
+      return stop || queued > 0 || (g != NULL && g->pending == 0);
+    });
+}
+
+void pool::worker(int self)
+{
+  task t;
+
+  self_index = self;
+  while (!stop)
+    {
+      if (pop(self, t))
+	run(t);
+      else
+	idle(NULL);
+    }
+}
+
+void pool::parallel_for(int n, const function<void(int)> &f)
+{
+  if (n <= 0)
+    return;
+  if (size() == 1 || n == 1)
+    {
+      for (int i = 0; i < n; i++)
+	f(i);
+      return;
+    }
+
+  int self = self_index;
+  group g;
+  g.pending = n;
+  {
+    // pushed in reverse, so that the own thread starts with f(0) and
+    // thieves take the tasks from the end of the range
+    queue *q = queues[self];
+    lock_guard<mutex> lk(q->m);
+    for (int i = n-1; i >= 0; i--)
+      {
+	task t = {&f, i, &g};
+	q->q.push_back(t);
+	queued++;
+      }
+  }
+  {
+    lock_guard<mutex> lk(sleep_m);
+    sleep_cv.notify_all();
+  }
+
+  task t;
+  while (g.pending > 0)
+    {
+      if (pop(self, t))
+	run(t);
+      else
+	idle(&g);
+    }
+}
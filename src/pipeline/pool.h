@@ -0,0 +1,71 @@
+/* pool.h
+
+A small work-stealing thread pool for sts-pipeline.
+
+Every thread of the pool owns a deque of tasks. A thread pushes the tasks it
+spawns to the back of its own deque and takes work from there; a thread
+without work steals from the front of the other deques. A thread that waits
+for the tasks it spawned keeps executing tasks in the meantime, so nested
+parallel_for() calls (instances, then the runs of an instance) cannot
+dead-lock, and the runs of one very large instance are spread over all
+threads that have finished their own instances.
+
+*/
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class pool
+{
+ public:
+  // nthreads counts the calling thread, i.e. nthreads-1 workers are started
+  explicit pool(int nthreads);
+  ~pool();
+
+  int size() const { return (int)queues.size(); }
+
+  // calls f(0), ..., f(n-1) and returns when all calls have finished; with
+  // a single thread the calls are made in order by the calling thread
+  void parallel_for(int n, const std::function<void(int)> &f);
+
+ private:
+  struct group
+  {
+    std::atomic<int> pending;
+  };
+
+  struct task
+  {
+    const std::function<void(int)> *f;
+    int i;
+    group *g;
+  };
+
+  struct queue
+  {
+    std::mutex m;
+    std::deque<task> q;
+  };
+
+  std::vector<queue *> queues;  // queues[0] belongs to the thread that created the pool
+  std::vector<std::thread> threads;
+  std::mutex sleep_m;
+  std::condition_variable sleep_cv;
+  std::atomic<int> queued;
+  std::atomic<bool> stop;
+
+  bool pop(int self, task &t);
+  void run(task &t);
+  void worker(int self);
+  void idle(const group *g);
+};
+
+#endif
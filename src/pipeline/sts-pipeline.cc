@@ -0,0 +1,2228 @@
+/* sts-pipeline.cc
+
+A program that runs the complete analysis chain of run_analysis.sh
+
+   bound -> normalize -> filter -> hypervolume / epsilon / IGD -> Kruskal-Wallis
+
+for one or more instances inside a single process. The fronts are parsed
+once and then kept in memory between the stages; only the final artifacts
+are written. The numbers are the same as the ones produced by the chain of
+separate tools: wherever a tool reads back a file written by the previous
+tool, the values are passed through the same "%.9e" text representation.
+
+   COMPILE:
+      make bin/sts-pipeline
+
+   RUN:
+      ./sts-pipeline [--jobs <n>] [--algorithms <file>] [--force]
+        [--keep-intermediate] [--curves | --cumulative-curves]
+        <root_dir> <instance> [<instance> ...]
+      ./sts-pipeline [--jobs <n>] [--algorithms <file>] --spec <file>
+        (--shard <id> | --merge) (fronts | indicators) <root_dir>
+
+   where <root_dir> is the project root (the parent of src/) and <n> is the
+   number of threads (default 1). The instances, and within an instance the
+   runs of all algorithms, are distributed over the threads by a
+   work-stealing pool (pool.cc).
+
+   The algorithms to compare, and where their runs are found, are listed in
+   the algorithm file (default: <root_dir>/src/algorithms.txt, see
+   read_algorithms()); the file that comes with the suite lists MOEAD,
+   COMOLSD and NSGA2 with the run files
+
+      <root_dir>/algorithm_results/<ALG>/<instance>/<run>/<instance>_<alg>_1000000.txt
+
+   as run_analysis.sh names them. The runs of an algorithm are the files
+   matching its glob, in natural order (run 10 after run 9), and are read
+   straight from there, one set per file (the union files of the legacy
+   chain are not needed). Any number of algorithms and runs can be given;
+   the Kruskal-Wallis test compares all pairs of algorithms at once. With
+   --keep-intermediate, the files the legacy chain passes between the tools
+   are written as well:
+
+      <root_dir>/pareto_union/<dir>/<instance>_union_pareto_file.out
+      <root_dir>/analysis/<instance>/utils/<name>_normalizado.out
+
+   With --force, the manifests (see manifest.h) are ignored and every stage
+   is run. With --curves, the indicators are also computed for every
+   checkpoint file of every run (see curve_stage()); --cumulative-curves
+   instead follows the best-so-far front of the checkpoints of a run
+   (curve_front). The parameters are taken from the same files
+   run_analysis.sh passes to the tools (src/utils/bound/bound_param.txt,
+   ..., src/indicators/kruskal/kruskalparam.txt).
+
+   The output of sts-pipeline, below <root_dir>/analysis/<instance>/, is
+
+      utils/bound.out
+      reference_set.out
+      hypervolume/HV_<name>.out
+      epsilon_additive/esp_ad_<name>.out
+      igd/IGD_<name>.out
+      kruskal/{hv,eps,igd}_saidakruskal.out
+      indicators.out
+
+   in the formats of bound, filter, hyp_ind, eps_ind, igd, kruskal-wallis
+   and ind_batch; indicators.out holds the values of all three indicators
+   for every run of every algorithm in one table. With --curves (or
+   --cumulative-curves) there is also
+
+      curves/curve_<name>.out
+
+   with one line "run checkpoint hv eps igd" per checkpoint of every run of
+   the algorithm; without --cumulative-curves, the line of the last
+   checkpoint of a run holds the values of HV_, esp_ad_ and IGD_. The
+   detailed Kruskal-Wallis output is appended to
+   <root_dir>/logs/log_{hv,eps,igd}_kruskal.txt, one block per instance and
+   in the order of the command line, whatever the number of threads.
+
+   Finally, the comparative table of the instances of the command line, in
+   that order, is written from the values in memory (see table.h) to
+
+      <root_dir>/comparative_results.csv
+      <root_dir>/comparative_results.bin
+
+   with the columns of build_comparative_table.py, which is then only
+   needed for the legacy chain; the files of the tools above are no longer
+   read to make it.
+
+   With --spec, the campaign is split into shards by a job spec and run
+   in four steps that may take place on different hosts (see "Sharded
+   execution" below): every shard writes partial results below
+   <root_dir>/shards/, which --merge turns into the files above, the same
+   as on a single host. Manifests and --curves are not used there.
+
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pool.h"
+#include "manifest.h"
+#include "pointset.h"
+#include "nondominated.h"
+#include "scale.h"
+#include "hv.h"
+#include "archive.h"
+#include "eps.h"
+#include "igd.h"
+#include "kruskal.h"
+#include "pvalues.h"
+#include "table.h"
+#include "trace.h"
+
+using namespace std;
+
+#define MAX_LINE_LENGTH 1024
+#define MAX_STR_LENGTH 256
+#define VERBOSE true
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+// The algorithms to compare, as listed in the algorithm file (see
+// read_algorithms()), in the order in which their results are concatenated
+// (this order decides the sample labels of the Kruskal-Wallis test and the
+// order of the points in the reference set).
+struct algorithm
+{
+  string dir;   // directory below pareto_union/ (--keep-intermediate)
+  string name;  // suffix of the output files
+  string label; // in the column names of the comparative table
+  string runs;  // glob of the run files, relative to <root_dir>
+  string checkpoints;  // the same with "{checkpoint}" kept (--curves)
+};
+
+static vector<algorithm> algorithms;
+static int nalgs = 0;
+
+struct params
+{
+  int nobjs;
+  vector<int> minmax1;      // -1 minimize, 1 maximize (bound/normalize)
+  vector<int> filter_minmax1; // the same for filter
+  double phi;               // bound
+  char unify[MAX_STR_LENGTH]; // normalize
+  int filter_method;        // filter
+  vector<int> obj;          // 0 minimize, 1 maximize (hyp_ind/eps_ind)
+  int hyp_method;           // hyp_ind
+  vector<double> nadir;     // hyp_ind
+  int eps_method;           // eps_ind
+  double alpha;             // kruskal-wallis
+  // digests of the parameter files above and of sts-pipeline itself
+  digest bound_digest, normalize_digest, filter_digest, hyp_digest,
+    eps_digest, kruskal_digest, tool_digest;
+};
+
+static void read_objectives(FILE *fp, int *nobjs, vector<int> &minmax1)
+{
+  // reads the "dim <n>" and "obj <+|-> ..." lines common to all tools
+  char str[MAX_STR_LENGTH];
+  int i, n;
+
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "dim") != 0, "error in parameter file");
+  error(fscanf(fp, "%d", &n) != 1 || n <= 0, "error in parameter file");
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "obj") != 0, "error in parameter file");
+  minmax1.resize(n);
+  for (i = 0; i < n; i++)
+    {
+      error(fscanf(fp, "%255s", str) != 1, "error in parameter file");
+      error(str[0] != '-' && str[0] != '+', "error in parameter file");
+      minmax1[i] = (str[0] == '-') ? -1 : 1;
+    }
+  *nobjs = n;
+}
+
+static FILE *open_param(const string &path, digest *d)
+{
+  *d = file_digest(path);
+  FILE *fp = fopen(path.c_str(), "rb");
+  if (fp == NULL)
+    {
+      fprintf(stderr, "Couldn't open param file %s\n", path.c_str());
+      exit(1);
+    }
+  return fp;
+}
+
+static void read_params(const string &src, params *par)
+{
+  char str[MAX_STR_LENGTH];
+  FILE *fp;
+  int n;
+  vector<int> mm;
+
+  fp = open_param(src + "/utils/bound/bound_param.txt", &par->bound_digest);
+  read_objectives(fp, &par->nobjs, par->minmax1);
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "phi") != 0, "error in parameter file");
+  error(fscanf(fp, "%lf", &par->phi) != 1, "error in parameter file");
+  error((par->phi<0), "phi should be a positive real number");
+  fclose(fp);
+
+  fp = open_param(src + "/utils/normalize/normalize_param.txt", &par->normalize_digest);
+  read_objectives(fp, &n, mm);
+  error(n != par->nobjs || mm != par->minmax1, "normalize and bound parameters differ");
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "unify") != 0, "error in parameter file");
+  error(fscanf(fp, "%255s", par->unify) != 1, "error in parameter file");
+  error(strcmp(par->unify, "min")!=0 && strcmp(par->unify, "max")!=0 && strcmp(par->unify, "no")!=0, "error in parameter file");
+  fclose(fp);
+
+  fp = open_param(src + "/utils/filter/filter_param.txt", &par->filter_digest);
+  read_objectives(fp, &n, par->filter_minmax1);
+  error(n != par->nobjs, "filter and bound parameters differ");
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "method") != 0, "error in parameter file");
+  error(fscanf(fp, "%d", &par->filter_method) != 1, "error in parameter file");
+  error(par->filter_method != 0 && par->filter_method != 1, "error in parameter file");
+  // with method 0 filter writes one set per run, which hyp_ind and
+  // eps_ind do not accept as a reference set
+  error(par->filter_method != 1, "sts-pipeline needs method 1 in the filter parameter file");
+  fclose(fp);
+
+  fp = open_param(src + "/indicators/hypervolume/hyp_ind_param_NORM.txt", &par->hyp_digest);
+  read_objectives(fp, &n, mm);
+  error(n != par->nobjs, "hyp_ind and bound parameters differ");
+  par->obj.resize(n);
+  for (int i = 0; i < n; i++)
+    par->obj[i] = (mm[i] == -1) ? 0 : 1;
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "method") != 0, "error in parameter file");
+  error(fscanf(fp, "%d", &par->hyp_method) != 1, "error in parameter file");
+  error(par->hyp_method != 0 && par->hyp_method != 1, "error in parameter file");
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "nadir") != 0, "error in parameter file");
+  par->nadir.resize(n);
+  for (int i = 0; i < n; i++)
+    error(fscanf(fp, "%lf", &par->nadir[i]) != 1, "error in parameter file");
+  fclose(fp);
+
+  fp = open_param(src + "/indicators/additive_epsilon/eps_ind_param.txt", &par->eps_digest);
+  read_objectives(fp, &n, mm);
+  error(n != par->nobjs, "eps_ind and bound parameters differ");
+  for (int i = 0; i < n; i++)
+    error(par->obj[i] != ((mm[i] == -1) ? 0 : 1), "eps_ind and hyp_ind parameters differ");
+  error(fscanf(fp, "%255s", str) != 1 || strcmp(str, "method") != 0, "error in parameter file");
+  error(fscanf(fp, "%d", &par->eps_method) != 1, "error in parameter file");
+  error(par->eps_method != 0 && par->eps_method != 1, "error in parameter file");
+  fclose(fp);
+
+  fp = open_param(src + "/indicators/kruskal/kruskalparam.txt", &par->kruskal_digest);
+  if (fscanf(fp, "%*s %lg\n", &par->alpha) == EOF)
+    fprintf(stderr, "Error occurred in parameter file.\n"), exit(1);
+  fclose(fp);
+  error((par->alpha>0.1)||(par->alpha<=0), "The significance, alpha, must be in the range (0,0.1]");
+}
+
+static string substitute(const string &s, const char *key, const string &value)
+{
+  string r;
+  size_t k, from = 0, len = strlen(key);
+  while ((k = s.find(key, from)) != string::npos)
+    {
+      r += s.substr(from, k-from) + value;
+      from = k + len;
+    }
+  return r + s.substr(from);
+}
+
+static void read_algorithms(const string &path)
+{
+  // the algorithm file: comment lines start with #, the other lines are
+  //
+  //   checkpoint <string>
+  //   label <string>
+  //   algorithm <dir> <name> <run glob>
+  //
+  // where "{checkpoint}" in the run globs of the following algorithm lines
+  // is replaced by the last checkpoint given and "{instance}" by the
+  // instance whose runs are read; a label line names the next algorithm in
+  // the columns of the comparative table (HV_<label>, ...), which
+  // otherwise use its <dir>
+  char line[MAX_LINE_LENGTH], key[MAX_STR_LENGTH], dir[MAX_STR_LENGTH],
+    name[MAX_STR_LENGTH], runs[MAX_LINE_LENGTH];
+  string checkpoint, label;
+  FILE *fp = fopen(path.c_str(), "rb");
+
+  if (fp == NULL)
+    {
+      fprintf(stderr, "Couldn't open algorithm file %s\n", path.c_str());
+      exit(1);
+    }
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+      if (sscanf(line, "%255s", key) != 1 || key[0] == '#')
+	continue;
+      if (strcmp(key, "checkpoint") == 0)
+	{
+	  error(sscanf(line, "%*s %255s", name) != 1, "error in algorithm file");
+	  checkpoint = name;
+	}
+      else if (strcmp(key, "label") == 0)
+	{
+	  error(sscanf(line, "%*s %255s", name) != 1, "error in algorithm file");
+	  label = name;
+	}
+      else if (strcmp(key, "algorithm") == 0)
+	{
+	  algorithm a;
+	  error(sscanf(line, "%*s %255s %255s %1023s", dir, name, runs) != 3, "error in algorithm file");
+	  a.dir = dir;
+	  a.name = name;
+	  a.label = label.empty() ? a.dir : label;
+	  label.clear();
+	  a.runs = substitute(runs, "{checkpoint}", checkpoint);
+	  a.checkpoints = runs;
+	  for (size_t i = 0; i < algorithms.size(); i++)
+	    error(algorithms[i].name == a.name, "an algorithm is listed twice in the algorithm file");
+	  algorithms.push_back(a);
+	}
+      else
+	error(true, "error in algorithm file");
+    }
+  fclose(fp);
+  error(algorithms.size() < 2, "the algorithm file has to list at least two algorithms");
+  nalgs = (int)algorithms.size();
+}
+
+static double as_text(double v)
+{
+  // the value a tool obtains when it reads back v written with "%.9e"
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.9e", v);
+  return strtod(buf, NULL);
+}
+
+static int compare_natural(const string &x, const string &y)
+{
+  // orders numbers within the names by value, so that run 10 follows run 9
+  size_t i = 0, j = 0;
+  while (i < x.size() && j < y.size())
+    if (isdigit((unsigned char)x[i]) && isdigit((unsigned char)y[j]))
+      {
+	size_t i0 = i, j0 = j;
+	while (i0 < x.size()-1 && x[i0] == '0' && isdigit((unsigned char)x[i0+1]))
+	  i0++;
+	while (j0 < y.size()-1 && y[j0] == '0' && isdigit((unsigned char)y[j0+1]))
+	  j0++;
+	for (i = i0; i < x.size() && isdigit((unsigned char)x[i]); i++);
+	for (j = j0; j < y.size() && isdigit((unsigned char)y[j]); j++);
+	if (i-i0 != j-j0)
+	  return (i-i0 < j-j0) ? -1 : 1;
+	int c = x.compare(i0, i-i0, y, j0, j-j0);
+	if (c != 0)
+	  return c;
+      }
+    else if (x[i] != y[j])
+      return ((unsigned char)x[i] < (unsigned char)y[j]) ? -1 : 1;
+    else
+      i++, j++;
+  return (x.size()-i < y.size()-j) ? -1 : (x.size()-i > y.size()-j);
+}
+
+static vector<string> run_files(const string &root, int a, const string &p)
+{
+  // the run files of algorithm a for instance p, in natural order
+  string pattern = root + "/" + substitute(algorithms[a].runs, "{instance}", p);
+  vector<string> files;
+  glob_t g;
+
+  if (glob(pattern.c_str(), 0, NULL, &g) == 0)
+    for (size_t i = 0; i < g.gl_pathc; i++)
+      files.push_back(g.gl_pathv[i]);
+  globfree(&g);
+  sort(files.begin(), files.end(),
+       [](const string &x, const string &y) { return compare_natural(x, y) < 0; });
+  return files;
+}
+
+static vector<pair<string, string> > checkpoint_files(const string &root, int a,
+							const string &p, const string &run)
+{
+  // the files of all checkpoints of a run, given its file for the last
+  // checkpoint, as (checkpoint, file) pairs in natural order of the
+  // checkpoints. They are the files of the directory of run whose names
+  // match the file name part of the run glob with the checkpoint left open,
+  // so "{checkpoint}" has to be found there, between fixed strings (as in
+  // {instance}_moead_{checkpoint}.txt)
+  static const char *key = "{checkpoint}";
+  string pattern = substitute(algorithms[a].checkpoints, "{instance}", p);
+  size_t slash = pattern.rfind('/');
+  string name = (slash == string::npos) ? pattern : pattern.substr(slash+1);
+  size_t k = name.find(key);
+  if (k == string::npos || pattern.find(key) != pattern.size()-name.size()+k
+      || name.find(key, k+1) != string::npos
+      || name.find_first_of("*?[") != string::npos)
+    {
+      fprintf(stderr, "--curves needs \"%s\" once in the file names of the run glob of %s\n",
+	      key, algorithms[a].name.c_str());
+      exit(1);
+    }
+  string prefix = name.substr(0, k), suffix = name.substr(k+strlen(key));
+  string dir = run.substr(0, run.rfind('/')+1);
+  vector<pair<string, string> > files;
+  glob_t g;
+
+  if (glob((dir + prefix + "*" + suffix).c_str(), 0, NULL, &g) == 0)
+    for (size_t i = 0; i < g.gl_pathc; i++)
+      {
+	string f = g.gl_pathv[i];
+	size_t fixed = dir.size() + prefix.size() + suffix.size();
+	if (f.size() > fixed)
+	  files.push_back(make_pair(f.substr(dir.size()+prefix.size(), f.size()-fixed), f));
+      }
+  globfree(&g);
+  sort(files.begin(), files.end(),
+       [](const pair<string, string> &x, const pair<string, string> &y)
+       { return compare_natural(x.first, y.first) < 0; });
+  return files;
+}
+
+static void read_front(const vector<string> &files, int nobjs, pointset *f)
+{
+  // the runs of all files, in their order; a blank line within a file
+  // starts a new run, as it does in the union file of the legacy chain
+  pointset run;
+
+  f->clear(nobjs);
+  for (size_t i = 0; i < files.size(); i++)
+    {
+      if (!read_pointset(files[i].c_str(), nobjs, true, &run))
+	{
+	  fprintf(stderr, "Couldn't open %s\n", files[i].c_str());
+	  exit(1);
+	}
+      for (int r = 0; r < run.nruns(); r++)
+	for (int k = 0; k < run.size(r); k++)
+	  f->append(run.run(r) + (size_t)k*nobjs, k == 0);
+    }
+  error(f->npoints() < 1, "error in data file");
+}
+
+static void write_union(const string &path, const vector<string> &files)
+{
+  // pareto_union/<ALG>/<instance>_union_pareto_file.out, as run_analysis.sh
+  // writes it: every run file followed by an empty line
+  static const size_t chunk = 1 << 16;
+  char buf[chunk];
+  size_t n;
+  FILE *out = fopen(path.c_str(), "wb");
+  error(out == NULL, "Couldn't open the union file for writing");
+  for (size_t i = 0; i < files.size(); i++)
+    {
+      FILE *fp = fopen(files[i].c_str(), "rb");
+      if (fp == NULL)
+	{
+	  fprintf(stderr, "Couldn't open %s\n", files[i].c_str());
+	  exit(1);
+	}
+      while ((n = fread(buf, 1, chunk, fp)) > 0)
+	fwrite(buf, 1, n, out);
+      fclose(fp);
+      fprintf(out, "\n");
+    }
+  fclose(out);
+}
+
+static void write_front(const string &path, const pointset &f)
+{
+  // a normalized front in the format of normalize
+  FILE *fp = fopen(path.c_str(), "wb");
+  error(fp == NULL, "Couldn't open the normalized front for writing");
+  for (int r = 0; r < f.nruns(); r++)
+    {
+      const double *o = f.run(r);
+      for (int k = 0; k < f.size(r); k++, o += f.nobjs)
+	{
+	  for (int j = 0; j < f.nobjs; j++)
+	    fprintf(fp, "%.9e ", o[j]);
+	  fprintf(fp, "\n");
+	}
+      if (r < f.nruns()-1)
+	fprintf(fp, "\n");
+    }
+  fclose(fp);
+}
+
+static void bound_points(const pointset &f, const params &par, double *best, double *worst)
+{
+  // bound.cc: moves best and worst to a point of f that is strictly better
+  // or worse in an objective
+  int n = par.nobjs;
+  const vector<int> &minmax1 = par.minmax1;
+  const double *o = f.o.data();
+
+  for (int p = 0; p < f.npoints(); p++, o += n)
+    for (int i = 0; i < n; i++)
+      {
+	if (o[i]*minmax1[i] > best[i]*minmax1[i])
+	  best[i] = o[i];
+	if (o[i]*minmax1[i] < worst[i]*minmax1[i])
+	  worst[i] = o[i];
+      }
+}
+
+static void bound_stage(pointset *fronts, const params &par, double *best, double *worst)
+{
+  // bound.cc: best and worst value in each objective over all points
+  for (int i = 0; i < par.nobjs; i++)
+    best[i] = worst[i] = fronts[0].o[i];
+  for (int a = 0; a < nalgs; a++)
+    bound_points(fronts[a], par, best, worst);
+}
+
+static void normalize_stage(pointset *f, const scale_map &m)
+{
+  // normalize.cc: maps each objective to [1,2], optionally reversing the
+  // sense (scale.h)
+  scale_points(m, f->o.data(), f->o.data(), f->npoints());
+  for (size_t i = 0; i < f->o.size(); i++)
+    f->o[i] = as_text(f->o[i]);
+}
+
+static void filter_stage(pointset *fronts, const params &par, pointset *ref,
+			 const filter_executor &run)
+{
+  // filter.cc with method 1: the nondominated, duplicate free set among the
+  // points of all runs of all algorithms, in their original order; the
+  // runs are filtered as tasks of run and their fronts merged as a tree
+  int n = par.nobjs;
+  const int *minmax1 = par.filter_minmax1.data();
+  vector<const double *> all;
+  vector<int> start(1, 0);
+
+  for (int a = 0; a < nalgs; a++)
+    for (int r = 0; r < fronts[a].nruns(); r++)
+      {
+	for (int p = 0; p < fronts[a].size(r); p++)
+	  all.push_back(fronts[a].run(r) + (size_t)p*n);
+	start.push_back((int)all.size());
+      }
+  bool *dominated = new bool[all.size()+1];
+  filter_merge(all.data(), start.data(), (int)start.size()-1, n, minmax1, dominated, run);
+
+  ref->clear(n);
+  for (size_t i = 0; i < all.size(); i++)
+    if (!dominated[i])
+      ref->append(all[i], false);
+  delete [] dominated;
+  error(ref->npoints() < 1, "error in reference set file");
+}
+
+static void make_dirs(const string &path)
+{
+  // mkdir -p
+  for (size_t i = 1; i <= path.size(); i++)
+    if (i == path.size() || path[i] == '/')
+      {
+	string dir = path.substr(0, i);
+	if (mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST)
+	  {
+	    fprintf(stderr, "Couldn't create directory %s\n", dir.c_str());
+	    exit(1);
+	  }
+      }
+}
+
+static FILE *open_output(const string &path, const char *mode)
+{
+  FILE *fp = fopen(path.c_str(), mode);
+  if (fp == NULL)
+    {
+      fprintf(stderr, "Couldn't open %s for writing\n", path.c_str());
+      exit(1);
+    }
+  return fp;
+}
+
+static void write_bound(const string &path, const params &par, const double *best,
+			const double *worst, double *lbound, double *ubound)
+{
+  // bound.out from the best and worst values; lbound and ubound receive
+  // the bounds as normalize reads them back
+  int i, n = par.nobjs;
+  for (i = 0; i < n; i++)
+    {
+      lbound[i] = (par.minmax1[i] == -1) ? best[i] : worst[i];
+      ubound[i] = (par.minmax1[i] == -1) ? worst[i] : best[i];
+    }
+  FILE *fp = open_output(path, "wb");
+  fprintf(fp, "lower_bound ");
+  for (i = 0; i < n; i++)
+    fprintf(fp, "%.9e ", lbound[i]);
+  fprintf(fp, "\n");
+  fprintf(fp, "upper_bound ");
+  for (i = 0; i < n; i++)
+    fprintf(fp, "%.9e ", ubound[i]);
+  fprintf(fp, "\n");
+  fclose(fp);
+  for (i = 0; i < n; i++)
+    {
+      lbound[i] = as_text(lbound[i]);
+      ubound[i] = as_text(ubound[i]);
+    }
+}
+
+static void write_reference(const string &path, const pointset &ref)
+{
+  // reference_set.out in the format of filter
+  FILE *fp = open_output(path, "wb");
+  for (int q = 0; q < ref.npoints(); q++)
+    {
+      for (int i = 0; i < ref.nobjs; i++)
+	fprintf(fp, "%.9e ", ref.point(q)[i]);
+      fprintf(fp, "\n");
+    }
+  fprintf(fp, "\n");
+  fclose(fp);
+}
+
+static void write_values(const string &path, const vector<double> &v, bool repr)
+{
+  // one value per run followed by a blank line, as hyp_ind/eps_ind/igd plus
+  // the "echo" in run_analysis.sh produce it; igd writes Python's repr()
+  char buf[64];
+  FILE *fp = open_output(path, "w");
+  for (size_t i = 0; i < v.size(); i++)
+    {
+      if (repr)
+	igd_format(v[i], buf, sizeof(buf));
+      else
+	snprintf(buf, sizeof(buf), "%.9e", v[i]);
+      fprintf(fp, "%s\n", buf);
+    }
+  fprintf(fp, "\n");
+  fclose(fp);
+}
+
+static void write_table(const string &path, const vector<double> *hv,
+			const vector<double> *eps, const vector<double> *igd)
+{
+  // the table of ind_batch, with the names of the algorithms
+  char buf[64];
+  FILE *fp = open_output(path, "w");
+  fprintf(fp, "alg run hv eps igd\n");
+  for (int a = 0; a < nalgs; a++)
+    for (size_t r = 0; r < hv[a].size(); r++)
+      {
+	igd_format(igd[a][r], buf, sizeof(buf));
+	fprintf(fp, "%s %d %.9e %.9e %s\n", algorithms[a].name.c_str(), (int)r+1, hv[a][r], eps[a][r], buf);
+      }
+  fclose(fp);
+}
+
+// The best-so-far front of a run over its checkpoints (--cumulative-curves):
+// the nondominated points among the points of all checkpoints added so far
+// that are better than the reference point of hyp_ind in every objective,
+// and their hypervolume. Points that are not take no part, so the values
+// of this front are not those of any checkpoint file. For 2 and 3
+// objectives an hv_archive (archive.h) takes the points of each checkpoint
+// one by one and keeps the hypervolume up to date; otherwise the front is
+// filtered and hv_ind_value() is run again after every checkpoint.
+class curve_front
+{
+ public:
+  curve_front(const params &par);
+  ~curve_front() { delete a2; delete a3; }
+  curve_front(const curve_front &) = delete;
+  curve_front &operator=(const curve_front &) = delete;
+
+  void add(const double *points, int size);
+  double hypervolume() const { return volume; }
+  int size() const { return (int)(front.size()/nobjs); }
+  vector<double> &points() { return front; }  // row-major
+
+ private:
+  int nobjs;
+  const int *obj;
+  const double *nadir;
+  vector<int> minmax1;     // the senses as filter takes them
+  hv_archive<2> *a2;
+  hv_archive<3> *a3;
+  vector<double> front;
+  double volume;
+};
+
+curve_front::curve_front(const params &par)
+  : nobjs(par.nobjs), obj(par.obj.data()), nadir(par.nadir.data()),
+    a2(NULL), a3(NULL), volume(0.0)
+{
+  if (nobjs == 2)
+    a2 = new hv_archive<2>(obj, nadir);
+  else if (nobjs == 3)
+    a3 = new hv_archive<3>(obj, nadir);
+  for (int k = 0; k < nobjs; k++)
+    minmax1.push_back(obj[k] == 0 ? -1 : 1);
+}
+
+void curve_front::add(const double *points, int size)
+{
+  const double *o = points;
+  if (a2 != NULL || a3 != NULL)
+    {
+      for (int i = 0; i < size; i++, o += nobjs)
+	if (a2 != NULL)
+	  a2->insert(o);
+	else
+	  a3->insert(o);
+      if (a2 != NULL)
+	a2->points(front), volume = a2->hypervolume();
+      else
+	a3->points(front), volume = a3->hypervolume();
+      return;
+    }
+
+  // the points better than nadir, as the archive takes them
+  for (int i = 0; i < size; i++, o += nobjs)
+    {
+      int k;
+      for (k = 0; k < nobjs; k++)
+	if (!((obj[k] == 0 ? nadir[k] - o[k] : o[k] - nadir[k]) > 0))
+	  break;
+      if (k == nobjs)
+	front.insert(front.end(), o, o+nobjs);
+    }
+  int n = this->size();
+  vector<const double *> all(n);
+  for (int i = 0; i < n; i++)
+    all[i] = &front[(size_t)i*nobjs];
+  bool *dominated = new bool[n+1];
+  filter_nondominated(all.data(), n, nobjs, minmax1.data(), dominated);
+  size_t m = 0;
+  for (int i = 0; i < n; i++)
+    if (!dominated[i])
+      for (int k = 0; k < nobjs; k++)
+	front[m++] = front[(size_t)i*nobjs+k];
+  delete [] dominated;
+  front.resize(m);
+  vector<double> tmp(front);
+  volume = hv_ind_value(tmp.data(), this->size(), nobjs, obj, nadir);
+}
+
+static void run_indicators(pointset &f, int r, const params &par,
+			   pointset &ref, double ref_set_value, double *hv,
+			   double *eps, double *igd, trace_span *spans)
+{
+  // hyp_ind, eps_ind and igd on run r of the normalized front f, each
+  // traced as a task of spans[0], spans[1] and spans[2]
+  int n = par.nobjs;
+  trace_usage task;
+  trace_task_begin(&task);
+  vector<double> tmp(f.run(r), f.run(r) + (size_t)f.size(r)*n);
+  double v = hv_ind_value(tmp.data(), f.size(r), n, par.obj.data(), par.nadir.data());
+  *hv = (par.hyp_method == 1 ? ref_set_value - v : -v);
+  trace_task_end(&spans[0], &task);
+  trace_task_begin(&task);
+  *eps = eps_ind_value(ref.o.data(), ref.npoints(), f.run(r), f.size(r),
+		       n, par.obj.data(), par.eps_method);
+  trace_task_end(&spans[1], &task);
+  trace_task_begin(&task);
+  *igd = igd_value(ref.o.data(), ref.npoints(), f.run(r), f.size(r), n);
+  trace_task_end(&spans[2], &task);
+}
+
+struct curve_point
+{
+  string checkpoint;
+  double hv, eps, igd;
+};
+
+static long long curve_stage(const vector<pair<string, string> > &files,
+			     const params &par, const scale_map &scale,
+			     pointset &ref, double ref_set_value, bool cumulative,
+			     vector<curve_point> *curve)
+{
+  // the indicators of a run at each of its checkpoints. Every checkpoint
+  // file is parsed once and normalized with the bound of the instance (the
+  // one of the last checkpoints of all runs, so that the curves of all
+  // algorithms share it) and evaluated against the reference set of the
+  // instance, as run_indicators() evaluates a run, except that points
+  // beyond the reference point of hyp_ind are left out of the hypervolume:
+  // the row of the last checkpoint, which is the run file, holds the values
+  // of HV_, esp_ad_ and IGD_. With cumulative set, the points are added to
+  // the best-so-far front of the run instead (curve_front), and the
+  // indicators are those of that front. Returns the number of points read
+  int n = par.nobjs;
+  pointset run;
+  curve_front front(par);
+  long long npoints = 0;
+
+  curve->clear();
+  for (size_t c = 0; c < files.size(); c++)
+    {
+      if (!read_pointset(files[c].second.c_str(), n, true, &run))
+	{
+	  fprintf(stderr, "Couldn't open %s\n", files[c].second.c_str());
+	  exit(1);
+	}
+      scale_points(scale, run.o.data(), run.o.data(), run.npoints());
+      for (size_t i = 0; i < run.o.size(); i++)
+	run.o[i] = as_text(run.o[i]);
+      npoints += run.npoints();
+
+      curve_point q;
+      q.checkpoint = files[c].first;
+      if (!cumulative)
+	{
+	  // hyp_ind would refuse the points beyond nadir, which an earlier
+	  // checkpoint may have with the bound of the last ones; they add no
+	  // volume and are left out of the hypervolume only
+	  vector<double> inside;
+	  const double *o = run.o.data();
+	  for (int i = 0; i < run.npoints(); i++, o += n)
+	    {
+	      int k;
+	      for (k = 0; k < n; k++)
+		if ((par.obj[k] == 0 ? par.nadir[k] - o[k] : o[k] - par.nadir[k]) < 0)
+		  break;
+	      if (k == n)
+		inside.insert(inside.end(), o, o+n);
+	    }
+	  double v = hv_ind_value(inside.data(), (int)(inside.size()/n), n,
+				  par.obj.data(), par.nadir.data());
+	  q.hv = (par.hyp_method == 1 ? ref_set_value - v : -v);
+	  q.eps = q.igd = INFINITY;  // an empty checkpoint
+	  if (run.npoints() > 0)
+	    {
+	      q.eps = eps_ind_value(ref.o.data(), ref.npoints(), run.o.data(), run.npoints(),
+				    n, par.obj.data(), par.eps_method);
+	      q.igd = igd_value(ref.o.data(), ref.npoints(), run.o.data(), run.npoints(), n);
+	    }
+	  curve->push_back(q);
+	  continue;
+	}
+
+      front.add(run.o.data(), run.npoints());
+      double v = front.hypervolume();
+      q.hv = (par.hyp_method == 1 ? ref_set_value - v : -v);
+      q.eps = q.igd = INFINITY;  // no point better than nadir yet
+      if (front.size() > 0)
+	{
+	  q.eps = eps_ind_value(ref.o.data(), ref.npoints(), front.points().data(), front.size(),
+				n, par.obj.data(), par.eps_method);
+	  q.igd = igd_value(ref.o.data(), ref.npoints(), front.points().data(), front.size(), n);
+	}
+      curve->push_back(q);
+    }
+  return npoints;
+}
+
+static bool same_value(double x, double y)
+{
+  return x == y || (isnan(x) && isnan(y));
+}
+
+static void check_curves(int a, const vector<string> &files,
+			 const vector<vector<pair<string, string> > > &checkpoints,
+			 const vector<vector<curve_point> > &curves, const pointset &f,
+			 const vector<double> &hv, const vector<double> &eps,
+			 const vector<double> &igd)
+{
+  // the row of the checkpoint that is the run file itself must hold the
+  // values of HV_, esp_ad_ and IGD_, as they were written (hv and eps
+  // through "%.9e"); only checked if every file holds a single run
+  if ((size_t)f.nruns() != files.size())
+    return;
+  for (size_t r = 0; r < files.size(); r++)
+    for (size_t c = 0; c < checkpoints[r].size(); c++)
+      if (checkpoints[r][c].second == files[r])
+	{
+	  const curve_point &q = curves[r][c];
+	  if (!same_value(as_text(q.hv), hv[r]) || !same_value(as_text(q.eps), eps[r])
+	      || !same_value(q.igd, igd[r]))
+	    {
+	      fprintf(stderr, "The curve of %s does not match its indicators at %s\n",
+		      algorithms[a].name.c_str(), files[r].c_str());
+	      exit(1);
+	    }
+	}
+}
+
+static void write_curves(const string &path, const vector<vector<curve_point> > &curves)
+{
+  // curves/curve_<name>.out: one line per checkpoint of every run
+  char buf[64];
+  FILE *fp = open_output(path, "w");
+  fprintf(fp, "run checkpoint hv eps igd\n");
+  for (size_t r = 0; r < curves.size(); r++)
+    for (size_t c = 0; c < curves[r].size(); c++)
+      {
+	const curve_point &q = curves[r][c];
+	igd_format(q.igd, buf, sizeof(buf));
+	fprintf(fp, "%d %s %.9e %.9e %s\n", (int)r+1, q.checkpoint.c_str(), q.hv, q.eps, buf);
+      }
+  fclose(fp);
+}
+
+// The detailed output of the three Kruskal-Wallis tests of an instance is
+// collected in memory and appended to logs/log_*_kruskal.txt as one block,
+// in the order in which the instances were given on the command line.
+static const char *tests[] = {"hv", "eps", "igd"};
+static const int ntests = 3;
+
+struct instance_log
+{
+  char *text[ntests];
+  size_t len[ntests];
+  bool done;
+};
+
+static mutex log_mutex;
+static vector<instance_log> logs;
+static size_t next_log = 0;
+
+static void flush_logs(const string &root, size_t id)
+{
+  lock_guard<mutex> lk(log_mutex);
+  logs[id].done = true;
+  for (; next_log < logs.size() && logs[next_log].done; next_log++)
+    for (int t = 0; t < ntests; t++)
+      {
+	if (logs[next_log].text[t] == NULL)
+	  continue;
+	FILE *fp = open_output(root + "/logs/log_" + tests[t] + "_kruskal.txt", "a");
+	fwrite(logs[next_log].text[t], 1, logs[next_log].len[t], fp);
+	fclose(fp);
+	free(logs[next_log].text[t]);
+	logs[next_log].text[t] = NULL;
+      }
+}
+
+static int labelled(const vector<double> *values, vector<D> &d, vector<int> &Nsamp)
+  // the values of all algorithms as the samples of the Kruskal-Wallis test,
+  // in the order of the concatenated indicator files; returns their number
+{
+  Nsamp.resize(nalgs);
+  for (int a = 0; a < nalgs; a++)
+    {
+      Nsamp[a] = (int)values[a].size();
+      for (size_t i = 0; i < values[a].size(); i++)
+	{
+	  D x;
+	  x.value = values[a][i];
+	  x.label = a;
+	  x.rank = 0;
+	  d.push_back(x);
+	}
+    }
+  return (int)d.size();
+}
+
+static void kruskal_stage(const vector<double> *values, const params &par,
+			  const string &outfile, FILE *log)
+{
+  // kruskal-wallis.cc on the concatenation of the indicator files
+  vector<D> d;
+  vector<int> Nsamp;
+  int N = labelled(values, d, Nsamp);
+
+  FILE *out = open_output(outfile, "w");
+  if (VERBOSE)
+    fprintf(log,"Number of sample populations = %d. Total number of values in the input = %d\n", nalgs, N);
+  kruskal_wallis(d.data(), N, nalgs, Nsamp.data(), par.alpha, VERBOSE, log, log, out);
+  fprintf(log, "\n");
+  fclose(out);
+}
+
+// The row of an instance in the comparative table (see table.h), filled
+// from the values in memory once the instance is done.
+struct table_row
+{
+  vector<double> mean[ntests];  // of every algorithm
+  double p_value[ntests];       // of all distribution functions being equal
+  string kruskal[ntests];       // the pairs that differ, or "H0"
+};
+
+static void summarize(const vector<double> *values, const params &par, int t,
+		      table_row *row)
+{
+  // the means and the outcome of the Kruskal-Wallis test of indicator t:
+  // the lines of the kruskal output whose p-value, as printed there, is at
+  // most alpha, joined by " | " as build_comparative_table.py joins them
+  vector<D> d;
+  vector<int> Nsamp;
+  int N = labelled(values, d, Nsamp);
+  char line[MAX_LINE_LENGTH], num[64];
+
+  row->mean[t].resize(nalgs);
+  for (int a = 0; a < nalgs; a++)
+    row->mean[t][a] = table_mean(values[a].data(), values[a].size());
+  rank_engine r;
+  r.rank(d.data(), N, nalgs, false);
+  double T = Tvalue(r);
+  chi_tails(&T, 1, nalgs-1, NULL, &row->p_value[t]);
+  row->kruskal[t].clear();
+  if (row->p_value[t] <= par.alpha)
+    {
+      vector<double> q((size_t)nalgs*nalgs);
+      kruskal_pairs(r, T, q.data());
+      for (int i = 0; i < nalgs; i++)
+	for (int j = 0; j < nalgs; j++)
+	  {
+	    if (i == j)
+	      continue;
+	    snprintf(num, sizeof(num), "%g", q[i*nalgs+j]);
+	    if (strtod(num, NULL) > par.alpha)
+	      continue;
+	    snprintf(line, sizeof(line), "%d better than %d with a p-value of %s", j+1, i+1, num);
+	    if (!row->kruskal[t].empty())
+	      row->kruskal[t] += " | ";
+	    row->kruskal[t] += line;
+	  }
+    }
+  if (row->kruskal[t].empty())
+    row->kruskal[t] = "H0";
+}
+
+// the files with the values of indicator t (in the order of tests[]) for
+// algorithm a
+static string value_file(const string &dir, int t, int a)
+{
+  static const char *subdir[ntests] = {"hypervolume", "epsilon_additive", "igd"};
+  static const char *prefix[ntests] = {"HV_", "esp_ad_", "IGD_"};
+  return dir + "/" + subdir[t] + "/" + prefix[t] + algorithms[a].name + ".out";
+}
+
+static string curve_file(const string &dir, int a)
+{
+  return dir + "/curves/curve_" + algorithms[a].name + ".out";
+}
+
+static bool read_values(const string &path, vector<double> *v)
+{
+  // reads back a file written by write_values()
+  pointset ps;
+  if (!read_pointset(path.c_str(), 1, false, &ps))
+    return false;
+  v->swap(ps.o);
+  return true;
+}
+
+static digest files_digest(const vector<string> &paths)
+{
+  hasher h;
+  for (size_t i = 0; i < paths.size(); i++)
+    h.update(file_digest(paths[i]));
+  return h.value();
+}
+
+static bool force = false;  // --force: ignore the manifests
+static bool keep_intermediate = false;  // --keep-intermediate
+static bool curves = false;  // --curves
+static bool cumulative_curves = false;  // --cumulative-curves
+
+static void run_instance(pool &workers, const string &root, const string &p,
+			 const params &par, instance_log *ilog, table_row *row)
+{
+  string dir = root + "/analysis/" + p;
+  vector<pointset> fronts(nalgs);
+  pointset ref;
+  int n = par.nobjs;
+  vector<double> lbound(n), ubound(n);
+  manifest man;
+  mutex man_mutex;
+  vector<digest> front_digest(nalgs);
+  vector<vector<string> > front_files(nalgs);
+  vector<vector<vector<pair<string, string> > > > checkpoints(nalgs);  // --curves
+  vector<digest> checkpoint_digest(nalgs);
+  vector<string> outputs;
+  // the stages of the instance are made of tasks (see trace.h), as other
+  // instances may run on the same threads in the meantime
+  trace_span inst, span;
+  trace_usage task;
+  long long npoints = 0;
+
+  // the instance as a whole: nothing to do if none of its inputs changed
+  // and all of its outputs are as they were left
+  trace_begin_tasks(&inst, "instance", NULL);
+  trace_begin_tasks(&span, "digest", &inst);
+  trace_task_begin(&task);
+  hasher in;
+  in.update(par.tool_digest);
+  in.update(par.bound_digest);
+  in.update(par.normalize_digest);
+  in.update(par.filter_digest);
+  in.update(par.hyp_digest);
+  in.update(par.eps_digest);
+  in.update(par.kruskal_digest);
+  for (int a = 0; a < nalgs; a++)
+    {
+      hasher h;
+      front_files[a] = run_files(root, a, p);
+      for (size_t r = 0; r < front_files[a].size(); r++)
+	{
+	  h.update(front_files[a][r]);
+	  h.update(file_digest(front_files[a][r]));
+	}
+      front_digest[a] = h.value();
+      in.update(algorithms[a].name);
+      in.update(front_digest[a]);
+      if (!curves)
+	continue;
+      hasher c;
+      c.update(string(cumulative_curves ? "cumulative" : "checkpoints"));
+      checkpoints[a].resize(front_files[a].size());
+      for (size_t r = 0; r < front_files[a].size(); r++)
+	{
+	  checkpoints[a][r] = checkpoint_files(root, a, p, front_files[a][r]);
+	  for (size_t k = 0; k < checkpoints[a][r].size(); k++)
+	    {
+	      c.update(checkpoints[a][r][k].second);
+	      c.update(file_digest(checkpoints[a][r][k].second));
+	    }
+	}
+      checkpoint_digest[a] = c.value();
+      in.update(checkpoint_digest[a]);
+      outputs.push_back(curve_file(dir, a));
+    }
+  outputs.push_back(dir + "/utils/bound.out");
+  outputs.push_back(dir + "/reference_set.out");
+  outputs.push_back(dir + "/indicators.out");
+  for (int t = 0; t < ntests; t++)
+    {
+      for (int a = 0; a < nalgs; a++)
+	outputs.push_back(value_file(dir, t, a));
+      outputs.push_back(dir + "/kruskal/" + tests[t] + "_saidakruskal.out");
+    }
+  if (!force)
+    man.load(dir + "/manifest.txt");
+  bool unchanged = man.unchanged("instance", in.value(), files_digest(outputs));
+  trace_task_end(&span, &task);
+  trace_end(&span, p.c_str(), NULL, 0);
+  if (unchanged)
+    {
+      // the row of the comparative table from the values left by the last run
+      fprintf(stdout, "- [SKIPPED] sts-pipeline for instance %s (unchanged)\n", p.c_str());
+      trace_task_begin(&task);
+      for (int t = 0; t < ntests; t++)
+	{
+	  vector<vector<double> > values(nalgs);
+	  for (int a = 0; a < nalgs; a++)
+	    if (!read_values(value_file(dir, t, a), &values[a]))
+	      {
+		fprintf(stderr, "Couldn't read %s\n", value_file(dir, t, a).c_str());
+		exit(1);
+	      }
+	  summarize(values.data(), par, t, row);
+	}
+      trace_task_end(&inst, &task);
+      trace_end(&inst, p.c_str(), NULL, 0);
+      return;
+    }
+
+  fprintf(stdout, "- [RUNNING] sts-pipeline for instance %s\n", p.c_str());
+  make_dirs(dir + "/utils");
+  make_dirs(dir + "/epsilon_additive");
+  make_dirs(dir + "/hypervolume");
+  make_dirs(dir + "/igd");
+  make_dirs(dir + "/kruskal");
+
+  trace_begin_tasks(&span, "parse", &inst);
+  workers.parallel_for(nalgs, [&](int a) {
+      trace_usage task;
+      trace_task_begin(&task);
+      if (front_files[a].empty())
+	{
+	  fprintf(stderr, "No run files of %s for instance %s\n", algorithms[a].name.c_str(), p.c_str());
+	  exit(1);
+	}
+      read_front(front_files[a], n, &fronts[a]);
+      if (keep_intermediate)
+	{
+	  make_dirs(root + "/pareto_union/" + algorithms[a].dir);
+	  write_union(root + "/pareto_union/" + algorithms[a].dir + "/" + p + "_union_pareto_file.out",
+		      front_files[a]);
+	}
+      trace_task_end(&span, &task);
+    });
+  for (int a = 0; a < nalgs; a++)
+    npoints += fronts[a].npoints();
+  trace_end(&span, p.c_str(), NULL, npoints);
+
+  // bound, normalize and filter take linear time (filter n log n for two
+  // objectives) and are rerun whenever the instance changed; their
+  // outputs are part of the digests of the stages below, so that those
+  // only run again if the bound or the reference set came out different
+  trace_begin_tasks(&span, "bound", &inst);
+  trace_task_begin(&task);
+  vector<double> best(n), worst(n);
+  bound_stage(fronts.data(), par, best.data(), worst.data());
+  write_bound(dir + "/utils/bound.out", par, best.data(), worst.data(), lbound.data(), ubound.data());
+  hasher bound_in;
+  bound_in.update(par.tool_digest);
+  bound_in.update(par.bound_digest);
+  for (int a = 0; a < nalgs; a++)
+    bound_in.update(front_digest[a]);
+  digest bound_out = file_digest(dir + "/utils/bound.out");
+  man.set("bound", bound_in.value(), bound_out);
+  trace_task_end(&span, &task);
+  trace_end(&span, p.c_str(), NULL, npoints);
+
+  trace_begin_tasks(&span, "normalize", &inst);
+  scale_map scale;
+  scale_setup(&scale, n, par.minmax1.data(), par.unify, lbound.data(), ubound.data());
+  workers.parallel_for(nalgs, [&](int a) {
+      trace_usage task;
+      trace_task_begin(&task);
+      normalize_stage(&fronts[a], scale);
+      if (keep_intermediate)
+	write_front(dir + "/utils/" + algorithms[a].name + "_normalizado.out", fronts[a]);
+      trace_task_end(&span, &task);
+    });
+  trace_end(&span, p.c_str(), NULL, npoints);
+  trace_begin_tasks(&span, "filter", &inst);
+  filter_stage(fronts.data(), par, &ref, [&](int m, const function<void(int)> &f) {
+      workers.parallel_for(m, [&](int k) {
+	  trace_usage task;
+	  trace_task_begin(&task);
+	  f(k);
+	  trace_task_end(&span, &task);
+	});
+    });
+  trace_task_begin(&task);
+  write_reference(dir + "/reference_set.out", ref);
+  hasher ref_in;
+  ref_in.update(bound_in.value());
+  ref_in.update(bound_out);
+  ref_in.update(par.normalize_digest);
+  ref_in.update(par.filter_digest);
+  digest ref_out = file_digest(dir + "/reference_set.out");
+  man.set("reference_set", ref_in.value(), ref_out);
+  trace_task_end(&span, &task);
+  trace_end(&span, p.c_str(), NULL, npoints);
+
+  // indicators; an algorithm is only evaluated again if its front, the
+  // bound, the reference set or the parameters changed. Every run is a
+  // task of its own, so that idle threads can help with an instance whose
+  // fronts are much larger than the others
+  vector<vector<double> > hv(nalgs), eps(nalgs), igd(nalgs);
+  vector<double> *values[ntests] = {hv.data(), eps.data(), igd.data()};
+  vector<pair<int,int> > jobs;
+  vector<digest> ind_in(nalgs);
+  vector<char> redo(nalgs);
+  static const char *ind_stage[ntests] = {"hypervolume", "epsilon", "igd"};
+  trace_span ind_span[ntests];
+  long long ind_points = 0;
+  trace_task_begin(&task);
+  for (int a = 0; a < nalgs; a++)
+    {
+      hasher h;
+      vector<string> files;
+      h.update(par.tool_digest);
+      h.update(front_digest[a]);
+      h.update(bound_out);
+      h.update(par.normalize_digest);
+      h.update(ref_out);
+      h.update(par.hyp_digest);
+      h.update(par.eps_digest);
+      ind_in[a] = h.value();
+      for (int t = 0; t < ntests; t++)
+	files.push_back(value_file(dir, t, a));
+      redo[a] = !man.unchanged(string("indicators_") + algorithms[a].name, ind_in[a], files_digest(files));
+      for (int t = 0; t < ntests && !redo[a]; t++)
+	redo[a] = !read_values(value_file(dir, t, a), &values[t][a])
+	  || values[t][a].size() != (size_t)fronts[a].nruns();
+      if (!redo[a])
+	continue;
+      hv[a].resize(fronts[a].nruns());
+      eps[a].resize(fronts[a].nruns());
+      igd[a].resize(fronts[a].nruns());
+      for (int r = 0; r < fronts[a].nruns(); r++)
+	jobs.push_back(make_pair(a, r));
+      ind_points += fronts[a].npoints();
+    }
+  trace_task_end(&inst, &task);
+  for (int t = 0; t < ntests; t++)
+    trace_begin_tasks(&ind_span[t], ind_stage[t], &inst);
+  double ref_set_value = 0;
+  if (par.hyp_method == 1 && !jobs.empty())
+    {
+      trace_task_begin(&task);
+      vector<double> tmp(ref.o);
+      ref_set_value = hv_ind_value(tmp.data(), ref.npoints(), n, par.obj.data(), par.nadir.data());
+      trace_task_end(&ind_span[0], &task);
+    }
+
+  workers.parallel_for((int)jobs.size(), [&](int j) {
+      int a = jobs[j].first, r = jobs[j].second;
+      run_indicators(fronts[a], r, par, ref, ref_set_value, &hv[a][r], &eps[a][r], &igd[a][r], ind_span);
+    });
+
+  for (int a = 0; a < nalgs; a++)
+    {
+      if (!redo[a])
+	continue;
+      vector<string> files;
+      for (int t = 0; t < ntests; t++)
+	{
+	  trace_task_begin(&task);
+	  write_values(value_file(dir, t, a), values[t][a], t == 2);
+	  trace_task_end(&ind_span[t], &task);
+	  files.push_back(value_file(dir, t, a));
+	}
+      trace_task_begin(&task);
+      man.set(string("indicators_") + algorithms[a].name, ind_in[a], files_digest(files));
+      // kruskal-wallis reads the values back from the files written above
+      for (size_t r = 0; r < hv[a].size(); r++)
+	{
+	  hv[a][r] = as_text(hv[a][r]);
+	  eps[a][r] = as_text(eps[a][r]);
+	}
+      trace_task_end(&inst, &task);
+    }
+  // only the indicators of the algorithms that were evaluated again
+  if (!jobs.empty())
+    for (int t = 0; t < ntests; t++)
+      trace_end(&ind_span[t], p.c_str(), NULL, ind_points);
+  trace_task_begin(&task);
+  write_table(dir + "/indicators.out", hv.data(), eps.data(), igd.data());
+  trace_task_end(&inst, &task);
+
+  // the curves (--curves) of the algorithms whose checkpoints, bound or
+  // reference set changed; every run is a task
+  if (curves)
+    {
+      vector<vector<vector<curve_point> > > curve(nalgs);
+      vector<pair<int,int> > curve_jobs;
+      vector<digest> curve_in(nalgs);
+      trace_task_begin(&task);
+      for (int a = 0; a < nalgs; a++)
+	{
+	  hasher h;
+	  h.update(par.tool_digest);
+	  h.update(checkpoint_digest[a]);
+	  h.update(bound_out);
+	  h.update(par.normalize_digest);
+	  h.update(ref_out);
+	  h.update(par.hyp_digest);
+	  h.update(par.eps_digest);
+	  curve_in[a] = h.value();
+	  if (man.unchanged(string("curves_") + algorithms[a].name, curve_in[a],
+			    file_digest(curve_file(dir, a))))
+	    continue;
+	  curve[a].resize(checkpoints[a].size());
+	  for (size_t r = 0; r < checkpoints[a].size(); r++)
+	    curve_jobs.push_back(make_pair(a, (int)r));
+	}
+      trace_task_end(&inst, &task);
+      if (!curve_jobs.empty())
+	{
+	  vector<long long> curve_points(curve_jobs.size());
+	  trace_begin_tasks(&span, "curves", &inst);
+	  trace_task_begin(&task);
+	  make_dirs(dir + "/curves");
+	  if (par.hyp_method == 1 && jobs.empty())
+	    {
+	      vector<double> tmp(ref.o);
+	      ref_set_value = hv_ind_value(tmp.data(), ref.npoints(), n, par.obj.data(), par.nadir.data());
+	    }
+	  trace_task_end(&span, &task);
+	  workers.parallel_for((int)curve_jobs.size(), [&](int j) {
+	      int a = curve_jobs[j].first, r = curve_jobs[j].second;
+	      trace_usage task;
+	      trace_task_begin(&task);
+	      curve_points[j] = curve_stage(checkpoints[a][r], par, scale, ref, ref_set_value,
+					    cumulative_curves, &curve[a][r]);
+	      trace_task_end(&span, &task);
+	    });
+	  trace_task_begin(&task);
+	  long long total = 0;
+	  for (size_t j = 0; j < curve_jobs.size(); j++)
+	    total += curve_points[j];
+	  for (int a = 0; a < nalgs; a++)
+	    if (!curve[a].empty())
+	      {
+		if (!cumulative_curves)
+		  check_curves(a, front_files[a], checkpoints[a], curve[a], fronts[a],
+			       hv[a], eps[a], igd[a]);
+		write_curves(curve_file(dir, a), curve[a]);
+		man.set(string("curves_") + algorithms[a].name, curve_in[a],
+			file_digest(curve_file(dir, a)));
+	      }
+	  trace_task_end(&span, &task);
+	  trace_end(&span, p.c_str(), NULL, total);
+	}
+    }
+
+  // Kruskal-Wallis, for the indicators whose values changed
+  workers.parallel_for(ntests, [&](int t) {
+      string outfile = dir + "/kruskal/" + tests[t] + "_saidakruskal.out";
+      string stage = string("kruskal_") + tests[t];
+      trace_span span;
+      trace_usage task;
+      trace_task_begin(&task);
+      hasher h;
+      h.update(par.tool_digest);
+      h.update(par.kruskal_digest);
+      for (int a = 0; a < nalgs; a++)
+	h.update(file_digest(value_file(dir, t, a)));
+      bool unchanged;
+      {
+	// man.set() of another test may be inserting into the manifest
+	lock_guard<mutex> lk(man_mutex);
+	unchanged = man.unchanged(stage, h.value(), file_digest(outfile));
+      }
+      if (unchanged)
+	{
+	  trace_task_end(&inst, &task);
+	  return;
+	}
+      trace_begin_tasks(&span, stage.c_str(), &inst);
+      FILE *log = open_memstream(&ilog->text[t], &ilog->len[t]);
+      error(log == NULL, "memory overflow");
+      kruskal_stage(values[t], par, outfile, log);
+      fclose(log);
+      trace_task_end(&span, &task);
+      long long nvalues = 0;
+      for (int a = 0; a < nalgs; a++)
+	nvalues += values[t][a].size();
+      trace_end(&span, p.c_str(), NULL, nvalues);
+      lock_guard<mutex> lk(man_mutex);
+      man.set(stage, h.value(), file_digest(outfile));
+    });
+
+  trace_task_begin(&task);
+  for (int t = 0; t < ntests; t++)
+    summarize(values[t], par, t, row);
+  man.set("instance", in.value(), files_digest(outputs));
+  if (!man.save(dir + "/manifest.txt"))
+    {
+      fprintf(stderr, "Couldn't open %s for writing\n", (dir + "/manifest.txt").c_str());
+      exit(1);
+    }
+  trace_task_end(&inst, &task);
+  trace_end(&inst, p.c_str(), NULL, npoints);
+}
+
+static void write_comparative(const string &root, const vector<string> &instances,
+			      const vector<table_row> &rows)
+{
+  // the columns of build_comparative_table.py: the instance, the means of
+  // each indicator for every algorithm and the three tests; the binary
+  // file also has the overall p-values of the tests
+  static const char *prefix[ntests] = {"HV_", "EPS_", "IGD_"};
+  static const char *upper[ntests] = {"HV", "EPS", "IGD"};
+  vector<table_column> columns;
+  table_column c;
+
+  c.name = "Instance";
+  c.text = true;
+  c.format = NULL;
+  c.strings = instances;
+  columns.push_back(c);
+  c.text = false;
+  c.format = "%.4f";
+  c.strings.clear();
+  for (int t = 0; t < ntests; t++)
+    for (int a = 0; a < nalgs; a++)
+      {
+	c.name = prefix[t] + algorithms[a].label;
+	c.numbers.clear();
+	for (size_t k = 0; k < rows.size(); k++)
+	  c.numbers.push_back(rows[k].mean[t][a]);
+	columns.push_back(c);
+      }
+  c.text = true;
+  c.format = NULL;
+  c.numbers.clear();
+  for (int t = 0; t < ntests; t++)
+    {
+      c.name = string("Kruskal Wallis Test (") + upper[t] + ")";
+      c.strings.clear();
+      for (size_t k = 0; k < rows.size(); k++)
+	c.strings.push_back(rows[k].kruskal[t]);
+      columns.push_back(c);
+    }
+  string path = root + "/comparative_results.csv";
+  if (!write_csv(path, columns))
+    {
+      fprintf(stderr, "Couldn't open %s for writing\n", path.c_str());
+      exit(1);
+    }
+
+  c.text = false;
+  c.format = "%.9e";
+  c.strings.clear();
+  for (int t = 0; t < ntests; t++)
+    {
+      c.name = string("Kruskal Wallis p-value (") + upper[t] + ")";
+      c.numbers.clear();
+      for (size_t k = 0; k < rows.size(); k++)
+	c.numbers.push_back(rows[k].p_value[t]);
+      columns.push_back(c);
+    }
+  path = root + "/comparative_results.bin";
+  if (!write_columns(path, columns))
+    {
+      fprintf(stderr, "Couldn't open %s for writing\n", path.c_str());
+      exit(1);
+    }
+}
+
+// Sharded execution (--spec, --shard, --merge). A job spec assigns every
+// cell of the analysis, i.e. the runs of one algorithm for one instance, to
+// a shard; every shard can run on another host, with the project root on a
+// shared file system or copied between the steps. The analysis then takes
+// four steps, each over all shards before the next one starts:
+//
+//   --shard <id> fronts       the bound and the front of every cell of the
+//                             shard, from its runs
+//   --merge fronts            bound.out and reference_set.out of every
+//                             instance, from the partial results above
+//   --shard <id> indicators   the indicators of every run of the cells of
+//                             the shard, with the merged bound and
+//                             reference set
+//   --merge indicators        the value files, the Kruskal-Wallis tests,
+//                             indicators.out and the comparative table
+//
+// Only the first and third steps read the runs. The partial results are
+// written below <root_dir>/shards/<instance>/ (see write_partial()); the
+// merged files are the ones sts-pipeline writes for the whole campaign on
+// a single host, bit for bit. A bound is the best and worst value of every
+// objective, which merge in the order of the algorithms as bound.cc
+// reduces all points; the front of a cell is reduced by filter_earlier()
+// (nondominated.h) in the senses the objectives have once normalized, so
+// that the reference set of the merged, normalized fronts is the one of
+// all normalized points.
+
+static vector<string> spec_instances;          // in the order of the spec
+static vector<vector<string> > spec_owner;     // [instance][algorithm]: shard
+
+static void read_spec(const string &path)
+{
+  // the job spec: comment lines start with #, the other lines are
+  //
+  //   shard <id> <instance> [<name> ...]
+  //
+  // which assign the cells of the algorithms named (all algorithms if none
+  // is named) for the instance to shard <id>; every cell of an instance
+  // that is given has to be assigned exactly once
+  char line[MAX_LINE_LENGTH], key[MAX_STR_LENGTH], id[MAX_STR_LENGTH],
+    inst[MAX_STR_LENGTH], name[MAX_STR_LENGTH];
+  FILE *fp = fopen(path.c_str(), "rb");
+  int k, len;
+
+  if (fp == NULL)
+    {
+      fprintf(stderr, "Couldn't open job spec %s\n", path.c_str());
+      exit(1);
+    }
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+      if (sscanf(line, "%255s", key) != 1 || key[0] == '#')
+	continue;
+      error(strcmp(key, "shard") != 0, "error in job spec");
+      error(sscanf(line, "%*s %255s %255s%n", id, inst, &len) != 2, "error in job spec");
+      for (k = 0; k < (int)spec_instances.size() && spec_instances[k] != inst; k++);
+      if (k == (int)spec_instances.size())
+	{
+	  spec_instances.push_back(inst);
+	  spec_owner.push_back(vector<string>(nalgs));
+	}
+      vector<int> cells;
+      for (char *s = line + len; sscanf(s, "%255s%n", name, &len) == 1; s += len)
+	{
+	  int a;
+	  for (a = 0; a < nalgs && algorithms[a].name != name; a++);
+	  if (a == nalgs)
+	    {
+	      fprintf(stderr, "Algorithm %s of the job spec is not in the algorithm file\n", name);
+	      exit(1);
+	    }
+	  cells.push_back(a);
+	}
+      if (cells.empty())
+	for (int a = 0; a < nalgs; a++)
+	  cells.push_back(a);
+      for (size_t c = 0; c < cells.size(); c++)
+	{
+	  if (!spec_owner[k][cells[c]].empty())
+	    {
+	      fprintf(stderr, "%s of instance %s is assigned twice in the job spec\n",
+		      algorithms[cells[c]].name.c_str(), inst);
+	      exit(1);
+	    }
+	  spec_owner[k][cells[c]] = id;
+	}
+    }
+  fclose(fp);
+  error(spec_instances.empty(), "the job spec assigns no instance");
+  for (size_t i = 0; i < spec_instances.size(); i++)
+    for (int a = 0; a < nalgs; a++)
+      if (spec_owner[i][a].empty())
+	{
+	  fprintf(stderr, "%s of instance %s is not assigned in the job spec\n",
+		  algorithms[a].name.c_str(), spec_instances[i].c_str());
+	  exit(1);
+	}
+}
+
+static string partial_file(const string &root, const string &p, int a, const char *ext)
+{
+  return root + "/shards/" + p + "/" + algorithms[a].name + ext;
+}
+
+static digest cell_config(const params &par, int a)
+{
+  // the parameters that decide the partial results of algorithm a; the
+  // executable is left out, so that the hosts may build it on their own
+  hasher h;
+  h.update(par.bound_digest);
+  h.update(par.normalize_digest);
+  h.update(par.filter_digest);
+  h.update(par.hyp_digest);
+  h.update(par.eps_digest);
+  h.update(algorithms[a].dir);
+  h.update(algorithms[a].name);
+  h.update(algorithms[a].runs);
+  return h.value();
+}
+
+static digest runs_digest(const vector<string> &files)
+{
+  // the names and contents of the run files of a cell
+  hasher h;
+  for (size_t r = 0; r < files.size(); r++)
+    {
+      h.update(files[r]);
+      h.update(file_digest(files[r]));
+    }
+  return h.value();
+}
+
+static digest reference_digest(const string &dir)
+{
+  hasher h;
+  h.update(file_digest(dir + "/utils/bound.out"));
+  h.update(file_digest(dir + "/reference_set.out"));
+  return h.value();
+}
+
+// A partial result is a text file of lines "<key> <value>", starting with
+// "sts-pipeline <step> 1" (the version of the format); the values of
+// several lines may share a key. Numbers are written with "%a", so that
+// they are read back exactly, and digests as in the manifests.
+struct partial
+{
+  string path;
+  vector<pair<string, string> > lines;
+
+  const string &get(const char *key) const;
+  vector<string> all(const char *key) const;
+};
+
+const string &partial::get(const char *key) const
+{
+  for (size_t i = 0; i < lines.size(); i++)
+    if (lines[i].first == key)
+      return lines[i].second;
+  fprintf(stderr, "No %s in %s\n", key, path.c_str());
+  exit(1);
+}
+
+vector<string> partial::all(const char *key) const
+{
+  vector<string> v;
+  for (size_t i = 0; i < lines.size(); i++)
+    if (lines[i].first == key)
+      v.push_back(lines[i].second);
+  return v;
+}
+
+static void write_partial(const string &path, const partial &q)
+{
+  FILE *fp = open_output(path + ".tmp", "wb");
+  for (size_t i = 0; i < q.lines.size(); i++)
+    fprintf(fp, "%s %s\n", q.lines[i].first.c_str(), q.lines[i].second.c_str());
+  // the file appears complete or not at all, as other hosts may read it
+  if (fclose(fp) != 0 || rename((path + ".tmp").c_str(), path.c_str()) != 0)
+    {
+      fprintf(stderr, "Couldn't open %s for writing\n", path.c_str());
+      exit(1);
+    }
+}
+
+static void read_partial(const string &path, const char *step, const string &id,
+			 const string &p, int a, const params &par, partial *q)
+{
+  // reads a partial result of algorithm a for instance p and checks that
+  // it was made for them, in the current format and with the current
+  // parameters
+  char line[MAX_LINE_LENGTH];
+  FILE *fp = fopen(path.c_str(), "rb");
+
+  if (fp == NULL)
+    {
+      fprintf(stderr, "Couldn't open %s; has the %s step of shard %s been run?\n",
+	      path.c_str(), step, id.c_str());
+      exit(1);
+    }
+  q->path = path;
+  q->lines.clear();
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+      string s(line);
+      while (!s.empty() && (s[s.size()-1] == '\n' || s[s.size()-1] == '\r'))
+	s.erase(s.size()-1);
+      size_t k = s.find(' ');
+      q->lines.push_back(make_pair(s.substr(0, k), k == string::npos ? "" : s.substr(k+1)));
+    }
+  fclose(fp);
+  char config[32];
+  snprintf(config, sizeof(config), "%016llx", cell_config(par, a));
+  if (q->lines.empty() || q->lines[0].first != "sts-pipeline"
+      || q->lines[0].second != string(step) + " 1"
+      || q->get("instance") != p || q->get("algorithm") != algorithms[a].name)
+    {
+      fprintf(stderr, "%s is not a partial result of sts-pipeline\n", path.c_str());
+      exit(1);
+    }
+  if (q->get("config") != config)
+    {
+      fprintf(stderr, "%s was made with other parameters or another algorithm file\n", path.c_str());
+      exit(1);
+    }
+}
+
+static string hex(digest d)
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%016llx", d);
+  return buf;
+}
+
+static string hex_values(const double *v, int n)
+{
+  char buf[64];
+  string s;
+  for (int i = 0; i < n; i++)
+    {
+      snprintf(buf, sizeof(buf), i > 0 ? " %a" : "%a", v[i]);
+      s += buf;
+    }
+  return s;
+}
+
+static void parse_values(const partial &q, const string &s, double *v, int n)
+{
+  const char *c = s.c_str();
+  char *end;
+  for (int i = 0; i < n; i++, c = end)
+    {
+      v[i] = strtod(c, &end);
+      if (end == c)
+	{
+	  fprintf(stderr, "error in %s\n", q.path.c_str());
+	  exit(1);
+	}
+    }
+}
+
+static void partial_header(partial *q, const char *step, const string &p, int a,
+			   const string &id, const params &par, digest runs)
+{
+  q->lines.clear();
+  q->lines.push_back(make_pair(string("sts-pipeline"), string(step) + " 1"));
+  q->lines.push_back(make_pair(string("instance"), p));
+  q->lines.push_back(make_pair(string("algorithm"), algorithms[a].name));
+  q->lines.push_back(make_pair(string("shard"), id));
+  q->lines.push_back(make_pair(string("config"), hex(cell_config(par, a))));
+  q->lines.push_back(make_pair(string("runs"), hex(runs)));
+}
+
+static vector<pair<int, int> > shard_cells(const string &id)
+{
+  // the cells of shard id, as (instance, algorithm) in the order of the spec
+  vector<pair<int, int> > cells;
+  for (size_t i = 0; i < spec_instances.size(); i++)
+    for (int a = 0; a < nalgs; a++)
+      if (spec_owner[i][a] == id)
+	cells.push_back(make_pair((int)i, a));
+  if (cells.empty())
+    {
+      fprintf(stderr, "Shard %s has no cells in the job spec\n", id.c_str());
+      exit(1);
+    }
+  return cells;
+}
+
+static vector<string> cell_runs(const string &root, const string &p, int a)
+{
+  vector<string> files = run_files(root, a, p);
+  if (files.empty())
+    {
+      fprintf(stderr, "No run files of %s for instance %s\n", algorithms[a].name.c_str(), p.c_str());
+      exit(1);
+    }
+  return files;
+}
+
+static void shard_fronts(pool &workers, const string &root, const params &par,
+			 const string &id)
+{
+  // writes <name>.fronts, holding the bound of the runs of the cell, and
+  // <name>_front.bin, the points filter_earlier() leaves of them in the
+  // format of reader.h, for every cell of the shard
+  int n = par.nobjs;
+  vector<pair<int, int> > cells = shard_cells(id);
+  vector<long long> npoints(cells.size());
+  trace_span span;
+
+  // the senses of filter on the normalized objectives, in terms of the
+  // objectives before normalize, which may reverse them
+  scale_map m;
+  vector<double> lo(n, 0.0), hi(n, 1.0);
+  vector<int> senses(n);
+  scale_setup(&m, n, par.minmax1.data(), par.unify, lo.data(), hi.data());
+  for (int k = 0; k < n; k++)
+    senses[k] = m.reverse[k] != 0 ? -par.filter_minmax1[k] : par.filter_minmax1[k];
+
+  trace_begin_tasks(&span, "shard_fronts", NULL);
+  workers.parallel_for((int)cells.size(), [&](int c) {
+      const string &p = spec_instances[cells[c].first];
+      int a = cells[c].second;
+      trace_usage task;
+      trace_task_begin(&task);
+      fprintf(stdout, "- [RUNNING] sts-pipeline shard %s: fronts of %s for instance %s\n",
+	      id.c_str(), algorithms[a].name.c_str(), p.c_str());
+      vector<string> files = cell_runs(root, p, a);
+      pointset f, front;
+      read_front(files, n, &f);
+      npoints[c] = f.npoints();
+
+      vector<double> best(f.point(0), f.point(0) + n), worst(best);
+      bound_points(f, par, best.data(), worst.data());
+      vector<const double *> all(f.npoints());
+      for (int i = 0; i < f.npoints(); i++)
+	all[i] = f.point(i);
+      bool *dominated = new bool[all.size()+1];
+      filter_earlier(all.data(), (int)all.size(), n, senses.data(), dominated);
+      front.clear(n);
+      for (size_t i = 0; i < all.size(); i++)
+	if (!dominated[i])
+	  front.append(all[i], front.npoints() == 0);
+      delete [] dominated;
+
+      partial q;
+      char buf[64];
+      partial_header(&q, "fronts", p, a, id, par, runs_digest(files));
+      snprintf(buf, sizeof(buf), "%d", f.nruns());
+      q.lines.push_back(make_pair(string("nruns"), string(buf)));
+      snprintf(buf, sizeof(buf), "%d", f.npoints());
+      q.lines.push_back(make_pair(string("npoints"), string(buf)));
+      q.lines.push_back(make_pair(string("best"), hex_values(best.data(), n)));
+      q.lines.push_back(make_pair(string("worst"), hex_values(worst.data(), n)));
+      snprintf(buf, sizeof(buf), "%d", front.npoints());
+      q.lines.push_back(make_pair(string("front"), string(buf)));
+      make_dirs(root + "/shards/" + p);
+      string bin = partial_file(root, p, a, "_front.bin");
+      if (!write_pointset((bin + ".tmp").c_str(), front, senses.data())
+	  || rename((bin + ".tmp").c_str(), bin.c_str()) != 0)
+	{
+	  fprintf(stderr, "Couldn't open %s for writing\n", bin.c_str());
+	  exit(1);
+	}
+      q.lines.push_back(make_pair(string("front_digest"), hex(file_digest(bin))));
+      write_partial(partial_file(root, p, a, ".fronts"), q);
+      trace_task_end(&span, &task);
+    });
+  long long total = 0;
+  for (size_t c = 0; c < cells.size(); c++)
+    total += npoints[c];
+  trace_end(&span, id.c_str(), NULL, total);
+}
+
+static void merge_fronts(pool &workers, const string &root, const params &par)
+{
+  // bound.out and reference_set.out of every instance of the spec: the
+  // bounds of the cells merged in the order of the algorithms, then the
+  // fronts of the cells normalized with the merged bound and filtered as
+  // the blocks of filter_merge()
+  int n = par.nobjs;
+  trace_span span;
+
+  trace_begin_tasks(&span, "merge_fronts", NULL);
+  workers.parallel_for((int)spec_instances.size(), [&](int k) {
+      const string &p = spec_instances[k];
+      string dir = root + "/analysis/" + p;
+      vector<pointset> fronts(nalgs);
+      vector<double> best(n), worst(n), b(n), w(n), lbound(n), ubound(n);
+      pointset ref;
+      trace_usage task;
+      trace_task_begin(&task);
+      fprintf(stdout, "- [RUNNING] sts-pipeline merge: fronts of instance %s\n", p.c_str());
+      for (int a = 0; a < nalgs; a++)
+	{
+	  partial q;
+	  read_partial(partial_file(root, p, a, ".fronts"), "fronts", spec_owner[k][a], p, a, par, &q);
+	  parse_values(q, q.get("best"), b.data(), n);
+	  parse_values(q, q.get("worst"), w.data(), n);
+	  for (int i = 0; i < n; i++)
+	    if (a == 0)
+	      {
+		best[i] = b[i];
+		worst[i] = w[i];
+	      }
+	    else
+	      {
+		// the first of equal values is kept, as in bound_points()
+		if (b[i]*par.minmax1[i] > best[i]*par.minmax1[i])
+		  best[i] = b[i];
+		if (w[i]*par.minmax1[i] < worst[i]*par.minmax1[i])
+		  worst[i] = w[i];
+	      }
+	  string bin = partial_file(root, p, a, "_front.bin");
+	  if (hex(file_digest(bin)) != q.get("front_digest")
+	      || !read_pointset(bin.c_str(), n, false, &fronts[a])
+	      || fronts[a].npoints() != atoi(q.get("front").c_str()))
+	    {
+	      fprintf(stderr, "%s does not match %s\n", bin.c_str(), q.path.c_str());
+	      exit(1);
+	    }
+	}
+      make_dirs(dir + "/utils");
+      write_bound(dir + "/utils/bound.out", par, best.data(), worst.data(), lbound.data(), ubound.data());
+
+      scale_map scale;
+      scale_setup(&scale, n, par.minmax1.data(), par.unify, lbound.data(), ubound.data());
+      vector<const double *> all;
+      vector<int> start(1, 0);
+      for (int a = 0; a < nalgs; a++)
+	{
+	  normalize_stage(&fronts[a], scale);
+	  for (int i = 0; i < fronts[a].npoints(); i++)
+	    all.push_back(fronts[a].point(i));
+	  start.push_back((int)all.size());
+	}
+      bool *dominated = new bool[all.size()+1];
+      filter_merge(all.data(), start.data(), nalgs, n, par.filter_minmax1.data(), dominated,
+		   [&](int m, const function<void(int)> &f) { workers.parallel_for(m, f); });
+      ref.clear(n);
+      for (size_t i = 0; i < all.size(); i++)
+	if (!dominated[i])
+	  ref.append(all[i], false);
+      delete [] dominated;
+      error(ref.npoints() < 1, "error in reference set file");
+      write_reference(dir + "/reference_set.out", ref);
+      trace_task_end(&span, &task);
+    });
+  trace_end(&span, NULL, NULL, 0);
+}
+
+static void read_bound(const string &path, int n, double *lbound, double *ubound)
+{
+  // reads back bound.out as normalize does
+  FILE *fp = fopen(path.c_str(), "rb");
+  bool ok = fp != NULL && fscanf(fp, "%*s") == 0;
+  for (int i = 0; ok && i < n; i++)
+    ok = fscanf(fp, "%lf", &lbound[i]) == 1;
+  ok = ok && fscanf(fp, "%*s") == 0;
+  for (int i = 0; ok && i < n; i++)
+    ok = fscanf(fp, "%lf", &ubound[i]) == 1;
+  if (fp != NULL)
+    fclose(fp);
+  if (!ok)
+    {
+      fprintf(stderr, "Couldn't read %s; has the fronts step been merged?\n", path.c_str());
+      exit(1);
+    }
+}
+
+static void shard_indicators(pool &workers, const string &root, const params &par,
+			     const string &id)
+{
+  // writes <name>.indicators, the indicators of every run of the cell with
+  // the merged bound and reference set, for every cell of the shard
+  int n = par.nobjs;
+  vector<pair<int, int> > cells = shard_cells(id);
+  vector<pointset> refs(spec_instances.size());
+  vector<scale_map> scales(spec_instances.size());
+  vector<double> ref_set_value(spec_instances.size(), 0.0);
+  vector<long long> npoints(cells.size());
+  static const char *ind_stage[ntests] = {"hypervolume", "epsilon", "igd"};
+  trace_span span, ind_span[ntests];
+
+  trace_begin_tasks(&span, "shard_indicators", NULL);
+  for (int t = 0; t < ntests; t++)
+    trace_begin_tasks(&ind_span[t], ind_stage[t], &span);
+  for (size_t c = 0; c < cells.size(); c++)
+    {
+      int k = cells[c].first;
+      if (refs[k].nobjs != 0)
+	continue;
+      string dir = root + "/analysis/" + spec_instances[k];
+      vector<double> lbound(n), ubound(n);
+      trace_usage task;
+      trace_task_begin(&task);
+      read_bound(dir + "/utils/bound.out", n, lbound.data(), ubound.data());
+      scale_setup(&scales[k], n, par.minmax1.data(), par.unify, lbound.data(), ubound.data());
+      if (!read_pointset((dir + "/reference_set.out").c_str(), n, false, &refs[k])
+	  || refs[k].npoints() < 1)
+	{
+	  fprintf(stderr, "Couldn't read %s/reference_set.out; has the fronts step been merged?\n",
+		  dir.c_str());
+	  exit(1);
+	}
+      if (par.hyp_method == 1)
+	{
+	  vector<double> tmp(refs[k].o);
+	  ref_set_value[k] = hv_ind_value(tmp.data(), refs[k].npoints(), n, par.obj.data(),
+					  par.nadir.data());
+	}
+      trace_task_end(&ind_span[0], &task);
+    }
+
+  workers.parallel_for((int)cells.size(), [&](int c) {
+      int k = cells[c].first, a = cells[c].second;
+      const string &p = spec_instances[k];
+      trace_usage task;
+      trace_task_begin(&task);
+      fprintf(stdout, "- [RUNNING] sts-pipeline shard %s: indicators of %s for instance %s\n",
+	      id.c_str(), algorithms[a].name.c_str(), p.c_str());
+      vector<string> files = cell_runs(root, p, a);
+      pointset f;
+      read_front(files, n, &f);
+      normalize_stage(&f, scales[k]);
+      npoints[c] = f.npoints();
+      trace_task_end(&span, &task);
+
+      vector<double> hv(f.nruns()), eps(f.nruns()), igd(f.nruns());
+      workers.parallel_for(f.nruns(), [&](int r) {
+	  run_indicators(f, r, par, refs[k], ref_set_value[k], &hv[r], &eps[r], &igd[r], ind_span);
+	});
+
+      trace_task_begin(&task);
+      partial q;
+      partial_header(&q, "indicators", p, a, id, par, runs_digest(files));
+      q.lines.push_back(make_pair(string("reference"), hex(reference_digest(root + "/analysis/" + p))));
+      for (int r = 0; r < f.nruns(); r++)
+	{
+	  double v[ntests] = {hv[r], eps[r], igd[r]};
+	  q.lines.push_back(make_pair(string("value"), hex_values(v, ntests)));
+	}
+      write_partial(partial_file(root, p, a, ".indicators"), q);
+      trace_task_end(&span, &task);
+    });
+  long long total = 0;
+  for (size_t c = 0; c < cells.size(); c++)
+    total += npoints[c];
+  for (int t = 0; t < ntests; t++)
+    trace_end(&ind_span[t], id.c_str(), NULL, total);
+  trace_end(&span, id.c_str(), NULL, total);
+}
+
+static void merge_indicators(pool &workers, const string &root, const params &par)
+{
+  // the value files, indicators.out and the Kruskal-Wallis tests of every
+  // instance of the spec, and the comparative table of all of them, from
+  // the partial results of the indicators step
+  vector<table_row> rows(spec_instances.size());
+  instance_log empty = {{NULL, NULL, NULL}, {0, 0, 0}, false};
+  trace_span span;
+
+  make_dirs(root + "/logs");
+  logs.assign(spec_instances.size(), empty);
+  trace_begin_tasks(&span, "merge_indicators", NULL);
+  workers.parallel_for((int)spec_instances.size(), [&](int k) {
+      const string &p = spec_instances[k];
+      string dir = root + "/analysis/" + p;
+      vector<vector<double> > hv(nalgs), eps(nalgs), igd(nalgs);
+      vector<double> *values[ntests] = {hv.data(), eps.data(), igd.data()};
+      trace_usage task;
+      trace_task_begin(&task);
+      fprintf(stdout, "- [RUNNING] sts-pipeline merge: indicators of instance %s\n", p.c_str());
+      string reference = hex(reference_digest(dir));
+      for (int a = 0; a < nalgs; a++)
+	{
+	  partial q, fq;
+	  read_partial(partial_file(root, p, a, ".fronts"), "fronts", spec_owner[k][a], p, a, par, &fq);
+	  read_partial(partial_file(root, p, a, ".indicators"), "indicators", spec_owner[k][a], p, a,
+		       par, &q);
+	  if (q.get("reference") != reference || q.get("runs") != fq.get("runs"))
+	    {
+	      fprintf(stderr, "%s was made from other runs, bound or reference set than the ones merged\n",
+		      q.path.c_str());
+	      exit(1);
+	    }
+	  vector<string> v = q.all("value");
+	  error((int)v.size() != atoi(fq.get("nruns").c_str()), "the indicators of a cell miss some runs");
+	  for (size_t r = 0; r < v.size(); r++)
+	    {
+	      double x[ntests];
+	      parse_values(q, v[r], x, ntests);
+	      for (int t = 0; t < ntests; t++)
+		values[t][a].push_back(x[t]);
+	    }
+	}
+      make_dirs(dir + "/epsilon_additive");
+      make_dirs(dir + "/hypervolume");
+      make_dirs(dir + "/igd");
+      make_dirs(dir + "/kruskal");
+      for (int a = 0; a < nalgs; a++)
+	{
+	  for (int t = 0; t < ntests; t++)
+	    write_values(value_file(dir, t, a), values[t][a], t == 2);
+	  // kruskal-wallis reads the values back from the files written above
+	  for (size_t r = 0; r < hv[a].size(); r++)
+	    {
+	      hv[a][r] = as_text(hv[a][r]);
+	      eps[a][r] = as_text(eps[a][r]);
+	    }
+	}
+      write_table(dir + "/indicators.out", hv.data(), eps.data(), igd.data());
+      for (int t = 0; t < ntests; t++)
+	{
+	  FILE *log = open_memstream(&logs[k].text[t], &logs[k].len[t]);
+	  error(log == NULL, "memory overflow");
+	  kruskal_stage(values[t], par, dir + "/kruskal/" + tests[t] + "_saidakruskal.out", log);
+	  fclose(log);
+	  summarize(values[t], par, t, &rows[k]);
+	}
+      trace_task_end(&span, &task);
+      flush_logs(root, k);
+    });
+  trace_end(&span, NULL, NULL, 0);
+  write_comparative(root, spec_instances, rows);
+}
+
+int main(int argc, char **argv)
+{
+  params par;
+  string algorithm_file, spec_file, shard;
+  bool merge = false;
+  int jobs = 1;
+  int i = 1;
+
+  for (;;)
+    if (i+1 < argc && (strcmp(argv[i], "--jobs") == 0 || strcmp(argv[i], "-j") == 0))
+      {
+	jobs = atoi(argv[i+1]);
+	error(jobs < 1, "the number of jobs must be at least 1");
+	i += 2;
+      }
+    else if (i < argc && strcmp(argv[i], "--force") == 0)
+      {
+	force = true;
+	i++;
+      }
+    else if (i+1 < argc && strcmp(argv[i], "--algorithms") == 0)
+      {
+	algorithm_file = argv[i+1];
+	i += 2;
+      }
+    else if (i < argc && strcmp(argv[i], "--keep-intermediate") == 0)
+      {
+	keep_intermediate = true;
+	i++;
+      }
+    else if (i < argc && strcmp(argv[i], "--curves") == 0)
+      {
+	curves = true;
+	i++;
+      }
+    else if (i < argc && strcmp(argv[i], "--cumulative-curves") == 0)
+      {
+	curves = cumulative_curves = true;
+	i++;
+      }
+    else if (i+1 < argc && strcmp(argv[i], "--spec") == 0)
+      {
+	spec_file = argv[i+1];
+	i += 2;
+      }
+    else if (i+1 < argc && strcmp(argv[i], "--shard") == 0)
+      {
+	shard = argv[i+1];
+	i += 2;
+      }
+    else if (i < argc && strcmp(argv[i], "--merge") == 0)
+      {
+	merge = true;
+	i++;
+      }
+    else
+      break;
+  if (!spec_file.empty() || !shard.empty() || merge)
+    {
+      error(spec_file.empty() || shard.empty() == !merge || argc-i != 2
+	    || (strcmp(argv[i], "fronts") != 0 && strcmp(argv[i], "indicators") != 0),
+	    "./sts-pipeline [--jobs <n>] [--algorithms <file>] --spec <file> (--shard <id> | --merge) (fronts | indicators) <root_dir>");
+      error(keep_intermediate || curves, "--keep-intermediate and --curves are not available with --spec");
+      bool fronts = strcmp(argv[i], "fronts") == 0;
+      string root = argv[i+1];
+      read_params(root + "/src", &par);
+      read_algorithms(algorithm_file.empty() ? root + "/src/algorithms.txt" : algorithm_file);
+      read_spec(spec_file);
+      pool workers(jobs);
+      if (merge)
+	(fronts ? merge_fronts : merge_indicators)(workers, root, par);
+      else
+	(fronts ? shard_fronts : shard_indicators)(workers, root, par, shard);
+      return 0;
+    }
+  error(argc-i < 2, "./sts-pipeline [--jobs <n>] [--algorithms <file>] [--force] [--keep-intermediate] [--curves | --cumulative-curves] <root_dir> <instance> [<instance> ...]");
+
+  string root = argv[i++];
+  vector<string> instances(argv+i, argv+argc);
+  read_params(root + "/src", &par);
+  read_algorithms(algorithm_file.empty() ? root + "/src/algorithms.txt" : algorithm_file);
+  par.tool_digest = file_digest("/proc/self/exe");
+  make_dirs(root + "/logs");
+  make_dirs(root + "/analysis");
+
+  instance_log empty = {{NULL, NULL, NULL}, {0, 0, 0}, false};
+  logs.assign(instances.size(), empty);
+  vector<table_row> rows(instances.size());
+  pool workers(jobs);
+  workers.parallel_for((int)instances.size(), [&](int k) {
+      run_instance(workers, root, instances[k], par, &logs[k], &rows[k]);
+      flush_logs(root, k);
+    });
+
+  write_comparative(root, instances, rows);
+  return 0;
+}
@@ -0,0 +1,151 @@
+/* table.cc
+
+The comparative table of sts-pipeline, see table.h.
+
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "table.h"
+
+using namespace std;
+
+static double pairwise_sum(const double *v, size_t n)
+{
+  // numpy's pairwise_sum(): blocks of up to 128 values are added with 8
+  // partial sums, longer runs are split in two halves
+  if (n < 8)
+    {
+      double s = 0.0;
+      for (size_t i = 0; i < n; i++)
+	s += v[i];
+      return s;
+    }
+  if (n <= 128)
+    {
+      double r[8], s;
+      size_t i;
+      for (int j = 0; j < 8; j++)
+	r[j] = v[j];
+      for (i = 8; i < n - n%8; i += 8)
+	for (int j = 0; j < 8; j++)
+	  r[j] += v[i+j];
+      s = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]));
+      for (; i < n; i++)
+	s += v[i];
+      return s;
+    }
+  size_t half = n/2;
+  half -= half%8;
+  return pairwise_sum(v, half) + pairwise_sum(v + half, n - half);
+}
+
+double table_mean(const double *v, size_t n)
+{
+  if (n == 0)
+    return NAN;
+  return pairwise_sum(v, n)/(double)n;
+}
+
+static void write_field(FILE *fp, const string &s)
+{
+  // quoted only if needed, as Python's csv module does it
+  if (s.find_first_of(",\"\r\n") == string::npos)
+    {
+      fputs(s.c_str(), fp);
+      return;
+    }
+  fputc('"', fp);
+  for (size_t i = 0; i < s.size(); i++)
+    {
+      if (s[i] == '"')
+	fputc('"', fp);
+      fputc(s[i], fp);
+    }
+  fputc('"', fp);
+}
+
+bool write_csv(const string &path, const vector<table_column> &columns)
+{
+  FILE *fp = fopen(path.c_str(), "w");
+  size_t rows = columns.empty() ? 0 : columns[0].text ? columns[0].strings.size()
+    : columns[0].numbers.size();
+  char buf[64];
+
+  if (fp == NULL)
+    return false;
+  for (size_t c = 0; c < columns.size(); c++)
+    {
+      if (c > 0)
+	fputc(',', fp);
+      write_field(fp, columns[c].name);
+    }
+  fputc('\n', fp);
+  for (size_t r = 0; r < rows; r++)
+    {
+      for (size_t c = 0; c < columns.size(); c++)
+	{
+	  if (c > 0)
+	    fputc(',', fp);
+	  if (columns[c].text)
+	    write_field(fp, columns[c].strings[r]);
+	  else
+	    {
+	      snprintf(buf, sizeof(buf), columns[c].format, columns[c].numbers[r]);
+	      write_field(fp, buf);
+	    }
+	}
+      fputc('\n', fp);
+    }
+  return fclose(fp) == 0;
+}
+
+static void pad(FILE *fp, size_t n)
+{
+  static const char zeros[8] = {0};
+  if (n%8 != 0)
+    fwrite(zeros, 1, 8 - n%8, fp);
+}
+
+bool write_columns(const string &path, const vector<table_column> &columns)
+{
+  FILE *fp = fopen(path.c_str(), "wb");
+  uint32_t version = 1, ncols = (uint32_t)columns.size();
+  uint64_t rows = columns.empty() ? 0 : columns[0].text ? columns[0].strings.size()
+    : columns[0].numbers.size();
+
+  if (fp == NULL)
+    return false;
+  fwrite("STSTABLE", 1, 8, fp);
+  fwrite(&version, sizeof(version), 1, fp);
+  fwrite(&ncols, sizeof(ncols), 1, fp);
+  fwrite(&rows, sizeof(rows), 1, fp);
+  for (size_t c = 0; c < columns.size(); c++)
+    {
+      uint32_t head[2] = {columns[c].text ? 1u : 0u, (uint32_t)columns[c].name.size()};
+      fwrite(head, sizeof(head), 1, fp);
+      fwrite(columns[c].name.data(), 1, columns[c].name.size(), fp);
+      pad(fp, columns[c].name.size());
+    }
+  for (size_t c = 0; c < columns.size(); c++)
+    {
+      const table_column &col = columns[c];
+      if (!col.text)
+	{
+	  fwrite(col.numbers.data(), sizeof(double), rows, fp);
+	  continue;
+	}
+      uint64_t end = 0;
+      for (size_t r = 0; r < rows; r++)
+	{
+	  end += col.strings[r].size();
+	  fwrite(&end, sizeof(end), 1, fp);
+	}
+      for (size_t r = 0; r < rows; r++)
+	fwrite(col.strings[r].data(), 1, col.strings[r].size(), fp);
+      pad(fp, end);
+    }
+  bool ok = !ferror(fp);
+  return fclose(fp) == 0 && ok;
+}
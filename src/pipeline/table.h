@@ -0,0 +1,59 @@
+/* table.h
+
+The comparative table of sts-pipeline: one row per instance, with the mean
+of every indicator for every algorithm and the outcome of the
+Kruskal-Wallis tests, taken from the values in memory. It is written in
+two formats:
+
+   comparative_results.csv   the table build_comparative_table.py makes
+                             from the files of the tools, with the numbers
+                             in the printf format of their column
+   comparative_results.bin   the same columns, the numbers as doubles
+
+The binary file stores the table column by column, in host byte order and
+with every section starting at a multiple of 8 bytes, as the binary point
+files of reader.h:
+
+   char      magic[8]             "STSTABLE"
+   uint32    version              1
+   uint32    no_columns
+   uint64    no_rows
+   then for every column:
+     uint32  type                 0 = double, 1 = string
+     uint32  name_length
+     char    name[name_length]    padded with zeros to a multiple of 8 bytes
+   then for every column, in the same order:
+     double  value[no_rows]                     (type 0)
+     uint64  end[no_rows]                       (type 1) string r is
+     char    text[end[no_rows-1]]               text[end[r-1]..end[r]-1],
+                                                padded to a multiple of 8
+
+so that a single column can be read without looking at the others.
+
+*/
+
+#ifndef TABLE_H
+#define TABLE_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+struct table_column
+{
+  std::string name;
+  bool text;                         // strings instead of numbers
+  const char *format;                // of the numbers in the CSV
+  std::vector<double> numbers;       // one per row, unless text
+  std::vector<std::string> strings;  // one per row, if text
+};
+
+// the mean of the n values in v as numpy.mean() computes it, i.e. their
+// pairwise sum divided by n; NaN if n is 0
+double table_mean(const double *v, size_t n);
+
+// write the table; return false if path cannot be written
+bool write_csv(const std::string &path, const std::vector<table_column> &columns);
+bool write_columns(const std::string &path, const std::vector<table_column> &columns);
+
+#endif
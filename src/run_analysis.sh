@@ -8,7 +8,31 @@
 ## Primeiro objetivo é o custo (min), e o segundo objetivo é a potência (max)
 
 ROOT_DIR=$(dirname "$PWD")
-PYTHON_CMD="python3"
+
+# LEGACY_CHAIN=1 executa as ferramentas separadas (bound, normalize, filter,
+# hyp_ind, eps_ind, igd, kruskal-wallis) para cada instância
+LEGACY_CHAIN=${LEGACY_CHAIN:-0}
+
+# Número de threads do sts-pipeline (padrão: todos os núcleos)
+JOBS=${JOBS:-$(nproc 2>/dev/null || echo 1)}
+
+# Algoritmos comparados pelo sts-pipeline e onde estão suas execuções (a cadeia
+# LEGACY_CHAIN=1 compara sempre MOEAD, COMOLSD e NSGA2 com as execuções 1 a 20)
+ALGORITHMS_FILE=${ALGORITHMS_FILE:-$ROOT_DIR/src/algorithms.txt}
+
+# FORCE=1 faz o sts-pipeline ignorar os manifestos e refazer todas as etapas
+# KEEP_INTERMEDIATE=1 faz o sts-pipeline gravar também os arquivos de união
+# (pareto_union/) e as frentes normalizadas (analysis/<instância>/utils/), para depuração
+# CURVES=1 faz o sts-pipeline calcular também os indicadores em todos os
+# checkpoints de cada execução (analysis/<instância>/curves/curve_<nome>.out);
+# com CURVES=cumulative, os indicadores são os da melhor frente até cada checkpoint
+
+# Execução em vários nós: JOB_SPEC=<arquivo> divide as células (algoritmo x
+# instância) entre shards (linhas "shard <id> <instância> [<nome> ...]").
+# Cada nó roda SHARD=<id> STEP=fronts, depois um nó roda STEP=fronts sem
+# SHARD (junção: bound.out e reference_set.out); o mesmo é feito com
+# STEP=indicators, cuja junção grava analysis/ e comparative_results.csv
+# como uma execução num só nó. Os resultados parciais ficam em shards/
 
 # Define o caminho para o arquivo de instâncias
 INSTANCES_FILE="$ROOT_DIR/src/instances.txt"
@@ -39,9 +63,11 @@ else
   done
 fi
 
-mkdir -p "$ROOT_DIR"/pareto_union/MOEAD
-mkdir -p "$ROOT_DIR"/pareto_union/COMOLSD
-mkdir -p "$ROOT_DIR"/pareto_union/NSGA2
+if [ "$LEGACY_CHAIN" = "1" ]; then
+  mkdir -p "$ROOT_DIR"/pareto_union/MOEAD
+  mkdir -p "$ROOT_DIR"/pareto_union/COMOLSD
+  mkdir -p "$ROOT_DIR"/pareto_union/NSGA2
+fi
 mkdir -p "$ROOT_DIR"/logs
 mkdir -p "$ROOT_DIR"/analysis
 
@@ -55,81 +81,112 @@ do
   mkdir -p "$ROOT_DIR"/analysis/"$p"/mann_whitney
   mkdir -p "$ROOT_DIR"/analysis/"$p"/kruskal
 
-  # Une todas as execuções da instância p em um único arquivo
-  for i in {1..20}
-  do
-    cat "$ROOT_DIR"/algorithm_results/MOEAD/"$p"/"$i"/"$p"_moead_1000000.txt >> "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out
-    cat "$ROOT_DIR"/algorithm_results/COMOLSD/"$p"/"$i"/"$p"_comolsd_1000000.txt >> "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out
-    cat "$ROOT_DIR"/algorithm_results/NSGA2/"$p"/"$i"/"$p"_nsga2_1000000.txt >> "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out
-    echo "" >> "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out
-    echo "" >> "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out
-    echo "" >> "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out
-  done
-
-  # Cria inputBound.in juntando os três arquivos de união
-  cat "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out \
-      "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out \
-      "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out \
-      > "$ROOT_DIR"/analysis/"$p"/utils/inputBound.in
-
-  # Bound
-  echo "- [RUNNING] bound for instance $p"
-  "$ROOT_DIR"/src/bin/bound "$ROOT_DIR"/src/utils/bound/bound_param.txt \
-    "$ROOT_DIR"/analysis/"$p"/utils/inputBound.in \
-    "$ROOT_DIR"/analysis/"$p"/utils/bound.out
-
-  # Normalize
-  echo "- [RUNNING] normalize for instance $p"
-  "$ROOT_DIR"/src/bin/normalize "$ROOT_DIR"/src/utils/normalize/normalize_param.txt "$ROOT_DIR"/analysis/"$p"/utils/bound.out "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out
-  "$ROOT_DIR"/src/bin/normalize "$ROOT_DIR"/src/utils/normalize/normalize_param.txt "$ROOT_DIR"/analysis/"$p"/utils/bound.out "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out
-  "$ROOT_DIR"/src/bin/normalize "$ROOT_DIR"/src/utils/normalize/normalize_param.txt "$ROOT_DIR"/analysis/"$p"/utils/bound.out "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out
-
-  # Filter
-  echo "- [RUNNING] filter for instance $p"
-  cat "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out >> "$ROOT_DIR"/analysis/"$p"/utils/inputFilter.in
-  "$ROOT_DIR"/src/bin/filter "$ROOT_DIR"/src/utils/filter/filter_param.txt "$ROOT_DIR"/analysis/"$p"/utils/inputFilter.in "$ROOT_DIR"/analysis/"$p"/reference_set.out
-
-  # Hypervolume
-  echo "- [RUNNING] hyp_ind for instance $p"
-  "$ROOT_DIR"/src/bin/hyp_ind "$ROOT_DIR"/src/indicators/hypervolume/hyp_ind_param_NORM.txt "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_moead.out
-  "$ROOT_DIR"/src/bin/hyp_ind "$ROOT_DIR"/src/indicators/hypervolume/hyp_ind_param_NORM.txt "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_comolsd.out
-  "$ROOT_DIR"/src/bin/hyp_ind "$ROOT_DIR"/src/indicators/hypervolume/hyp_ind_param_NORM.txt "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_nsga2.out
-
-  echo "" >> "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_moead.out
-  echo "" >> "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_comolsd.out
-  echo "" >> "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_nsga2.out
-
-  # Epsilon
-  echo "- [RUNNING] eps_ind for instance $p"
-  "$ROOT_DIR"/src/bin/eps_ind "$ROOT_DIR"/src/indicators/additive_epsilon/eps_ind_param.txt "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_moead.out
-  "$ROOT_DIR"/src/bin/eps_ind "$ROOT_DIR"/src/indicators/additive_epsilon/eps_ind_param.txt "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_comolsd.out
-  "$ROOT_DIR"/src/bin/eps_ind "$ROOT_DIR"/src/indicators/additive_epsilon/eps_ind_param.txt "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_nsga2.out
-
-  echo "" >> "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_moead.out
-  echo "" >> "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_comolsd.out
-  echo "" >> "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_nsga2.out
-
-  # IGD
-  echo "- [RUNNING] igd.py for instance $p"
-  "$PYTHON_CMD" "$ROOT_DIR"/src/indicators/igd/igd.py "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_moead.out
-  "$PYTHON_CMD" "$ROOT_DIR"/src/indicators/igd/igd.py "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_comolsd.out
-  "$PYTHON_CMD" "$ROOT_DIR"/src/indicators/igd/igd.py "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_nsga2.out
-
-  # Kruskal-Wallis
-  echo "- [RUNNING] kruskal-wallis for instance $p"
-  cat "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_moead.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_comolsd.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_nsga2.out >> "$ROOT_DIR"/analysis/"$p"/kruskal/hv_kruskal.in
-  "$ROOT_DIR"/src/bin/kruskal-wallis "$ROOT_DIR"/analysis/"$p"/kruskal/hv_kruskal.in "$ROOT_DIR"/src/indicators/kruskal/kruskalparam.txt "$ROOT_DIR"/analysis/"$p"/kruskal/hv_saidakruskal.out >> "$ROOT_DIR"/logs/log_hv_kruskal.txt 2>&1
-  echo "" >> "$ROOT_DIR"/logs/log_hv_kruskal.txt
-
-  cat "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_moead.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_comolsd.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_nsga2.out >> "$ROOT_DIR"/analysis/"$p"/kruskal/eps_kruskal.in
-  "$ROOT_DIR"/src/bin/kruskal-wallis "$ROOT_DIR"/analysis/"$p"/kruskal/eps_kruskal.in "$ROOT_DIR"/src/indicators/kruskal/kruskalparam.txt "$ROOT_DIR"/analysis/"$p"/kruskal/eps_saidakruskal.out >> "$ROOT_DIR"/logs/log_eps_kruskal.txt 2>&1
-  echo "" >> "$ROOT_DIR"/logs/log_eps_kruskal.txt
-
-  cat "$ROOT_DIR"/analysis/"$p"/igd/IGD_moead.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_comolsd.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_nsga2.out >> "$ROOT_DIR"/analysis/"$p"/kruskal/igd_kruskal.in
-  "$ROOT_DIR"/src/bin/kruskal-wallis "$ROOT_DIR"/analysis/"$p"/kruskal/igd_kruskal.in "$ROOT_DIR"/src/indicators/kruskal/kruskalparam.txt "$ROOT_DIR"/analysis/"$p"/kruskal/igd_saidakruskal.out >> "$ROOT_DIR"/logs/log_igd_kruskal.txt 2>&1
-  echo "" >> "$ROOT_DIR"/logs/log_igd_kruskal.txt
+  # Sem LEGACY_CHAIN=1 o bin/sts-pipeline (abaixo) lê os arquivos de cada execução
+  # diretamente de algorithm_results/ e faz todas as etapas em memória
+  # e só refaz as etapas cujas entradas mudaram (analysis/<instância>/manifest.txt);
+  # a cadeia de ferramentas separadas sempre refaz tudo
+  if [ "$LEGACY_CHAIN" = "1" ]; then
+    # Une todas as execuções da instância p em um único arquivo (recriado a
+    # cada execução, para que uma nova execução não duplique os pontos)
+    : > "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out
+    : > "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out
+    : > "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out
+    for i in {1..20}
+    do
+      cat "$ROOT_DIR"/algorithm_results/MOEAD/"$p"/"$i"/"$p"_moead_1000000.txt >> "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out
+      cat "$ROOT_DIR"/algorithm_results/COMOLSD/"$p"/"$i"/"$p"_comolsd_1000000.txt >> "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out
+      cat "$ROOT_DIR"/algorithm_results/NSGA2/"$p"/"$i"/"$p"_nsga2_1000000.txt >> "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out
+      echo "" >> "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out
+      echo "" >> "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out
+      echo "" >> "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out
+    done
+
+    # Bound + Normalize (uma única leitura de cada arquivo de união: calcula
+    # bound.out sobre os três e normaliza cada um, como bound e normalize)
+    echo "- [RUNNING] bound and normalize for instance $p"
+    "$ROOT_DIR"/src/bin/normalize --bound "$ROOT_DIR"/src/utils/bound/bound_param.txt \
+      "$ROOT_DIR"/analysis/"$p"/utils/bound.out \
+      "$ROOT_DIR"/src/utils/normalize/normalize_param.txt \
+      "$ROOT_DIR"/pareto_union/MOEAD/"$p"_union_pareto_file.out "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out \
+      "$ROOT_DIR"/pareto_union/COMOLSD/"$p"_union_pareto_file.out "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out \
+      "$ROOT_DIR"/pareto_union/NSGA2/"$p"_union_pareto_file.out "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out
+
+    # Filter
+    echo "- [RUNNING] filter for instance $p"
+    cat "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out > "$ROOT_DIR"/analysis/"$p"/utils/inputFilter.in
+    "$ROOT_DIR"/src/bin/filter "$ROOT_DIR"/src/utils/filter/filter_param.txt "$ROOT_DIR"/analysis/"$p"/utils/inputFilter.in "$ROOT_DIR"/analysis/"$p"/reference_set.out
+
+    # Hypervolume
+    echo "- [RUNNING] hyp_ind for instance $p"
+    "$ROOT_DIR"/src/bin/hyp_ind "$ROOT_DIR"/src/indicators/hypervolume/hyp_ind_param_NORM.txt "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_moead.out
+    "$ROOT_DIR"/src/bin/hyp_ind "$ROOT_DIR"/src/indicators/hypervolume/hyp_ind_param_NORM.txt "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_comolsd.out
+    "$ROOT_DIR"/src/bin/hyp_ind "$ROOT_DIR"/src/indicators/hypervolume/hyp_ind_param_NORM.txt "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_nsga2.out
+
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_moead.out
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_comolsd.out
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_nsga2.out
+
+    # Epsilon
+    echo "- [RUNNING] eps_ind for instance $p"
+    "$ROOT_DIR"/src/bin/eps_ind "$ROOT_DIR"/src/indicators/additive_epsilon/eps_ind_param.txt "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_moead.out
+    "$ROOT_DIR"/src/bin/eps_ind "$ROOT_DIR"/src/indicators/additive_epsilon/eps_ind_param.txt "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_comolsd.out
+    "$ROOT_DIR"/src/bin/eps_ind "$ROOT_DIR"/src/indicators/additive_epsilon/eps_ind_param.txt "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_nsga2.out
+
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_moead.out
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_comolsd.out
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_nsga2.out
+
+    # IGD
+    echo "- [RUNNING] igd for instance $p"
+    "$ROOT_DIR"/src/bin/igd "$ROOT_DIR"/src/indicators/igd/igd_param.txt "$ROOT_DIR"/analysis/"$p"/utils/moead_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_moead.out
+    "$ROOT_DIR"/src/bin/igd "$ROOT_DIR"/src/indicators/igd/igd_param.txt "$ROOT_DIR"/analysis/"$p"/utils/comolsd_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_comolsd.out
+    "$ROOT_DIR"/src/bin/igd "$ROOT_DIR"/src/indicators/igd/igd_param.txt "$ROOT_DIR"/analysis/"$p"/utils/nsga2_normalizado.out "$ROOT_DIR"/analysis/"$p"/reference_set.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_nsga2.out
+
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/igd/IGD_moead.out
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/igd/IGD_comolsd.out
+    echo "" >> "$ROOT_DIR"/analysis/"$p"/igd/IGD_nsga2.out
+
+    # Kruskal-Wallis
+    echo "- [RUNNING] kruskal-wallis for instance $p"
+    cat "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_moead.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_comolsd.out "$ROOT_DIR"/analysis/"$p"/hypervolume/HV_nsga2.out > "$ROOT_DIR"/analysis/"$p"/kruskal/hv_kruskal.in
+    "$ROOT_DIR"/src/bin/kruskal-wallis "$ROOT_DIR"/analysis/"$p"/kruskal/hv_kruskal.in "$ROOT_DIR"/src/indicators/kruskal/kruskalparam.txt "$ROOT_DIR"/analysis/"$p"/kruskal/hv_saidakruskal.out >> "$ROOT_DIR"/logs/log_hv_kruskal.txt 2>&1
+    echo "" >> "$ROOT_DIR"/logs/log_hv_kruskal.txt
+
+    cat "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_moead.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_comolsd.out "$ROOT_DIR"/analysis/"$p"/epsilon_additive/esp_ad_nsga2.out > "$ROOT_DIR"/analysis/"$p"/kruskal/eps_kruskal.in
+    "$ROOT_DIR"/src/bin/kruskal-wallis "$ROOT_DIR"/analysis/"$p"/kruskal/eps_kruskal.in "$ROOT_DIR"/src/indicators/kruskal/kruskalparam.txt "$ROOT_DIR"/analysis/"$p"/kruskal/eps_saidakruskal.out >> "$ROOT_DIR"/logs/log_eps_kruskal.txt 2>&1
+    echo "" >> "$ROOT_DIR"/logs/log_eps_kruskal.txt
+
+    cat "$ROOT_DIR"/analysis/"$p"/igd/IGD_moead.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_comolsd.out "$ROOT_DIR"/analysis/"$p"/igd/IGD_nsga2.out > "$ROOT_DIR"/analysis/"$p"/kruskal/igd_kruskal.in
+    "$ROOT_DIR"/src/bin/kruskal-wallis "$ROOT_DIR"/analysis/"$p"/kruskal/igd_kruskal.in "$ROOT_DIR"/src/indicators/kruskal/kruskalparam.txt "$ROOT_DIR"/analysis/"$p"/kruskal/igd_saidakruskal.out >> "$ROOT_DIR"/logs/log_igd_kruskal.txt 2>&1
+    echo "" >> "$ROOT_DIR"/logs/log_igd_kruskal.txt
+  fi
 done
 
+if [ "$LEGACY_CHAIN" != "1" ] && [ -n "${JOB_SPEC:-}" ]; then
+  if [ -n "${SHARD:-}" ]; then
+    SHARD_FLAGS=(--shard "$SHARD")
+  else
+    SHARD_FLAGS=(--merge)
+  fi
+  echo "- [RUNNING] sts-pipeline ${SHARD_FLAGS[*]} ${STEP:-fronts} ($JOBS threads)"
+  "$ROOT_DIR"/src/bin/sts-pipeline --jobs "$JOBS" --algorithms "$ALGORITHMS_FILE" --spec "$JOB_SPEC" "${SHARD_FLAGS[@]}" "${STEP:-fronts}" "$ROOT_DIR"
+elif [ "$LEGACY_CHAIN" != "1" ]; then
+  echo "- [RUNNING] sts-pipeline for ${#INSTANCES[@]} instances ($JOBS threads)"
+  PIPELINE_FLAGS=()
+  if [ "${FORCE:-0}" = "1" ]; then
+    PIPELINE_FLAGS+=(--force)
+  fi
+  if [ "${KEEP_INTERMEDIATE:-0}" = "1" ]; then
+    PIPELINE_FLAGS+=(--keep-intermediate)
+  fi
+  if [ "${CURVES:-0}" = "1" ]; then
+    PIPELINE_FLAGS+=(--curves)
+  elif [ "${CURVES:-0}" = "cumulative" ]; then
+    PIPELINE_FLAGS+=(--cumulative-curves)
+  fi
+  "$ROOT_DIR"/src/bin/sts-pipeline --jobs "$JOBS" --algorithms "$ALGORITHMS_FILE" "${PIPELINE_FLAGS[@]}" "$ROOT_DIR" "${INSTANCES[@]}"
+fi
+
 # Salva a lista de instâncias processadas em um arquivo temporário
 INSTANCES_LIST_FILE="$ROOT_DIR/analysis/processed_instances.txt"
 printf "%s\n" "${INSTANCES[@]}" > "$INSTANCES_LIST_FILE"
@@ -36,10 +36,19 @@ My email address is j.knowles@manchester.ac.uk
    
 
    COMPILE:
-      g++ bound.cc -o bound -lm -Wall -pedantic
+      g++ -pthread -I../reader -I../trace bound.cc ../reader/reader.cc ../trace/trace.cc -o bound -lm -Wall -pedantic
 
    RUN:
-      ./bound [<param>] <datafile> <outfile>
+      ./bound [--threads <n>] [<param>] <datafile> <outfile>
+      ./bound [--threads <n>] --files <param> <outfile> <datafile> [<datafile> ...]
+
+    The second form takes the bounds of all points in several data files,
+    as if they were concatenated into one <datafile>. The points are
+    reduced while the files are parsed (see scan_point_file() in
+    reader.h), so bound needs little memory whatever the size of the
+    data. A data file of at least PARALLEL_SIZE bytes is split into <n>
+    parts (default: one per hardware thread) that are reduced in
+    parallel; the bounds are the same for any <n>.
 
 
     The format of the parameter file <param> is
@@ -91,6 +100,13 @@ are considered together.
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+
+#include "reader.h"
+#include "trace.h"
 
 using namespace std;
 
@@ -98,21 +114,11 @@ using namespace std;
 #define MAX_LINE_LENGTH 1024
 #define MAX_STR_LENGTH 200
 #define VERBOSE 1
+#define PARALLEL_SIZE (64L << 20)
 #define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
 
 FILE *fp;
 
-struct dnode{
-  double *o;
-  bool dominated;
-  struct dnode *next;
-  struct dnode *prev;
-};
-
-
-dnode **po;
-dnode *ref;
-
 int *minmax1;
 double *best;
 double *worst;
@@ -121,88 +127,106 @@ int nobjs;
 
 
 double myabs(double a);
-void d_append (struct dnode **s, double *vec);
-void d_display ( struct dnode *q );
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp);
 int  determine_dim(FILE  *fp);
-void  read_file(FILE  *fp, int  *no_pointsp, dnode **po);
 
 
-void d_append (struct dnode **s, double *vec) 
-/* adds a new node at the end of the doubly linked list */ 
+/* The best and worst value of each objective in one part of a data file.
+   A value only replaces the current one if it is strictly better (worse),
+   so that of several equal values the first one in the file is kept.
+   best and worst start out below (above) any value, and first keeps the
+   first point of the part. The bounds of the parts are combined in the
+   order of the files in the same way, starting from the first point of
+   all, which gives the bounds of a single scan over all points. */
+struct part_bounds
 {
-  struct dnode *r, *q = *s ; 
-  /* if the linked list is empty */ 
-  
-  if ( *s == NULL ) 
-    { 
-      
-      /*create a new node */ 
-      
-      *s = (dnode *) malloc ( sizeof ( struct dnode ) ) ;
-      ( *s ) -> prev = NULL ; 
-      (*s)->o = (double *) malloc(nobjs * sizeof (double) );
-      for(int j=0;j<nobjs;j++)
-	( *s ) -> o[j] = vec[j]; 
-      (*s)->dominated = false;
-      ( *s ) -> next = NULL ; 
-    } 
-  
-  else 
-    { 
-      
-      /* traverse the linked list till the last node is reached */ 
-      while ( q -> next != NULL ) 
-	q = q -> next; 
-
-      /* add a new node at the end */ 
-
-      r = (dnode *)malloc ( sizeof ( struct dnode ) ) ; 
-      r->o = (double *)malloc(nobjs * sizeof (double) );
-      for(int j=0;j<nobjs;j++)
-	r -> o[j] = vec[j]; 
-      r->dominated = false;
-      r -> next = NULL; 
-      r -> prev = q; 
-      q -> next = r; 
-    } 
-  
-} 
-
-/* displays the contents of the linked list */ 
-void d_display ( struct dnode *q ) 
-{ 
-  /* traverse the entire linked list */ 
-  while ( q != NULL )     
-    { 
-      if(1) // (q->dominated==false)
+  const char *path;
+  int part, nparts;
+  long long npoints;
+  vector<double> first, best, worst;
+};
+
+static void reduce(const double *d, double *b, double *w)
+{
+  for(int i=0;i<nobjs;i++)
+    {
+      if(d[i]*minmax1[i] > b[i]*minmax1[i])
+	b[i] = d[i];
+      if(d[i]*minmax1[i] < w[i]*minmax1[i])
+	w[i] = d[i];
+    }
+}
+
+static void visit_block(const double *points, int n, void *arg)
+{
+  part_bounds *pb = (part_bounds *)arg;
+
+  if(pb->npoints == 0)
+    pb->first.assign(points, points+nobjs);
+  for(int k=0;k<n;k++)
+    reduce(points+(size_t)k*nobjs, pb->best.data(), pb->worst.data());
+  pb->npoints += n;
+}
+
+static void scan_parts(vector<part_bounds> &parts, int nthreads)
+{
+  atomic<size_t> next(0);
+  auto work = [&]() {
+    for(size_t t; (t = next++) < parts.size(); )
+      if(!scan_point_file(parts[t].path, nobjs, parts[t].part, parts[t].nparts,
+			  visit_block, &parts[t]))
 	{
-	  for(int j=0;j<nobjs;j++)
-	    printf("%.9e ", q->o[j]);
-	  printf("\n");
+	  fprintf(stderr,"Couldn't open %s\n", parts[t].path);
+	  exit(1);
 	}
-      q = q -> next;       
-    } 
-  
-} 
+  };
+  vector<thread> threads;
+  nthreads = (int)min<size_t>(nthreads, parts.size());
+  for(int t=1;t<nthreads;t++)
+    threads.push_back(thread(work));
+  work();
+  for(size_t t=0;t<threads.size();t++)
+    threads[t].join();
+}
 
 
 int main(int argc, char **argv)
 {
-  int num;
-  int nruns;
-  int count;
-  struct dnode *p;
-  p=NULL;  
   int i;  
   char str[MAX_STR_LENGTH];
-  
-  error(argc!=4 && argc != 3,"./bound [<paramfile>] <datafile> <outfile>");
-  
+  int nthreads = 0, arg = 1;
+  bool files = false;
+
+  for(;;)
+    if(arg+1 < argc && strcmp(argv[arg], "--threads") == 0)
+      {
+	nthreads = atoi(argv[arg+1]);
+	error(nthreads < 0, "the number of threads is a non-negative integer");
+	arg += 2;
+      }
+    else if(arg < argc && strcmp(argv[arg], "--files") == 0)
+      {
+	files = true;
+	arg++;
+      }
+    else
+      break;
+  int nargs = argc - arg;
+  error(files ? nargs < 3 : nargs != 3 && nargs != 2,
+	"./bound [--threads <n>] [<paramfile>] <datafile> <outfile>\n"
+	"./bound [--threads <n>] --files <paramfile> <outfile> <datafile> [<datafile> ...]");
+  bool param = files || nargs == 3;
+  const char *outfile = argv[files ? arg+1 : argc-1];
+  vector<const char *> infiles;
+  if(files)
+    infiles.assign(argv+arg+2, argv+argc);
+  else
+    infiles.push_back(argv[param ? arg+1 : arg]);
+  if(nthreads == 0)
+    nthreads = max(1, (int)thread::hardware_concurrency());
    
   /* read in the parameter file */
-  if (argc == 4) {
-      if((fp = fopen(argv[1], "rb")))
+  if (param) {
+      if((fp = fopen(argv[arg], "rb")))
       {
 	  fscanf(fp, "%s", str);
 	  error(strcmp(str, "dim") != 0, "error in parameter file");
@@ -233,9 +257,10 @@ int main(int argc, char **argv)
       }
   }
   else {
-	fp = fopen(argv[1], "r");
+	fp = fopen(infiles[0], "r");
 	error(fp == NULL, "data file not found");
-	nobjs = determine_dim(fp);
+	if ((nobjs = point_file_header(infiles[0], NULL)) == 0)
+	    nobjs = determine_dim(fp);
 	error(nobjs < 1, "error in data file");
 	fclose(fp);
 	minmax1 = (int *)malloc(nobjs*sizeof(int));
@@ -247,48 +272,57 @@ int main(int argc, char **argv)
   }
   
 
-  /* read in each of the approximation sets */
-  if((fp=fopen(argv[(argc == 4 ? 2 : 1)], "rb")))
-    {
-      check_file(fp, &nruns, &num);
-      rewind(fp);
-      while(!feof(fp))
-	read_file(fp, &num, &p);      
-    }
-  else
+  /* reduce the approximation sets while reading them */
+  trace_span span;
+  trace_begin(&span, "bound");
+  vector<part_bounds> parts;
+  for(size_t f=0;f<infiles.size();f++)
     {
-      fprintf(stderr,"Couldn't open %s", argv[(argc == 4 ? 2 : 1)]);
-      exit(1);
-    }
-  
-  for(i=0;i<nobjs;i++)
-    {
-      best[i] = p->o[i];
-      worst[i] = p->o[i];
+      struct stat st;
+      int nparts = stat(infiles[f], &st) == 0 && st.st_size >= PARALLEL_SIZE ? nthreads : 1;
+      for(int k=0;k<nparts;k++)
+	{
+	  part_bounds pb;
+	  pb.path = infiles[f];
+	  pb.part = k;
+	  pb.nparts = nparts;
+	  pb.npoints = 0;
+	  pb.best.resize(nobjs);
+	  pb.worst.resize(nobjs);
+	  for(i=0;i<nobjs;i++)
+	    {
+	      pb.best[i] = -HUGE_VAL*minmax1[i];
+	      pb.worst[i] = HUGE_VAL*minmax1[i];
+	    }
+	  parts.push_back(pb);
+	}
     }
-  
+  scan_parts(parts, nthreads);
 
-  struct dnode *di = p;
-  count=0;
-  while( di !=NULL)
+  long long npoints = 0;
+  for(size_t t=0;t<parts.size();t++)
     {
-      for(int i=0;i<nobjs;i++)
+      if(parts[t].npoints == 0)
+	continue;
+      if(npoints == 0)
+	for(i=0;i<nobjs;i++)
+	  best[i] = worst[i] = parts[t].first[i];
+      for(i=0;i<nobjs;i++)
 	{
-	  if(di->o[i]*minmax1[i] > best[i]*minmax1[i])
-	    best[i] = di->o[i];
-	  if(di->o[i]*minmax1[i] < worst[i]*minmax1[i])
-	    worst[i] = di->o[i];
+	  if(parts[t].best[i]*minmax1[i] > best[i]*minmax1[i])
+	    best[i] = parts[t].best[i];
+	  if(parts[t].worst[i]*minmax1[i] < worst[i]*minmax1[i])
+	    worst[i] = parts[t].worst[i];
 	}
-      count++;
-      di = di->next;
+      npoints += parts[t].npoints;
     }
-  //  fprintf(stderr, "count =%d\n",count);
+  error(npoints < 1, "error in data file");
 
 
-  if(!(fp=fopen(argv[(argc == 4 ? 3 : 2)],"wb")))
+  if(!(fp=fopen(outfile,"wb")))
     {
       fprintf(stderr, "Couldn't open %s for writing. Exiting\n",
-	      argv[(argc == 4 ? 3 : 2)]);
+	      outfile);
       exit(1);
     }
 
@@ -329,61 +363,12 @@ int main(int argc, char **argv)
   // fprintf(fp, "\n");
 
   fclose(fp);
+  trace_end(&span, NULL, infiles.size() == 1 ? infiles[0] : NULL, npoints);
   exit(0);
   return(0);
 
 }
 
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp)
-    /* check_file() function by Eckart Zitzler
-       determines the maximum number of points and the number of runs
-       for the data resp. the reference set file; if the array v is
-       specified, the data read in will be stored in v
-    */
-{
-    char  line[MAX_STR_LENGTH];
-    int  i, j;
-    int  new_run;
-    int  no_points;
-    double  number;
-
-    no_points = 0;
-    *max_pointsp = 0;
-    *no_runsp = 0;
-    new_run = 1;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-	if (sscanf(line, "%lf", &number) != 1)
-	    new_run = 1;
-	else {
-	    if (new_run == 1)
-	    {
-		(*no_runsp)++;
-		if (*max_pointsp < no_points)
-		    *max_pointsp = no_points;
-		no_points = 0;
-	    }
-	    new_run = 0;
-	    i = 0;
-	    for (j = 1; j < nobjs; j++) {
-		while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		    i++;
-		if((sscanf(&(line[i]), "%lf", &number)) <= 0)
-		  {
-		    fprintf(stderr,"error in data or reference set file");
-		    exit(0);
-		  }
-		
-		while (line[i] == ' ' && line[i] != '\0')
-		    i++;
-	    }
-	    no_points++;
-	}
-    }
-    if (*max_pointsp < no_points)
-	*max_pointsp = no_points;
-}
-
-
 int  determine_dim(FILE  *fp)
 {
     char  line[MAX_STR_LENGTH];
@@ -410,55 +395,6 @@ int  determine_dim(FILE  *fp)
     return no_obj;
 }
 
-void  read_file(FILE  *fp, int  *no_pointsp, dnode **po)
-{
-  /* read_file() function by Eckart Zitzler */
-  char  line[MAX_STR_LENGTH];
-  int  i, j, k;
-  int  reading;
-  double  number;
-  double *vector;
-
-  vector=(double *)malloc(nobjs*sizeof(double));
-  
-  reading = 0;
-  *no_pointsp = 0;
-  //  printf("read_file\n");
-  while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) 
-    {
-      //      printf("OK\n");
-      k=0;
-      if (sscanf(line, "%lf", &number) != 1)
-	{
-	  //	  printf("break\n");
-	  if (reading) break;
-	}
-      else 
-	{
-	  reading = 1;
-	  vector[k++] = number;
-	  i = 0;
-	  for (j = 1; j < nobjs; j++) 
-	    {
-	      while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		i++;
-	      if((sscanf(&(line[i]), "%lf", &number)) <= 0)
-		{
-		    fprintf(stderr,"error in data or reference set file");
-		    exit(0);
-		}
-	      
-	      vector[k++] = number;
-	      while (line[i] == ' ' && line[i] != '\0')
-		i++;
-	    }
-	  (*no_pointsp)++;
-	  // printf("%.9e", vector[0]);
-	  d_append(po, vector);
-	}
-    } 
-}
-
 double myabs(double a)
 {
   if(a>=0)
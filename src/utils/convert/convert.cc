@@ -0,0 +1,192 @@
+/* convert.cc
+
+A program that converts a file <infile> consisting of a collection of
+approximation sets between the text format read by all tools and the
+binary format described in utils/reader/reader.h. The format of <infile>
+is recognized automatically; <outfile> is written in the binary format if
+its name ends in .bin and as text otherwise.
+
+   COMPILE:
+      g++ -I../pointset -I../reader convert.cc ../pointset/pointset.cc ../reader/reader.cc -o convert -lm
+
+   RUN:
+      ./convert [<paramfile>] <infile> <outfile>
+
+
+    The format of the parameter file <param> is
+
+      dim <number>
+      obj <+|-> <+|-> ...
+
+    where dim specifies the number of objective dimensions and obj whether
+    each objective is minimized (-) or maximized (+); the senses are stored
+    in the header of a binary <outfile>. If the parameter file is omitted,
+    the number of objectives and the senses are taken from the header of a
+    binary <infile>; for a text <infile>, the number of objectives is
+    determined from the file and all objectives are taken to be minimized.
+
+   The text format of the collection of approximation sets is
+      <number> <number> ...
+      <number> <number> ...
+      [blank line]
+      <number> <number> ...
+      <number> <number> ...
+      [blank line]
+      .
+      .
+      <number> <number> ...
+
+   The runs, the order of the points and their values are kept; text is
+   written with "%.9e", as normalize and filter do.
+
+*******************************************************************/
+
+
+
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#include "reader.h"
+#include "pointset.h"
+#include "trace.h"
+
+using namespace std;
+
+#define MAX_LINE_LENGTH 1024
+#define MAX_STR_LENGTH 200
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+FILE *fp;
+
+pointset p;
+
+int *minmax1;
+int nobjs;
+
+
+int  determine_dim(FILE  *fp);
+
+
+int main(int argc, char **argv)
+{
+  int i;
+  char str[MAX_STR_LENGTH];
+
+  error(argc!=4 && argc != 3,"./convert [<paramfile>] <infile> <outfile>");
+
+
+  /* read in the parameter file */
+  if (argc == 4) {
+      if((fp = fopen(argv[1], "rb")))
+      {
+	  fscanf(fp, "%s", str);
+	  error(strcmp(str, "dim") != 0, "error in parameter file");
+	  fscanf(fp, "%d", &nobjs);
+	  error(nobjs < 1, "error in parameter file");
+	  fscanf(fp, "%s", str);
+	  error(strcmp(str, "obj") != 0, "error in parameter file");
+	  minmax1 = (int *)malloc(nobjs*sizeof(int));
+	  for (i = 0; i < nobjs; i++)
+	  {
+	      fscanf(fp, "%s", str);
+	      error(str[0] != '-' && str[0] != '+', "error in parameter file");
+	      if (str[0] == '-')
+		  minmax1[i] = -1;
+	      else
+		  minmax1[i] = 1;
+	  }
+	  fclose(fp);
+      }
+      else
+      {
+	  fprintf(stderr,"Couldn't open param file\n");
+	  exit(1);
+      }
+  }
+  else {
+      fp = fopen(argv[1], "r");
+      error(fp == NULL, "data file not found");
+      if ((nobjs = point_file_header(argv[1], NULL)) == 0)
+	  nobjs = determine_dim(fp);
+      error(nobjs < 1, "error in data file");
+      fclose(fp);
+      minmax1 = (int *)malloc(nobjs*sizeof(int));
+      for (i = 0; i < nobjs; i++)
+	  minmax1[i] = -1;
+      point_file_header(argv[1], minmax1);
+  }
+
+  /* read in each of the approximation sets */
+  const char *infile = argv[(argc == 4 ? 2 : 1)];
+  trace_span span;
+  trace_begin(&span, "parse");
+  if(!read_pointset(infile, nobjs, true, &p))
+  {
+      fprintf(stderr,"Couldn't open %s\n", infile);
+      exit(1);
+  }
+  trace_end(&span, NULL, infile, p.npoints());
+  trace_begin(&span, "convert");
+
+  const char *outfile = argv[(argc == 4 ? 3 : 2)];
+  if(binary_file_name(outfile))
+  {
+      if(!write_pointset(outfile, p, minmax1))
+      {
+	  fprintf(stderr,"Couldn't open %s for writing\n", outfile);
+	  exit(1);
+      }
+      trace_end(&span, NULL, infile, p.npoints());
+      exit(0);
+  }
+
+  if(!(fp=fopen(outfile,"wb")))
+  {
+      fprintf(stderr,"Couldn't open %s for writing\n", outfile);
+      exit(1);
+  }
+  for(i=0; i<p.nruns();i++)
+  {
+      const double *di = p.run(i);
+      for(int k=0;k<p.size(i);k++, di+=nobjs)
+      {
+	  for(int j=0;j<nobjs;j++)
+	      fprintf(fp, "%.9e ", di[j]);
+	  fprintf(fp, "\n");
+      }
+      fprintf(fp, "\n");
+  }
+  fclose(fp);
+  trace_end(&span, NULL, infile, p.npoints());
+
+  exit(0);
+  return(0);
+
+}
+
+int  determine_dim(FILE  *fp)
+{
+    char  line[MAX_STR_LENGTH];
+    int  i, no_obj;
+    int  line_found, number_found;
+    double  number;
+
+    no_obj = 0;
+    line_found = 0;
+    while (fgets(line, MAX_STR_LENGTH, fp) != NULL && !line_found)
+        line_found = sscanf(line, "%lf", &number);
+    if (line_found) {
+	i = 0;
+	do {
+	    no_obj++;
+	    while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
+		i++;
+	    number_found = sscanf(&(line[i]), "%lf", &number);
+	    while (line[i] == ' ' && line[i] != '\0')
+		i++;
+	} while (number_found == 1);
+    }
+
+    return no_obj;
+}
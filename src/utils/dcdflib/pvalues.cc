@@ -0,0 +1,162 @@
+/* pvalues.cc
+
+Batch p-values on top of dcdflib, see pvalues.h.
+
+*/
+
+#include <float.h>
+#include <math.h>
+#include <mutex>
+#include "dcdflib.h"
+#include "pvalues.h"
+
+// dcdflib keeps intermediate results in static variables, so the calls of
+// concurrent tests (sts-pipeline --jobs) have to be serialized
+static std::mutex dcdflib_mutex;
+
+// the coefficients of cumnor, W J Cody, "Rational Chebyshev approximations
+// for the error function", Mathematics of Computation, 1969, pages 631-637
+static const double a[5] = {
+  2.2352520354606839287e00,1.6102823106855587881e02,1.0676894854603709582e03,
+  1.8154981253343561249e04,6.5682337918207449113e-2
+};
+static const double b[4] = {
+  4.7202581904688241870e01,9.7609855173777669322e02,1.0260932208618978205e04,
+  4.5507789335026729956e04
+};
+static const double c[9] = {
+  3.9894151208813466764e-1,8.8831497943883759412e00,9.3506656132177855979e01,
+  5.9727027639480026226e02,2.4945375852903726711e03,6.8481904505362823326e03,
+  1.1602651437647350124e04,9.8427148383839780218e03,1.0765576773720192317e-8
+};
+static const double d[8] = {
+  2.2266688044328115691e01,2.3538790178262499861e02,1.5193775994075548050e03,
+  6.4855582982667607550e03,1.8615571640885098091e04,3.4900952721145977266e04,
+  3.8912003286093271411e04,1.9685429676859990727e04
+};
+static const double p[6] = {
+  2.1589853405795699e-1,1.274011611602473639e-1,2.2235277870649807e-2,
+  1.421619193227893466e-3,2.9112874951168792e-5,2.307344176494017303e-2
+};
+static const double q[5] = {
+  1.28426009614491121e00,4.68238212480865118e-1,6.59881378689285515e-2,
+  3.78239633202758244e-3,7.29751555083966205e-5
+};
+static const double sqrpi = 3.9894228040143267794e-1;
+static const double thrsh = 0.66291e0;
+static const double root32 = 5.656854248e0;
+
+static inline void normal(double x, double &result, double &ccum)
+{
+  // cumnor with the same operations in the same order; dpmpar(1) is
+  // DBL_EPSILON and dpmpar(2) DBL_MIN
+  double del, temp, xden, xnum, xsq;
+  double y = fabs(x);
+  int i;
+
+  if (y <= thrsh)
+    {
+      xsq = 0.0;
+      if (y > DBL_EPSILON*0.5)
+	xsq = x*x;
+      xnum = a[4]*xsq;
+      xden = xsq;
+      for (i = 0; i < 3; i++)
+	{
+	  xnum = (xnum + a[i])*xsq;
+	  xden = (xden + b[i])*xsq;
+	}
+      temp = x*(xnum + a[3])/(xden + b[3]);
+      result = 0.5 + temp;
+      ccum = 0.5 - temp;
+    }
+  else
+    {
+      if (y <= root32)
+	{
+	  xnum = c[8]*y;
+	  xden = y;
+	  for (i = 0; i < 7; i++)
+	    {
+	      xnum = (xnum + c[i])*y;
+	      xden = (xden + d[i])*y;
+	    }
+	  result = (xnum + c[7])/(xden + d[7]);
+	  xsq = trunc(y*1.6)/1.6;
+	  del = (y - xsq)*(y + xsq);
+	}
+      else
+	{
+	  xsq = 1.0/(x*x);
+	  xnum = p[5]*xsq;
+	  xden = xsq;
+	  for (i = 0; i < 4; i++)
+	    {
+	      xnum = (xnum + p[i])*xsq;
+	      xden = (xden + q[i])*xsq;
+	    }
+	  result = xsq*(xnum + p[4])/(xden + q[4]);
+	  result = (sqrpi - result)/y;
+	  xsq = trunc(x*1.6)/1.6;
+	  del = (x - xsq)*(x + xsq);
+	}
+      result = exp(-(xsq*xsq*0.5))*exp(-(del*0.5))*result;
+      ccum = 1.0 - result;
+      if (x > 0.0)
+	{
+	  temp = result;
+	  result = ccum;
+	  ccum = temp;
+	}
+    }
+  if (result < DBL_MIN)
+    result = 0.0;
+  if (ccum < DBL_MIN)
+    ccum = 0.0;
+}
+
+void normal_tails(const double *x, int n, double *lower, double *upper)
+{
+  double cum, ccum;
+
+  for (int i = 0; i < n; i++)
+    {
+      normal(x[i], cum, ccum);
+      if (lower)
+	lower[i] = cum;
+      if (upper)
+	upper[i] = ccum;
+    }
+}
+
+void t_tails(const double *t, int n, double df, double *lower, double *upper)
+{
+  double x, cum, ccum;
+  std::lock_guard<std::mutex> lock(dcdflib_mutex);
+
+  for (int i = 0; i < n; i++)
+    {
+      x = t[i];
+      cumt(&x, &df, &cum, &ccum);
+      if (lower)
+	lower[i] = cum;
+      if (upper)
+	upper[i] = ccum;
+    }
+}
+
+void chi_tails(const double *x, int n, double df, double *lower, double *upper)
+{
+  double v, cum, ccum;
+  std::lock_guard<std::mutex> lock(dcdflib_mutex);
+
+  for (int i = 0; i < n; i++)
+    {
+      v = x[i];
+      cumchi(&v, &df, &cum, &ccum);
+      if (lower)
+	lower[i] = cum;
+      if (upper)
+	upper[i] = ccum;
+    }
+}
@@ -0,0 +1,37 @@
+/* pvalues.h
+
+Batch evaluation of the distribution functions the rank tests need, on top
+of dcdflib.
+
+Each function takes an array of n statistics with a shared number of degrees
+of freedom and writes P(X <= x[i]) to lower[i] and P(X > x[i]) to upper[i];
+either output may be NULL. The values are those of cdfnor, cdft and cdfchi
+with which = 1, bit for bit, but the calls go straight to the distribution
+functions (cumnor, cumt, cumchi) instead of through the generic interface
+with its argument checks and inverse searches.
+
+The normal distribution function is evaluated by a copy of Cody's
+algorithm from cumnor without static variables, which needs no lock and
+which the compiler can inline into the loop. The t and chi-square
+distributions go through dcdflib's incomplete beta and gamma functions,
+which keep intermediate results in static variables, so their calls are
+serialized; a batch takes the lock once.
+
+For the t distribution lower[i] is also the upper tail of -t[i], so the
+p-values of both directions of a pair-wise test come from one evaluation.
+
+*/
+
+#ifndef PVALUES_H
+#define PVALUES_H
+
+// the standard normal distribution
+void normal_tails(const double *x, int n, double *lower, double *upper);
+
+// the t distribution with df > 0 degrees of freedom
+void t_tails(const double *t, int n, double df, double *lower, double *upper);
+
+// the chi-square distribution with df > 0 degrees of freedom; x >= 0
+void chi_tails(const double *x, int n, double df, double *lower, double *upper);
+
+#endif
@@ -32,10 +32,17 @@ My email address is j.knowles@manchester.ac.uk
    
 
    COMPILE:
-      g++ filter.cc -o filter -lm -Wall -pedantic
+      g++ -pthread -I../pointset -I../reader filter.cc nondominated.cc ../pointset/pointset.cc ../reader/reader.cc -o filter -lm -Wall -pedantic
 
    RUN:
-      ./filter [<param>] <datafile> <outfile>
+      ./filter [--threads <n>] [<param>] <datafile> <outfile>
+
+    The approximation sets are filtered on <n> threads (default: one per
+    hardware thread). With method 0 every set is a task of its own; with
+    method 1 every set is filtered by itself and the nondominated sets are
+    then merged pairwise, as in a tree (see filter_merge() in
+    nondominated.h), instead of filtering the union of all sets at once.
+    The output is the same for any <n>.
 
 
     The format of the parameter file <param> is
@@ -65,10 +72,15 @@ My email address is j.knowles@manchester.ac.uk
       <number> <number> ...
 
       
+   <datafile> may also be a binary file written by normalize or filter
+      (see utils/reader/reader.h); without <param>, the objective senses
+      are then taken from its header.
+
    The output of filter is a file <outfile> in
       the same format, but all points should 
       be internally nondominated within each set
-      separated by the blank lines.
+      separated by the blank lines. If <outfile> ends in .bin, it is
+      written in the binary format instead.
 
 *******************************************************************/
 
@@ -82,6 +94,13 @@ My email address is j.knowles@manchester.ac.uk
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "reader.h"
+#include "pointset.h"
+#include "nondominated.h"
+#include "trace.h"
 
 using namespace std;
 
@@ -93,102 +112,37 @@ using namespace std;
 
 FILE *fp;
 
-struct dnode{
-  double *o;
-  bool dominated;
-  struct dnode *next;
-  struct dnode *prev;
-};
-
-
-dnode **po;
+pointset po, out;
 
 int *minmax1;
 int nobjs;
 int method;
 
 
-void d_append (struct dnode **s, double *vec);
-void d_display ( struct dnode *q );
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp);
 int  determine_dim(FILE  *fp);
-void  read_file(FILE  *fp, int  *no_pointsp, dnode **po);
-int dominates(double *a, double *b, int *minmax1, int n);
-bool are_identical(double *first, double *second, int *minmax1, int n);
-
-
-void d_append (struct dnode **s, double *vec) 
-/* adds a new node at the end of the doubly linked list */ 
-{
-  struct dnode *r, *q = *s ; 
-  /* if the linked list is empty */ 
-  
-  if ( *s == NULL ) 
-    { 
-      
-      /*create a new node */ 
-      
-      *s = (dnode *) malloc ( sizeof ( struct dnode ) ) ;
-      ( *s ) -> prev = NULL ; 
-      (*s)->o = (double *) malloc(nobjs * sizeof (double) );
-      for(int j=0;j<nobjs;j++)
-	( *s ) -> o[j] = vec[j]; 
-      (*s)->dominated = false;
-      ( *s ) -> next = NULL ; 
-    } 
-  
-  else 
-    { 
-      
-      /* traverse the linked list till the last node is reached */ 
-      while ( q -> next != NULL ) 
-	q = q -> next; 
-
-      /* add a new node at the end */ 
-
-      r = (dnode *)malloc ( sizeof ( struct dnode ) ) ; 
-      r->o = (double *)malloc(nobjs * sizeof (double) );
-      for(int j=0;j<nobjs;j++)
-	r -> o[j] = vec[j];
-      r->dominated = false;
-      r -> next = NULL; 
-      r -> prev = q; 
-      q -> next = r; 
-    } 
-  
-} 
-
-/* displays the contents of the linked list */ 
-void d_display ( struct dnode *q ) 
-{ 
-  /* traverse the entire linked list */ 
-  while ( q != NULL )     
-    { 
-      if(1) // (q->dominated==false)
-	{
-	  for(int j=0;j<nobjs;j++)
-	    printf("%.9e ", q->o[j]);
-	  printf("\n");
-	}
-      q = q -> next;       
-    } 
-  
-} 
 
 
 int main(int argc, char **argv)
 {
-  int num;
-  int nruns;
   int i;  
   char str[MAX_STR_LENGTH];
-  
-  error(argc!=4 && argc != 3,"./filter [<paramfile>] <datafile> <outfile>");
+  int nthreads = 0, arg = 1;
+
+  if(arg+1 < argc && strcmp(argv[arg], "--threads") == 0)
+    {
+      nthreads = atoi(argv[arg+1]);
+      error(nthreads < 0, "the number of threads is a non-negative integer");
+      arg += 2;
+    }
+  int nargs = argc - arg;
+  error(nargs != 3 && nargs != 2,"./filter [--threads <n>] [<paramfile>] <datafile> <outfile>");
+  if(nthreads == 0)
+    nthreads = max(1, (int)thread::hardware_concurrency());
   
   
   /* read in the parameter file */
-  if (argc == 4) {
-      if((fp = fopen(argv[1], "rb")))
+  if (nargs == 3) {
+      if((fp = fopen(argv[arg], "rb")))
       {
 	  fscanf(fp, "%s", str);
 	  error(strcmp(str, "dim") != 0, "error in parameter file");
@@ -218,151 +172,101 @@ int main(int argc, char **argv)
       }
   }
   else {
-      fp = fopen(argv[1], "r");
+      fp = fopen(argv[arg], "r");
       error(fp == NULL, "data file not found");
-      nobjs = determine_dim(fp);
+      if ((nobjs = point_file_header(argv[arg], NULL)) == 0)
+	  nobjs = determine_dim(fp);
       error(nobjs < 1, "error in data file");
       fclose(fp);
       minmax1 = (int *)malloc(nobjs*sizeof(int));
       for (i = 0; i < nobjs; i++) 
 	  minmax1[i] = -1;
+      // a binary file carries its objective senses
+      point_file_header(argv[arg], minmax1);
       method = 1;
   }
   
 
-  /* read in each of the approximation sets */
-  if((fp=fopen(argv[(argc == 4 ? 2 : 1)], "rb")))
-  {
-      check_file(fp, &nruns, &num);
-      po = (dnode **)malloc(nruns*sizeof(dnode *));
-      rewind(fp);
-      for(int j=0;j<nruns;j++)
-      {
-	  po[j]=NULL;
-	  read_file(fp, &num, &(po[j]));      
-      }
-  }
-  else
+  /* read in each of the approximation sets; with method 1 they are the
+     blocks of the merge */
+  const char *infile = argv[argc-2];
+  trace_span span;
+  trace_begin(&span, "parse");
+  if(!read_pointset(infile, nobjs, true, &po))
   {
-      fprintf(stderr,"Couldn't open %s", argv[(argc == 4 ? 2 : 1)]);
+      fprintf(stderr,"Couldn't open %s", infile);
       exit(1);
   }
-  if(!(fp=fopen(argv[(argc == 4 ? 3 : 2)],"wb")))
+  trace_end(&span, NULL, infile, po.npoints());
+  trace_begin(&span, "filter");
+  const char *outfile = argv[argc-1];
+  bool binary = binary_file_name(outfile);
+  if(!binary && !(fp=fopen(outfile,"wb")))
   {
-      fprintf(stderr,"Couldn't open %s for writing\n",
-	      argv[(argc == 4 ? 3 : 2)]);
+      fprintf(stderr,"Couldn't open %s for writing\n", outfile);
       exit(0);
   }
   
-  for(i=0; i<nruns;i++)
+  int npoints = po.npoints();
+  vector<const double *> o(npoints);
+  vector<int> start(po.nruns()+1, 0);
+  bool *dominated = new bool[npoints+1];
+  for (int k = 0; k < npoints; k++)
+      o[k] = po.point(k);
+  for (i = 0; i < po.nruns(); i++)
+      start[i+1] = start[i] + po.size(i);
+  if (method == 0)
+      filter_blocks(o.data(), start.data(), po.nruns(), nobjs, minmax1, dominated, nthreads);
+  else
   {
-      struct dnode *di = po[i];
-      while( di !=NULL)
-      {
-	  struct dnode *dj = po[i];
-	  while( dj !=NULL)
-	  {
-	      if( di != dj )
-	      {		  
-		  if(dominates( di->o, dj->o, minmax1, nobjs)==-1)
-		  {
-		      di->dominated=true;
-		      break;
-		  }		
-	      }
-	      dj = dj->next;
-	  }
-	  di = di->next;
-      }
-      
-      di = po[i];
-      while( di !=NULL)
-      {
-	  struct dnode *dj = di->next;
-	  while( dj !=NULL)
+      filter_merge(o.data(), start.data(), po.nruns(), nobjs, minmax1, dominated, nthreads);
+      // all points form a single set (none if there are no points)
+      start.assign(1, 0);
+      if (npoints > 0)
+	  start.push_back(npoints);
+  }
+
+  out.clear(nobjs);
+  for(i=0; i+1<(int)start.size();i++)
+  {
+      bool new_run = true;
+      for (int k = start[i]; k < start[i+1]; k++)
+      { 
+	  if(dominated[k]==false)
 	  {
-	      if(are_identical( di->o, dj->o, minmax1, nobjs))
+	      if(binary)
 	      {
-		  dj->dominated=true;
-		  break;
+		  out.append(o[k], new_run);
+		  new_run = false;
+		  continue;
 	      }
-	      dj = dj->next;
-	  }
-	  di = di->next;
-      }      
-      
-      struct dnode *q = po[i];
-      while ( q != NULL )     
-      { 
-	  if(q->dominated==false)
-	  {
 	      for(int j=0;j<nobjs;j++)
-		  fprintf(fp, "%.9e ", q->o[j]);
+		  fprintf(fp, "%.9e ", o[k][j]);
 	      fprintf(fp, "\n");
 	  }
-	  q = q -> next;       
       }       
-      fprintf(fp, "\n");
+      if(!binary)
+	  fprintf(fp, "\n");
   }
+  delete [] dominated;
   
-  fclose(fp);
+  if(binary)
+  {
+      if(!write_pointset(outfile, out, minmax1))
+      {
+	  fprintf(stderr,"Couldn't open %s for writing\n", outfile);
+	  exit(0);
+      }
+  }
+  else
+      fclose(fp);
+  trace_end(&span, NULL, infile, po.npoints());
   
   exit(0);
   return(0);
  
 }
 
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp)
-    /* check_file() function by Eckart Zitzler
-       determines the maximum number of points and the number of runs
-       for the data resp. the reference set file; if the array v is
-       specified, the data read in will be stored in v
-    */
-{
-    char  line[MAX_STR_LENGTH];
-    int  i, j;
-    int  new_run;
-    int  no_points;
-    double  number;
-
-    no_points = 0;
-    *max_pointsp = 0;
-    *no_runsp = 0;
-    new_run = 1;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-        if (sscanf(line, "%lf", &number) != 1) {
-	    if (method == 0)
-		new_run = 1;
-        }
-	else {
-	    if (new_run == 1)
-	    {
-		(*no_runsp)++;
-		if (*max_pointsp < no_points)
-		    *max_pointsp = no_points;
-		no_points = 0;
-	    }
-	    new_run = 0;
-	    i = 0;
-	    for (j = 1; j < nobjs; j++) {
-		while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		    i++;
-		if((sscanf(&(line[i]), "%lf", &number)) <= 0)
-		  {
-		    fprintf(stderr,"error in data or reference set file");
-		    exit(0);
-		  }
-		
-		while (line[i] == ' ' && line[i] != '\0')
-		    i++;
-	    }
-	    no_points++;
-	}
-    }
-    if (*max_pointsp < no_points)
-	*max_pointsp = no_points;
-}
-
 int  determine_dim(FILE  *fp)
 {
     char  line[MAX_STR_LENGTH];
@@ -388,142 +292,3 @@ int  determine_dim(FILE  *fp)
     
     return no_obj;
 }
-
-void  read_file(FILE  *fp, int  *no_pointsp, dnode **po)
-{
-  /* read_file() function by Eckart Zitzler */
-  char  line[MAX_STR_LENGTH];
-  int  i, j, k;
-  int  reading;
-  double  number;
-  double *vector;
-
-  vector=(double *)malloc(nobjs*sizeof(double));
-  
-  reading = 0;
-  *no_pointsp = 0;
-  //  printf("read_file\n");
-  while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) 
-    {
-      //      printf("OK\n");
-      k=0;
-      if (sscanf(line, "%lf", &number) != 1) {
-	  if (reading)
-	  {
-	      //	  printf("break\n");
-	      break;
-	  }
-      }
-      else 
-	{
-	  reading = 1;
-	  vector[k++] = number;
-	  i = 0;
-	  for (j = 1; j < nobjs; j++) 
-	    {
-	      while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		i++;
-	      if((sscanf(&(line[i]), "%lf", &number)) <= 0)
-		{
-		    fprintf(stderr,"error in data or reference set file");
-		    exit(0);
-		}
-	      
-	      vector[k++] = number;
-	      while (line[i] == ' ' && line[i] != '\0')
-		i++;
-	    }
-	  (*no_pointsp)++;
-	  // printf("%.9e", vector[0]);
-	  d_append(po, vector);
-	  if (method != 0)  reading = 0;
-	}
-    } 
-}
-
-int dominates(double *a, double *b, int *minmax1, int n)
-{
-  // Returns 1 if a dominates b
-  // Returns -1 if b dominates a
-  // Returns 0 if a==b or a and b are mutually nondominating (a~b)
-
-  // This dominance relationship is measured using the dimensions 
-  // defined in the array minmax1[]. If minmax1[i]=1 then objective i
-  // is compared assuming maximization of i. If minmax1[i]=-1 then
-  // objective i is compared assuming minimization of i. If
-  // minmax1[i]=0 then no comparison is made on objective i. The 
-  // total number of dimensions which could potentially be compared
-  // is given by the argument n.
-
-  double diff;
-  int abb=0; // counts number of dimensions where a beats b
-  int bba=0;
-  
-  for(int i=0;i<n;i++)
-    {
-      if(!(minmax1[i]==0))
-	{
-	  diff=a[i]-b[i];
-	  if(diff>0)
-	    {
-	      if(minmax1[i]==1)
-		abb++;
-	      else if (minmax1[i]==-1)
-		bba++;
-	      else
-		{
-		  fprintf(stderr, "minmax1 out of range\n");
-		  exit(0);
-		}
-	    }
-	  else if(diff<0)
-	    {
-	      if(minmax1[i]==1)
-		bba++;
-	      else if (minmax1[i]==-1)
-		abb++;
-	      else
-		{
-		  fprintf(stderr, "minmax1 out of range\n");
-		  exit(0);
-		}
-	    }
-	}
-      if((bba>0)&&(abb>0))
-	return(0);
-    }
-  if(abb>0)
-    return(1);
-  else if(bba>0)
-    return(-1);
-  else
-    return(0);
-
-}
-
-
-bool are_identical(double *first, double *second, int *minmax1, int n)
-{
-  // Returns true if two vectors are the same in all of 
-  // the nonzero components of the minmax1 array, false otherwise.
-  // Returns false if all components of minmax1 array are zero.
-
-  int i;
-  bool onenonzero=false;
-  
-  for(i=0;i<n;i++)
-    {
-      if(minmax1[i]!=0)
-	{
-	  if(first[i]!=second[i])
-	    return(false);      
-	  onenonzero=true;
-	}
-    }
-  if(onenonzero)
-    return(true);
-  else
-    return(false);
-}
-
-
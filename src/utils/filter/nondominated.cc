@@ -0,0 +1,389 @@
+/* nondominated.cc
+
+Sort-based nondominated filtering, see nondominated.h.
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "nondominated.h"
+
+using namespace std;
+
+// The objectives with minmax1[i] != 0 are copied to a flat array of keys
+// that are all to be minimized; a point then dominates another one iff its
+// keys are all <= and the points are not identical.
+struct keys
+{
+  int m;
+  vector<double> k;
+
+  const double *at(int i) const { return &k[(size_t)i*m]; }
+  bool less(int a, int b) const
+  {
+    const double *x = at(a), *y = at(b);
+    for (int j = 0; j < m; j++)
+      if (x[j] != y[j])
+	return x[j] < y[j];
+    return false;
+  }
+  bool equal(int a, int b) const
+  {
+    const double *x = at(a), *y = at(b);
+    for (int j = 0; j < m; j++)
+      if (x[j] != y[j])
+	return false;
+    return true;
+  }
+  bool weakly_dominates(int a, int b) const
+  {
+    const double *x = at(a), *y = at(b);
+    for (int j = 0; j < m; j++)
+      if (x[j] > y[j])
+	return false;
+    return true;
+  }
+};
+
+class staircase
+{
+  // the points (x, y) inserted so far that no other one weakly dominates:
+  // y falls as x grows, and the step at or left of x holds the least y
+  // among the points not larger than x
+ public:
+  // inserts (x, y) unless a point not larger in both is there already, and
+  // returns whether it was inserted
+  bool insert(double x, double y)
+  {
+    map<double, double>::iterator it = steps.upper_bound(x);
+    if (it != steps.begin() && prev(it)->second <= y)
+      return false;
+    while (it != steps.end() && it->second >= y)
+      it = steps.erase(it);
+    steps[x] = y;
+    return true;
+  }
+
+ private:
+  map<double, double> steps;
+};
+
+static int kung(const keys &key, int *u, int n)
+{
+  // Kung, Luccio and Preparata (1975): u[0..n-1] are distinct points in
+  // lexicographic order, so no point can be dominated by a later one. The
+  // nondominated points are moved to u[0..k-1] (in order) and k is returned.
+  if (n < 2)
+    return n;
+  int h = n/2;
+  int a = kung(key, u, h);
+  int b = kung(key, u+h, n-h);
+
+  for (int j = 0; j < b; j++)
+    {
+      int p = u[h+j];
+      bool dominated = false;
+      for (int i = 0; i < a && !dominated; i++)
+	dominated = key.weakly_dominates(u[i], p);
+      if (!dominated)
+	u[a++] = p;
+    }
+  return a;
+}
+
+static void make_keys(const double *const *o, int n, int nobjs,
+		      const int *minmax1, keys &key)
+{
+  key.m = 0;
+  for (int j = 0; j < nobjs; j++)
+    if (minmax1[j] != 0)
+      key.m++;
+  key.k.resize((size_t)n*key.m);
+  for (int i = 0; i < n; i++)
+    {
+      double *k = &key.k[(size_t)i*key.m];
+      for (int j = 0; j < nobjs; j++)
+	if (minmax1[j] != 0)
+	  *k++ = (minmax1[j] == 1 ? -o[i][j] : o[i][j]);
+    }
+}
+
+void filter_nondominated(const double *const *o, int n, int nobjs,
+			 const int *minmax1, bool *dominated)
+{
+  keys key;
+  vector<int> order(n), uniq;
+  int i;
+
+  for (i = 0; i < n; i++)
+    dominated[i] = false;
+  if (n < 2)
+    return;
+  make_keys(o, n, nobjs, minmax1, key);
+  if (key.m == 0)
+    return;
+
+  // identical points are adjacent after sorting; the first one in the
+  // input is kept, as the pairwise pass of filter.cc did
+  for (i = 0; i < n; i++)
+    order[i] = i;
+  sort(order.begin(), order.end(), [&](int a, int b) {
+      return key.less(a, b) || (!key.less(b, a) && a < b);
+    });
+  for (i = 0; i < n; i++)
+    {
+      if (i > 0 && key.equal(order[i-1], order[i]))
+	dominated[order[i]] = true;
+      else
+	uniq.push_back(order[i]);
+    }
+
+  if (key.m == 1)
+    {
+      for (size_t u = 1; u < uniq.size(); u++)
+	dominated[uniq[u]] = true;
+    }
+  else if (key.m == 2)
+    {
+      // a point is dominated iff an earlier point in the sorted order is
+      // not larger in the second key
+      double best = key.at(uniq[0])[1];
+      for (size_t u = 1; u < uniq.size(); u++)
+	{
+	  double v = key.at(uniq[u])[1];
+	  if (v >= best)
+	    dominated[uniq[u]] = true;
+	  else
+	    best = v;
+	}
+    }
+  else if (key.m == 3)
+    {
+      // a point is dominated iff an earlier point is not larger in the
+      // second and third key
+      staircase stairs;
+      for (size_t u = 0; u < uniq.size(); u++)
+	{
+	  const double *x = key.at(uniq[u]);
+	  if (!stairs.insert(x[1], x[2]))
+	    dominated[uniq[u]] = true;
+	}
+    }
+  else
+    {
+      vector<int> w(uniq);
+      int k = kung(key, w.data(), (int)w.size());
+      for (size_t u = 0; u < uniq.size(); u++)
+	dominated[uniq[u]] = true;
+      for (i = 0; i < k; i++)
+	dominated[w[i]] = false;
+    }
+}
+
+void filter_earlier(const double *const *o, int n, int nobjs,
+		    const int *minmax1, bool *dominated)
+{
+  keys key;
+  int i;
+
+  for (i = 0; i < n; i++)
+    dominated[i] = false;
+  make_keys(o, n, nobjs, minmax1, key);
+  if (n < 2 || key.m == 0)
+    return;
+
+  if (key.m == 1)
+    {
+      double best = key.at(0)[0];
+      for (i = 1; i < n; i++)
+	{
+	  double v = key.at(i)[0];
+	  if (v >= best)
+	    dominated[i] = true;
+	  else
+	    best = v;
+	}
+    }
+  else if (key.m == 2)
+    {
+      staircase stairs;
+      for (i = 0; i < n; i++)
+	if (!stairs.insert(key.at(i)[0], key.at(i)[1]))
+	  dominated[i] = true;
+    }
+  else
+    {
+      // the points kept so far that no later kept point weakly dominates
+      vector<int> front;
+      for (i = 0; i < n; i++)
+	{
+	  size_t j, k;
+	  for (j = 0; j < front.size() && !key.weakly_dominates(front[j], i); j++);
+	  if (j < front.size())
+	    {
+	      dominated[i] = true;
+	      continue;
+	    }
+	  for (j = k = 0; j < front.size(); j++)
+	    if (!key.weakly_dominates(i, front[j]))
+	      front[k++] = front[j];
+	  front.resize(k);
+	  front.push_back(i);
+	}
+    }
+}
+
+static filter_executor threads(int nthreads)
+{
+  // an executor of nthreads threads (the caller and nthreads-1 others)
+  return [nthreads](int n, const function<void(int)> &f) {
+    atomic<int> next(0);
+    auto work = [&]() {
+      for (int i; (i = next++) < n; )
+	f(i);
+    };
+    vector<thread> t;
+    for (int k = 1; k < min(nthreads, n); k++)
+      t.push_back(thread(work));
+    work();
+    for (size_t k = 0; k < t.size(); k++)
+      t[k].join();
+  };
+}
+
+static void filter_front(const double *const *o, vector<int> &front, int nobjs,
+			 const int *minmax1)
+  // removes the points of front (indices into o, in increasing order) that
+  // filter_nondominated() removes from them
+{
+  vector<const double *> p(front.size());
+  for (size_t i = 0; i < front.size(); i++)
+    p[i] = o[front[i]];
+  bool *dominated = new bool[front.size()+1];
+  filter_nondominated(p.data(), (int)front.size(), nobjs, minmax1, dominated);
+  size_t k = 0;
+  for (size_t i = 0; i < front.size(); i++)
+    if (!dominated[i])
+      front[k++] = front[i];
+  front.resize(k);
+  delete [] dominated;
+}
+
+void filter_blocks(const double *const *o, const int *start, int nblocks,
+		   int nobjs, const int *minmax1, bool *dominated,
+		   const filter_executor &run)
+{
+  run(nblocks, [&](int b) {
+      filter_nondominated(o + start[b], start[b+1] - start[b], nobjs, minmax1,
+			  dominated + start[b]);
+    });
+}
+
+void filter_blocks(const double *const *o, const int *start, int nblocks,
+		   int nobjs, const int *minmax1, bool *dominated, int nthreads)
+{
+  filter_blocks(o, start, nblocks, nobjs, minmax1, dominated, threads(nthreads));
+}
+
+void filter_merge(const double *const *o, const int *start, int nblocks,
+		  int nobjs, const int *minmax1, bool *dominated,
+		  const filter_executor &run)
+{
+  int n = nblocks > 0 ? start[nblocks] : 0;
+  vector<vector<int> > front(nblocks);
+  keys key;
+
+  run(nblocks, [&](int b) {
+      filter_nondominated(o + start[b], start[b+1] - start[b], nobjs, minmax1,
+			  dominated + start[b]);
+      for (int i = start[b]; i < start[b+1]; i++)
+	if (!dominated[i])
+	  front[b].push_back(i);
+    });
+  make_keys(o, n, nobjs, minmax1, key);
+  if (key.m == 0)
+    return;
+
+  // front[b] and front[b+step] cover neighbouring ranges of points, so
+  // their union is still in input order. Up to 3 keys, the union is
+  // filtered in O(n log n); otherwise, as the fronts are nondominated and
+  // duplicate free by themselves, a point of one of them is only removed
+  // if a point of the other one dominates it, or, for the later front, is
+  // identical to it, and can only be dominated by a point not larger in
+  // the first key: the points of every front are checked in chunks, as
+  // tasks of run, against the other front sorted by the first key
+  const int chunk = 1024;
+  vector<char> removed(key.m > 3 ? n : 0, 0);
+  for (int step = 1; step < nblocks; step *= 2)
+    {
+      vector<int> merges;
+      for (int b = 0; b + step < nblocks; b += 2*step)
+	merges.push_back(b);
+      int nm = (int)merges.size();
+      if (key.m <= 3)
+	{
+	  run(nm, [&](int m) {
+	      vector<int> &a = front[merges[m]], &b = front[merges[m] + step];
+	      a.insert(a.end(), b.begin(), b.end());
+	      vector<int>().swap(b);
+	      filter_front(o, a, nobjs, minmax1);
+	    });
+	  continue;
+	}
+      vector<vector<int> > by_first(2*nm);
+      run(2*nm, [&](int k) {
+	  by_first[k] = front[merges[k/2] + (k%2)*step];
+	  sort(by_first[k].begin(), by_first[k].end(), [&](int a, int b) {
+	      return key.at(a)[0] < key.at(b)[0];
+	    });
+	});
+      vector<pair<int, int> > tasks;  // (2*merge + side, first point)
+      for (int k = 0; k < 2*nm; k++)
+	for (size_t i = 0; i < by_first[k].size(); i += chunk)
+	  tasks.push_back(make_pair(k, (int)i));
+      run((int)tasks.size(), [&](int t) {
+	  int k = tasks[t].first;
+	  const vector<int> &mine = by_first[k], &other = by_first[k ^ 1];
+	  size_t end = min(mine.size(), (size_t)tasks[t].second + chunk);
+	  for (size_t i = tasks[t].second; i < end; i++)
+	    {
+	      int p = mine[i];
+	      double first = key.at(p)[0];
+	      for (size_t j = 0; j < other.size() && key.at(other[j])[0] <= first; j++)
+		if (key.weakly_dominates(other[j], p) && (k%2 == 1 || !key.equal(other[j], p)))
+		  {
+		    removed[p] = 1;
+		    break;
+		  }
+	    }
+	});
+      run(nm, [&](int m) {
+	  vector<int> &a = front[merges[m]], &b = front[merges[m] + step];
+	  size_t k = 0;
+	  for (size_t i = 0; i < a.size(); i++)
+	    if (!removed[a[i]])
+	      a[k++] = a[i];
+	  a.resize(k);
+	  for (size_t i = 0; i < b.size(); i++)
+	    if (!removed[b[i]])
+	      a.push_back(b[i]);
+	  vector<int>().swap(b);
+	});
+    }
+
+  for (int i = 0; i < n; i++)
+    dominated[i] = true;
+  if (nblocks > 0)
+    for (size_t i = 0; i < front[0].size(); i++)
+      dominated[front[0][i]] = false;
+}
+
+void filter_merge(const double *const *o, const int *start, int nblocks,
+		  int nobjs, const int *minmax1, bool *dominated, int nthreads)
+{
+  filter_merge(o, start, nblocks, nobjs, minmax1, dominated, threads(nthreads));
+}
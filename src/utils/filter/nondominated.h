@@ -0,0 +1,74 @@
+/* nondominated.h
+
+Nondominated filtering shared by filter and sts-pipeline.
+
+filter_nondominated() marks the points that filter.cc removes from an
+approximation set: every point that is dominated by another point of the
+set, and every point that is identical to an earlier point of the set.
+Dominance and identity are measured on the objectives i with
+minmax1[i] != 0 (1 = maximize, -1 = minimize); if all entries of minmax1
+are 0, no point is removed.
+
+The points are sorted once; two objectives are then filtered by a single
+sweep, three by a sweep that keeps the front of the last two objectives
+as a staircase (O(n log n)), more objectives by Kung's divide-and-conquer
+algorithm, and
+identical points end up next to each other in the sorted order, so no
+pairwise pass over the whole set is needed.
+
+filter_blocks() and filter_merge() take the points in blocks, usually the
+runs of a file, and work on several threads. filter_blocks() filters every
+block by itself (filter with method 0). filter_merge() gives the result of
+filter_nondominated() on all points at once (method 1): every block is
+filtered by itself, and the fronts of neighbouring blocks are then merged
+pairwise, level by level, as in a tree, every merge filtering only the
+union of two fronts. A point dominated within its block is dominated in
+the whole set, and the fronts keep the points in their input order, so
+the points removed are the same as in a single pass, whatever the number
+of blocks or threads; the work however grows with the size of the fronts
+rather than with the number of points once the blocks are filtered.
+
+filter_earlier() only removes a point if an earlier point of the set is
+not worse in any objective. A point it removes is therefore removed by
+filter_nondominated() as well, and stays removed if the objectives are
+then mapped by functions that keep their order (normalize, even where it
+rounds two values to the same one): filter_nondominated() on the mapped
+points filter_earlier() left, in their order, keeps the same points as on
+all mapped points. sts-pipeline --shard reduces the fronts of a shard this
+way before the bound of all shards is known.
+
+*/
+
+#ifndef NONDOMINATED_H
+#define NONDOMINATED_H
+
+#include <functional>
+
+// o[0..n-1] point to the objective vectors of the set; dominated[i] is set
+// to true if point i is to be removed and to false otherwise
+void filter_nondominated(const double *const *o, int n, int nobjs,
+			 const int *minmax1, bool *dominated);
+
+// dominated[i] is set to true if a point o[j], j < i, weakly dominates
+// point i (is identical to it or dominates it), and to false otherwise
+void filter_earlier(const double *const *o, int n, int nobjs,
+		    const int *minmax1, bool *dominated);
+
+// runs f(0), ..., f(n-1), possibly at the same time, and returns when all
+// of them have finished (e.g. pool::parallel_for() of sts-pipeline)
+typedef std::function<void(int n, const std::function<void(int)> &f)> filter_executor;
+
+// block b consists of the points o[start[b]..start[b+1]-1]; the blocks are
+// filtered on nthreads threads of their own, or by the tasks of run
+void filter_blocks(const double *const *o, const int *start, int nblocks,
+		   int nobjs, const int *minmax1, bool *dominated, int nthreads);
+void filter_blocks(const double *const *o, const int *start, int nblocks,
+		   int nobjs, const int *minmax1, bool *dominated,
+		   const filter_executor &run);
+void filter_merge(const double *const *o, const int *start, int nblocks,
+		  int nobjs, const int *minmax1, bool *dominated, int nthreads);
+void filter_merge(const double *const *o, const int *start, int nblocks,
+		  int nobjs, const int *minmax1, bool *dominated,
+		  const filter_executor &run);
+
+#endif
@@ -39,10 +39,18 @@ My email address is j.knowles@manchester.ac.uk
 
 
    COMPILE:
-      g++ normalize.cc -o normalize -lm
+      g++ -pthread -I../pointset -I../reader -I../trace normalize.cc scale.cc ../pointset/pointset.cc ../reader/reader.cc ../trace/trace.cc -o normalize -lm
       
    RUN:
       ./normalize [<paramfile>] <boundfile> <datafile> <outfile>
+      ./normalize --bound <boundparam> <boundfile> <paramfile> <datafile> <outfile> [<datafile> <outfile> ...]
+
+    The second form fuses bound and normalize: it writes to <boundfile>
+    what "bound --files <boundparam> <boundfile> <datafile> ..." writes
+    for all the data files, and normalizes every <datafile> into the
+    <outfile> after it as "normalize <paramfile> <boundfile> <datafile>
+    <outfile>" does, with the same results, but parses each data file only
+    once. The data files are normalized in parallel.
       
     
     The format of the parameter file <param> is
@@ -84,7 +92,12 @@ My email address is j.knowles@manchester.ac.uk
       are considered together. ]
 
 
+    <datafile> may also be a binary file written by normalize or filter
+    (see utils/reader/reader.h).
+
     The output of normalize is a file <outfile> of the normalized and unified values.
+    If <outfile> ends in .bin, it is written in the binary format, with the
+    objective senses after unification in its header.
 
 *******************************************************************/
 
@@ -98,6 +111,14 @@ My email address is j.knowles@manchester.ac.uk
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "reader.h"
+#include "pointset.h"
+#include "scale.h"
+#include "trace.h"
 
 using namespace std;
 
@@ -109,15 +130,7 @@ using namespace std;
 
 FILE *fp;
 
-struct dnode{
-  double *o;
-  bool dominated;
-  struct dnode *next;
-  struct dnode *prev;
-};
-
-
-dnode **p;
+pointset p;
 
 int *minmax1;
 double *ubound;
@@ -127,87 +140,183 @@ int nobjs;
 
 
 double myabs(double a);
-void d_append (struct dnode **s, double *vec);
-void d_display ( struct dnode *q );
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp);
 int  determine_dim(FILE  *fp);
-void  read_file(FILE  *fp, int  *no_pointsp, dnode **po);
 
 
-void d_append (struct dnode **s, double *vec) 
-/* adds a new node at the end of the doubly linked list */ 
+static double as_text(double v)
 {
-  struct dnode *r, *q = *s ; 
-  /* if the linked list is empty */ 
-  
-  if ( *s == NULL ) 
-    { 
-      
-      /*create a new node */ 
-      
-      *s = (dnode *) malloc ( sizeof ( struct dnode ) ) ;
-      ( *s ) -> prev = NULL ; 
-      (*s)->o = (double *) malloc(nobjs * sizeof (double) );
-      for(int j=0;j<nobjs;j++)
-	( *s ) -> o[j] = vec[j]; 
-      (*s)->dominated = false;
-      ( *s ) -> next = NULL ; 
-    } 
-  
-  else 
-    { 
-      
-      /* traverse the linked list till the last node is reached */ 
-      while ( q -> next != NULL ) 
-	q = q -> next; 
-
-      /* add a new node at the end */ 
-
-      r = (dnode *)malloc ( sizeof ( struct dnode ) ) ; 
-      r->o = (double *)malloc(nobjs * sizeof (double) );
-      for(int j=0;j<nobjs;j++)
-	r -> o[j] = vec[j]; 
-      r->dominated = false;
-      r -> next = NULL; 
-      r -> prev = q; 
-      q -> next = r; 
-    } 
-  
-} 
-
-/* displays the contents of the linked list */ 
-void d_display ( struct dnode *q ) 
-{ 
-  /* traverse the entire linked list */ 
-  while ( q != NULL )     
-    { 
-      if(1) // (q->dominated==false)
+  // the value normalize reads back from v written to the bound file with
+  // "%.9e"
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.9e", v);
+  return strtod(buf, NULL);
+}
+
+static bool write_normalized(const char *outfile, pointset &ps, const scale_map &m)
+{
+  // normalizes ps in place and writes it to outfile, in the binary format
+  // if its name ends in .bin
+  scale_points(m, ps.o.data(), ps.o.data(), ps.npoints());
+  if(binary_file_name(outfile))
+    return write_pointset(outfile, ps, m.senses.data());
+
+  FILE *out = fopen(outfile, "wb");
+  if(out == NULL)
+    return false;
+  for(int i=0; i<ps.nruns();i++)
+    {
+      const double *di = ps.run(i);
+      for(int k=0;k<ps.size(i);k++, di+=ps.nobjs)
 	{
-	  for(int j=0;j<nobjs;j++)
-	    printf("%g ", q->o[j]);
-	  printf("\n");
+	  for(int j=0;j<ps.nobjs;j++)
+	    fprintf(out, "%.9e ", di[j]);
+	  fprintf(out, "\n");
 	}
-      q = q -> next;       
-    } 
-  
-} 
+      if(i<ps.nruns()-1)
+	fprintf(out, "\n");
+    }
+  return fclose(out) == 0;
+}
+
+static int read_bound_param(const char *path, vector<int> &bound_minmax)
+{
+  // the parameter file of bound; returns its dimension
+  char str[MAX_STR_LENGTH];
+  int n;
+  double phi;
+
+  if(!(fp = fopen(path, "rb")))
+    {
+      fprintf(stderr,"Couldn't open param file\n");
+      exit(1);
+    }
+  fscanf(fp, "%s", str);
+  error(strcmp(str, "dim") != 0, "error in parameter file");
+  fscanf(fp, "%d", &n);
+  fscanf(fp, "%s", str);
+  error(strcmp(str, "obj") != 0, "error in parameter file");
+  error(n < 1, "error in parameter file");
+  bound_minmax.resize(n);
+  for (int i = 0; i < n; i++)
+    {
+      fscanf(fp, "%s", str);
+      error(str[0] != '-' && str[0] != '+', "error in parameter file");
+      bound_minmax[i] = (str[0] == '-') ? -1 : 1;
+    }
+  fscanf(fp, "%s", str);error(strcmp(str, "phi") != 0, "error in parameter file");
+  fscanf(fp, "%lf", &phi);
+  error((phi<0),"phi should be a positive real number");
+  fclose(fp);
+  return n;
+}
+
+static void fused(int argc, char **argv, const char *unify)
+{
+  // ./normalize --bound <boundparam> <boundfile> <paramfile> <datafile> <outfile> ...
+  int i, nfiles = (argc-5)/2;
+  vector<int> bound_minmax;
+  vector<pointset> fronts(nfiles);
+  trace_span span;
+
+  error(read_bound_param(argv[2], bound_minmax) != nobjs, "normalize and bound parameters differ");
+
+  trace_begin(&span, "parse");
+  long long npoints = 0;
+  for(int f=0;f<nfiles;f++)
+    {
+      if(!read_pointset(argv[5+2*f], nobjs, true, &fronts[f]))
+	{
+	  fprintf(stderr,"Couldn't open %s", argv[5+2*f]);
+	  exit(1);
+	}
+      npoints += fronts[f].npoints();
+    }
+  error(npoints < 1, "error in data file");
+  trace_end(&span, NULL, NULL, npoints);
+
+  // bound.cc, over the points of all files in their order
+  trace_begin(&span, "bound");
+  const int *mm = bound_minmax.data();
+  vector<double> best, worst;
+  for(int f=0;f<nfiles;f++)
+    {
+      const double *di = fronts[f].o.data();
+      if(best.empty() && fronts[f].npoints() > 0)
+	best.assign(di, di+nobjs), worst = best;
+      for(int k=0;k<fronts[f].npoints();k++, di+=nobjs)
+	for(i=0;i<nobjs;i++)
+	  {
+	    if(di[i]*mm[i] > best[i]*mm[i])
+	      best[i] = di[i];
+	    if(di[i]*mm[i] < worst[i]*mm[i])
+	      worst[i] = di[i];
+	  }
+    }
+  if(!(fp=fopen(argv[3],"wb")))
+    {
+      fprintf(stderr, "Couldn't open %s for writing. Exiting\n", argv[3]);
+      exit(1);
+    }
+  for(i=0;i<nobjs;i++)
+    {
+      lbound[i] = (mm[i] == -1) ? best[i] : worst[i];
+      ubound[i] = (mm[i] == -1) ? worst[i] : best[i];
+    }
+  fprintf(fp, "lower_bound ");
+  for(i=0;i<nobjs;i++)
+    fprintf(fp, "%.9e ", lbound[i]);
+  fprintf(fp, "\n");
+  fprintf(fp, "upper_bound ");
+  for(i=0;i<nobjs;i++)
+    fprintf(fp, "%.9e ", ubound[i]);
+  fprintf(fp, "\n");
+  fclose(fp);
+  trace_end(&span, NULL, NULL, npoints);
+
+  // the bounds as normalize reads them from the bound file
+  trace_begin(&span, "normalize");
+  for(i=0;i<nobjs;i++)
+    {
+      lbound[i] = as_text(lbound[i]);
+      ubound[i] = as_text(ubound[i]);
+    }
+  scale_map m;
+  scale_setup(&m, nobjs, minmax1, unify, lbound, ubound);
+  atomic<int> next(0);
+  auto work = [&]() {
+    for(int f; (f = next++) < nfiles; )
+      if(!write_normalized(argv[6+2*f], fronts[f], m))
+	{
+	  fprintf(stderr, "Couldn't open %s for writing. Exiting\n", argv[6+2*f]);
+	  exit(1);
+	}
+  };
+  vector<thread> threads;
+  int nthreads = min(nfiles, max(1, (int)thread::hardware_concurrency()));
+  for(int t=1;t<nthreads;t++)
+    threads.push_back(thread(work));
+  work();
+  for(size_t t=0;t<threads.size();t++)
+    threads[t].join();
+  trace_end(&span, NULL, NULL, npoints);
+}
 
 
 int main(int argc, char **argv)
 {
-  int num;
-  int nruns;
   int i;  
   char str[MAX_STR_LENGTH];
   char unify[MAX_STR_LENGTH];
+  bool fuse = argc > 1 && strcmp(argv[1], "--bound") == 0;
   
-  error(argc!=5 && argc != 4,
-	"./normalize [<paramfile>] <boundfile> <datafile> <outfile>");
+  error(fuse ? argc < 7 || (argc-5)%2 != 0 : argc!=5 && argc != 4,
+	"./normalize [<paramfile>] <boundfile> <datafile> <outfile>\n"
+	"./normalize --bound <boundparam> <boundfile> <paramfile> <datafile> <outfile> [<datafile> <outfile> ...]");
   
   
   /* read in the parameter file */
-  if (argc == 5) {
-      if((fp = fopen(argv[1], "rb")))
+  if (fuse || argc == 5) {
+      if((fp = fopen(argv[fuse ? 4 : 1], "rb")))
       {
 	  fscanf(fp, "%s", str);
 	  error(strcmp(str, "dim") != 0, "error in parameter file");
@@ -238,7 +347,8 @@ int main(int argc, char **argv)
   else {
       	fp = fopen(argv[2], "r");
 	error(fp == NULL, "data file not found");
-	nobjs = determine_dim(fp);
+	if ((nobjs = point_file_header(argv[2], NULL)) == 0)
+	  nobjs = determine_dim(fp);
 	error(nobjs < 1, "error in data file");
 	fclose(fp);
 	minmax1 = (int *)malloc(nobjs*sizeof(int));
@@ -246,6 +356,13 @@ int main(int argc, char **argv)
 	    minmax1[i] = -1;
 	sprintf(unify, "no");
   }
+
+  if (fuse) {
+      lbound = (double *)malloc(nobjs*sizeof(double));
+      ubound = (double *)malloc(nobjs*sizeof(double));
+      fused(argc, argv, unify);
+      exit(0);
+  }
   
   if((fp=fopen(argv[(argc == 5 ? 2 : 1)], "rb")))
   {
@@ -273,105 +390,32 @@ int main(int argc, char **argv)
   }
      
   /* read in each of the approximation sets */
-  if((fp=fopen(argv[(argc == 5 ? 3 : 2)], "rb")))
+  const char *infile = argv[(argc == 5 ? 3 : 2)];
+  trace_span span;
+  trace_begin(&span, "parse");
+  if(!read_pointset(infile, nobjs, true, &p))
     {
-      check_file(fp, &nruns, &num);
-      rewind(fp);
-      p=(dnode **)malloc(nruns*sizeof(dnode *));
-      for(int j=0;j<nruns;j++)
-	{
-	  p[j]=NULL;
-	  read_file(fp, &num, &(p[j]));      
-	}
-    }
-  else
-    {
-      fprintf(stderr,"Couldn't open %s", argv[(argc ==5 ? 3 : 2)]);
+      fprintf(stderr,"Couldn't open %s", infile);
       exit(1);
     }
+  trace_end(&span, NULL, infile, p.npoints());
+  trace_begin(&span, "normalize");
   
 
-  if(!(fp=fopen(argv[(argc == 5 ? 4 : 3)],"wb")))
+  const char *outfile = argv[(argc == 5 ? 4 : 3)];
+  scale_map m;
+  scale_setup(&m, nobjs, minmax1, unify, lbound, ubound);
+  if(!write_normalized(outfile, p, m))
     {
-      fprintf(stderr, "Couldn't open %s for writing. Exiting\n",
-	      argv[(argc == 5 ? 4 : 3)]);
+      fprintf(stderr, "Couldn't open %s for writing. Exiting\n", outfile);
       exit(1);
     }
-  for(i=0; i<nruns;i++)
-    {
-      struct dnode *di = p[i];
-      while( di !=NULL)
-	{
-	  for(int j=0;j<nobjs;j++)
-	    {
-	      if(((minmax1[j]==1)&&(strcmp(unify,"max")==0))||((minmax1[j]==-1)&&(strcmp(unify,"min")==0)))
-		fprintf(fp, "%.9e ", 1.0+(di->o[j]-lbound[j])/(ubound[j]-lbound[j]));
-	      else if(((minmax1[j]==1)&&(strcmp(unify,"min")==0))||((minmax1[j]==-1)&&(strcmp(unify,"max")==0)))
-		fprintf(fp, "%.9e ", 1.0+(ubound[j]-di->o[j])/(ubound[j]-lbound[j])); // reverses the sense
-	      else
-		fprintf(fp, "%.9e ", 1.0+(di->o[j]-lbound[j])/(ubound[j]-lbound[j]));
-	    }
-	  fprintf(fp, "\n");	  
-	  di=di->next;
-	}
-      if(i<nruns-1)
-	fprintf(fp, "\n");
-    }
-  fclose(fp);
+  trace_end(&span, NULL, infile, p.npoints());
   exit(0);
   return(0);
 
 }
 
-void  check_file(FILE  *fp, int  *no_runsp, int  *max_pointsp)
-    /* check_file() function by Eckart Zitzler
-       determines the maximum number of points and the number of runs
-       for the data resp. the reference set file; if the array v is
-       specified, the data read in will be stored in v
-    */
-{
-    char  line[MAX_STR_LENGTH];
-    int  i, j;
-    int  new_run;
-    int  no_points;
-    double  number;
-
-    no_points = 0;
-    *max_pointsp = 0;
-    *no_runsp = 0;
-    new_run = 1;
-    while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) {
-	if (sscanf(line, "%lf", &number) != 1)
-	    new_run = 1;
-	else {
-	    if (new_run == 1)
-	    {
-		(*no_runsp)++;
-		if (*max_pointsp < no_points)
-		    *max_pointsp = no_points;
-		no_points = 0;
-	    }
-	    new_run = 0;
-	    i = 0;
-	    for (j = 1; j < nobjs; j++) {
-		while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		    i++;
-		if((sscanf(&(line[i]), "%lf", &number)) <= 0)
-		  {
-		    fprintf(stderr,"error in data or reference set file");
-		    exit(0);
-		  }
-		
-		while (line[i] == ' ' && line[i] != '\0')
-		    i++;
-	    }
-	    no_points++;
-	}
-    }
-    if (*max_pointsp < no_points)
-	*max_pointsp = no_points;
-}
-
 int  determine_dim(FILE  *fp)
 {
     char  line[MAX_STR_LENGTH];
@@ -398,55 +442,6 @@ int  determine_dim(FILE  *fp)
     return no_obj;
 }
 
-void  read_file(FILE  *fp, int  *no_pointsp, dnode **po)
-{
-  /* read_file() function by Eckart Zitzler */
-  char  line[MAX_STR_LENGTH];
-  int  i, j, k;
-  int  reading;
-  double  number;
-  double *vector;
-
-  vector=(double *)malloc(nobjs*sizeof(double));
-  
-  reading = 0;
-  *no_pointsp = 0;
-  //  printf("read_file\n");
-  while (fgets(line, MAX_LINE_LENGTH, fp) != NULL) 
-    {
-      //      printf("OK\n");
-      k=0;
-      if (sscanf(line, "%lf", &number) != 1)
-	{
-	  //	  printf("break\n");
-	  if (reading) break;
-	}
-      else 
-	{
-	  reading = 1;
-	  vector[k++] = number;
-	  i = 0;
-	  for (j = 1; j < nobjs; j++) 
-	    {
-	      while (line[i] != ' ' && line[i] != '\n' && line[i] != '\0')
-		i++;
-	      if((sscanf(&(line[i]), "%lf", &number)) <= 0)
-		{
-		    fprintf(stderr,"error in data or reference set file");
-		    exit(0);
-		}
-	      
-	      vector[k++] = number;
-	      while (line[i] == ' ' && line[i] != '\0')
-		i++;
-	    }
-	  (*no_pointsp)++;
-	  // printf("%g", vector[0]);
-	  d_append(po, vector);
-	}
-    } 
-}
-
 double myabs(double a)
 {
   if(a>=0)
@@ -454,6 +449,3 @@ double myabs(double a)
   else
     return(-a);
 }
-
-
-
@@ -0,0 +1,71 @@
+/* scale.cc
+
+Vectorized normalization, see scale.h.
+
+*/
+
+#include <cstring>
+
+#include "scale.h"
+
+using namespace std;
+
+// GCC vector types: an operation on them is carried out on both values at
+// once (with SSE2 on x86-64), whatever the optimization level
+typedef double v2d __attribute__((vector_size(16)));
+typedef long long v2i __attribute__((vector_size(16)));
+
+void scale_setup(scale_map *m, int nobjs, const int *minmax1, const char *unify,
+		 const double *lbound, const double *ubound)
+{
+  bool to_max = strcmp(unify, "max") == 0;
+  bool to_min = strcmp(unify, "min") == 0;
+
+  m->nobjs = nobjs;
+  m->lo.resize(2*nobjs);
+  m->hi.resize(2*nobjs);
+  m->range.resize(2*nobjs);
+  m->reverse.resize(2*nobjs);
+  m->senses.resize(nobjs);
+  for (int t = 0; t < 2*nobjs; t++)
+    {
+      int j = t % nobjs, mm = minmax1[j];
+      m->lo[t] = lbound[j];
+      m->hi[t] = ubound[j];
+      m->range[t] = ubound[j]-lbound[j];
+      m->reverse[t] = ((mm==1)&&to_min)||((mm==-1)&&to_max) ? -1 : 0;
+    }
+  for (int j = 0; j < nobjs; j++)
+    m->senses[j] = to_min ? -1 : (to_max ? 1 : minmax1[j]);
+}
+
+static inline v2d load(const double *p)
+{
+  v2d v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+void scale_points(const scale_map &m, const double *in, double *out, size_t npoints)
+{
+  size_t n = npoints*m.nobjs, i = 0;
+  int t = 0;
+  const v2d one = { 1.0, 1.0 };
+
+  // both expressions are evaluated and the one that applies is selected,
+  // which keeps each value exactly what the scalar code computes
+  for (; i+2 <= n; i += 2)
+    {
+      v2d x = load(in+i);
+      v2d kept = x - load(&m.lo[t]), reversed = load(&m.hi[t]) - x;
+      v2i r;
+      memcpy(&r, &m.reverse[t], sizeof(r));
+      v2i d = ((v2i)reversed & r) | ((v2i)kept & ~r);
+      v2d v = one + (v2d)d / load(&m.range[t]);
+      memcpy(out+i, &v, sizeof(v));
+      if ((t += 2) == 2*m.nobjs)
+	t = 0;
+    }
+  if (i < n)
+    out[i] = 1.0 + (m.reverse[t] ? m.hi[t]-in[i] : in[i]-m.lo[t])/m.range[t];
+}
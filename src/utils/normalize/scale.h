@@ -0,0 +1,44 @@
+/* scale.h
+
+The normalization of normalize.cc, shared by normalize and sts-pipeline.
+
+Objective j of every point is mapped to
+
+   1 + (x - lbound[j])/(ubound[j] - lbound[j])    if its sense is kept,
+   1 + (ubound[j] - x)/(ubound[j] - lbound[j])    if it is reversed,
+
+where the sense of an objective is reversed if unify is "min" and it is
+maximized (minmax1[j] = 1), or if unify is "max" and it is minimized
+(minmax1[j] = -1). The results are bit for bit the ones of the scalar
+expressions above.
+
+The points are rescaled as one flat array, two values at a time, with a
+per-objective pattern of offsets and ranges that repeats every nobjs
+pairs, so that the kernel does not depend on the number of objectives.
+
+*/
+
+#ifndef SCALE_H
+#define SCALE_H
+
+#include <cstddef>
+#include <vector>
+
+struct scale_map
+{
+  int nobjs;
+  std::vector<double> lo, hi, range;   // the pattern, 2*nobjs values each
+  std::vector<long long> reverse;      // -1 (all bits set) or 0
+  std::vector<int> senses;             // of the objectives after unification
+};
+
+// sets up the map for the bounds lbound, ubound and the parameters of
+// normalize.cc
+void scale_setup(scale_map *m, int nobjs, const int *minmax1, const char *unify,
+		 const double *lbound, const double *ubound);
+
+// out[i*nobjs+j] = objective j of point i of in, normalized; in and out
+// may be the same array
+void scale_points(const scale_map &m, const double *in, double *out, std::size_t npoints);
+
+#endif
@@ -0,0 +1,50 @@
+/* pointset.cc
+
+Contiguous storage and parsing of approximation sets, see pointset.h.
+
+*/
+
+#include "reader.h"
+#include "pointset.h"
+
+using namespace std;
+
+void pointset::clear(int n)
+{
+  nobjs = n;
+  o.clear();
+  start.assign(1, 0);
+}
+
+void pointset::append(const double *v, bool new_run)
+{
+  if (new_run || start.size() == 1)
+    start.push_back(start.back());
+  o.insert(o.end(), v, v+nobjs);
+  start.back()++;
+}
+
+bool read_pointset(const char *path, int nobjs, bool separate_runs, pointset *ps)
+{
+  point_file pf;
+
+  ps->clear(nobjs);
+  if (!read_point_file(path, nobjs, separate_runs, &pf))
+    return false;
+  ps->o.assign(pf.points, pf.points + (size_t)pf.no_points*nobjs);
+  ps->start.assign(pf.run_start, pf.run_start + pf.no_runs + 1);
+  free_point_file(&pf);
+  return true;
+}
+
+bool write_pointset(const char *path, const pointset &ps, const int *minmax)
+{
+  point_file pf;
+
+  pf.dim = ps.nobjs;
+  pf.no_runs = ps.nruns();
+  pf.no_points = ps.npoints();
+  pf.points = const_cast<double *>(ps.o.data());
+  pf.run_start = const_cast<int *>(ps.start.data());
+  return write_point_file(path, &pf, minmax) != 0;
+}
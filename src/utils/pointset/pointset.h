@@ -0,0 +1,54 @@
+/* pointset.h
+
+A collection of approximation sets, shared by bound, normalize, filter and
+sts-pipeline.
+
+All points of all runs are stored row-major in one contiguous array:
+objective j of point i is o[i*nobjs+j], and run r consists of the points
+start[r]..start[r+1]-1. Loading a file therefore takes linear time and a
+handful of (geometrically growing) allocations instead of two mallocs and
+a walk to the tail of a linked list per point.
+
+*/
+
+#ifndef POINTSET_H
+#define POINTSET_H
+
+#include <cstddef>
+#include <vector>
+
+struct pointset
+{
+  int nobjs;
+  std::vector<double> o;
+  std::vector<int> start;
+
+  pointset() : nobjs(0), start(1, 0) {}
+
+  int nruns() const { return (int)start.size()-1; }
+  int npoints() const { return nobjs > 0 ? (int)(o.size()/nobjs) : 0; }
+  int size(int r) const { return start[r+1]-start[r]; }
+  double *run(int r) { return &o[(std::size_t)start[r]*nobjs]; }
+  const double *run(int r) const { return &o[(std::size_t)start[r]*nobjs]; }
+  double *point(int i) { return &o[(std::size_t)i*nobjs]; }
+  const double *point(int i) const { return &o[(std::size_t)i*nobjs]; }
+
+  // removes all points and runs
+  void clear(int n);
+  // appends a point to a new run (new_run true) or to the last run
+  void append(const double *v, bool new_run);
+};
+
+// Reads the approximation sets in the file path with read_point_file() (see
+// reader.h): every line that starts with a number holds one point of nobjs
+// numbers, any other line (usually a blank one) ends the current run. If
+// separate_runs is false, all points form a single run. Returns false if
+// the file cannot be opened. Binary files (see reader.h) are read as well.
+bool read_pointset(const char *path, int nobjs, bool separate_runs, pointset *ps);
+
+// Writes ps to path in the binary format of reader.h, with the objective
+// senses minmax (1 = maximize, -1 = minimize). Returns false if the file
+// cannot be written.
+bool write_pointset(const char *path, const pointset &ps, const int *minmax);
+
+#endif
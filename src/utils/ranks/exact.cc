@@ -0,0 +1,147 @@
+/* exact.cc
+
+The exact null distributions of exact.h, computed by the compiler.
+
+Signed-rank statistic: the number c_n(t) of subsets of {1, ..., n} whose
+sum is t satisfies c_n(t) = c_{n-1}(t) + c_{n-1}(t-n) (n is in the subset
+or not), and P(T+ = t) = c_n(t) / 2^n.
+
+Rank-sum statistic: the number c(n,m,u) of orderings of a sample of size n
+and one of size m in which u pairs have the value of the first sample
+ahead satisfies c(n,m,u) = c(n-1,m,u-m) + c(n,m-1,u), depending on the
+sample the largest value belongs to, and P(U = u) = c(n,m,u) / C(n+m,n).
+The distribution is the same for (m,n), so only n <= m is stored.
+
+All counts are below 2^53, so the probabilities are correctly rounded
+quotients of exact integers.
+
+*/
+
+#include <math.h>
+#include "exact.h"
+
+namespace {
+
+const int NW = SIGNED_RANK_MAX_N;
+const int NM = RANK_SUM_MAX_N;
+const int W_MAX = NW*(NW+1)/2;   // largest value of T+
+const int U_MAX = NM*NM;         // largest value of U
+
+constexpr int signed_rank_size()
+{
+  int size = 0;
+  for (int n = 1; n <= NW; n++)
+    size += n*(n+1)/2 + 1;
+  return size;
+}
+
+constexpr int rank_sum_size()
+{
+  int size = 0;
+  for (int n = 1; n <= NM; n++)
+    for (int m = n; m <= NM; m++)
+      size += n*m + 1;
+  return size;
+}
+
+struct signed_rank_table
+{
+  int offset[NW+1];                 // lower[offset[n]+t] = P(T+ <= t)
+  double lower[signed_rank_size()];
+
+  constexpr signed_rank_table() : offset(), lower()
+  {
+    unsigned long long c[W_MAX+1] = {};
+    double total = 1.0;
+    int next = 0;
+
+    c[0] = 1;
+    for (int n = 1; n <= NW; n++)
+      {
+	int max = n*(n+1)/2;
+	for (int t = max; t >= n; t--)
+	  c[t] += c[t-n];
+	total *= 2.0;
+	offset[n] = next;
+	unsigned long long cum = 0;
+	for (int t = 0; t <= max; t++)
+	  {
+	    cum += c[t];
+	    lower[next++] = double(cum)/total;
+	  }
+      }
+  }
+};
+
+struct rank_sum_table
+{
+  int offset[NM+1][NM+1];           // upper[offset[n][m]+u] = P(U >= u), n <= m
+  double upper[rank_sum_size()];
+
+  constexpr rank_sum_table() : offset(), upper()
+  {
+    // prev[m][u] = c(n-1,m,u) and cur[m][u] = c(n,m,u)
+    unsigned long long prev[NM+1][U_MAX+1] = {};
+    unsigned long long cur[NM+1][U_MAX+1] = {};
+    int next = 0;
+
+    for (int m = 0; m <= NM; m++)
+      prev[m][0] = 1;
+    for (int n = 1; n <= NM; n++)
+      {
+	for (int m = 0; m <= NM; m++)
+	  for (int u = 0; u <= n*m; u++)
+	    cur[m][u] = (m > 0 && u <= n*(m-1) ? cur[m-1][u] : 0)
+	      + (u >= m && u-m <= (n-1)*m ? prev[m][u-m] : 0);
+	for (int m = n; m <= NM; m++)
+	  {
+	    unsigned long long total = 0, cum = 0;
+	    for (int u = 0; u <= n*m; u++)
+	      total += cur[m][u];
+	    offset[n][m] = next;
+	    for (int u = n*m; u >= 0; u--)
+	      {
+		cum += cur[m][u];
+		upper[next+u] = double(cum)/double(total);
+	      }
+	    next += n*m + 1;
+	  }
+	for (int m = 0; m <= NM; m++)
+	  for (int u = 0; u <= U_MAX; u++)
+	    {
+	      prev[m][u] = cur[m][u];
+	      cur[m][u] = 0;
+	    }
+      }
+  }
+};
+
+constexpr signed_rank_table signed_rank;
+constexpr rank_sum_table rank_sum;
+
+}
+
+double signed_rank_lower(int n, double t)
+{
+  int max = n*(n+1)/2;
+  if (t < 0)
+    return 0.0;
+  if (t >= max)
+    return 1.0;
+  return signed_rank.lower[signed_rank.offset[n] + (int)floor(t)];
+}
+
+double rank_sum_upper(int n, int m, double u)
+{
+  if (n > m)
+    {
+      int k = n;
+      n = m;
+      m = k;
+    }
+  if (u <= 0)
+    return 1.0;
+  if (u > n*m)
+    return 0.0;
+  return rank_sum.upper[rank_sum.offset[n][m] + (int)ceil(u)];
+}
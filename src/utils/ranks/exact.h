@@ -0,0 +1,33 @@
+/* exact.h
+
+Exact null distributions of the Wilcoxon signed-rank statistic and of the
+Mann-Whitney (rank-sum) statistic, shared by wilcoxon-sign and mann-whit.
+
+Both distributions are tabulated at compile time (exact.cc) by the usual
+dynamic programming over the number of values, so a p-value is a single
+table lookup. The tables hold the distributions for samples without ties;
+for tied values they are the ones of the untied statistic, as the tables in
+Conover (1999) are.
+
+*/
+
+#ifndef EXACT_H
+#define EXACT_H
+
+// the largest number of (non-zero) differences of the signed-rank table; the
+// former Table A12 also ended at 50
+#define SIGNED_RANK_MAX_N 50
+
+// the largest sample size of the rank-sum table
+#define RANK_SUM_MAX_N 20
+
+// P(T+ <= t) for the sum T+ of the ranks of the positive differences among
+// n differences, 1 <= n <= SIGNED_RANK_MAX_N
+double signed_rank_lower(int n, double t);
+
+// P(U >= u) for the Mann-Whitney statistic U = R - n(n+1)/2 of a sample of
+// size n with rank sum R, ranked jointly with a sample of size m,
+// 1 <= n, m <= RANK_SUM_MAX_N
+double rank_sum_upper(int n, int m, double u);
+
+#endif
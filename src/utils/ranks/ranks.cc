@@ -0,0 +1,154 @@
+/* ranks.cc
+
+Rank statistics shared by kruskal-wallis, mann-whit and sts-pipeline, see
+ranks.h.
+
+*/
+
+#include <stdlib.h>
+#include "ranks.h"
+
+void rank_engine::rank(D *d, int N_, int ndist_, bool pairs)
+{
+  int i, j;
+
+  N = N_;
+  ndist = ndist_;
+  qsort(d, N, sizeof(D), compare);
+  ties = assign_ranks(d, N);
+
+  n.assign(ndist, 0);
+  sum.assign(ndist, 0.0);
+  sum_squared = 0.0;
+  for(i=0;i<N;i++)
+    {
+      n[d[i].label]++;
+      sum[d[i].label] += d[i].rank;
+      sum_squared += d[i].rank*d[i].rank;
+    }
+
+  u2.clear();
+  cross.clear();
+  shared.clear();
+  cubes.clear();
+  distinct.clear();
+  if(!pairs)
+    return;
+
+  // walk the blocks of tied values; a value of sample a in a block holding
+  // c[a] values of a and c[b] values of b, above cum[a] resp. cum[b] smaller
+  // values, has the rank cum[a]+cum[b]+(c[a]+c[b]+1)/2 in the ranking of a
+  // and b, and the block contributes (c^3-c)/12, c = c[a]+c[b], less than
+  // the sum of the squared positions to the sum of the squared ranks
+  size_t nn = (size_t)ndist*ndist;
+  u2.assign(nn, 0);
+  cross.assign(nn, 0);
+  shared.assign(nn, 0);
+  cubes.assign(ndist, 0);
+  distinct.assign(ndist, 0);
+  std::vector<long long> cum(ndist, 0), c(ndist, 0);
+  std::vector<int> present;
+
+  for(i=0;i<N;i=j)
+    {
+      present.clear();
+      for(j=i;j<N && d[j].value==d[i].value;j++)
+	if(c[d[j].label]++==0)
+	  present.push_back(d[j].label);
+
+      for(size_t p=0;p<present.size();p++)
+	{
+	  int a = present[p];
+	  long long ca = c[a];
+	  long long *u = &u2[(size_t)a*ndist];
+	  cubes[a] += ca*ca*ca-ca;
+	  distinct[a]++;
+	  for(int b=0;b<ndist;b++)
+	    u[b] += ca*(2*cum[b]+c[b]);
+	  for(size_t q=0;q<present.size();q++)
+	    {
+	      int b = present[q];
+	      if(b==a)
+		continue;
+	      shared[(size_t)a*ndist+b]++;
+	      cross[(size_t)a*ndist+b] += 3*ca*c[b]*(ca+c[b]);
+	    }
+	}
+      for(size_t p=0;p<present.size();p++)
+	{
+	  cum[present[p]] += c[present[p]];
+	  c[present[p]] = 0;
+	}
+    }
+}
+
+double rank_engine::pair_rank_sum(int a, int b) const
+{
+  // n[a](n[a]+1)/2 plus the Mann-Whitney U of a against b
+  return (double)((long long)n[a]*(n[a]+1) + u2[(size_t)a*ndist+b])/2.0;
+}
+
+double rank_engine::pair_sum_squared(int a, int b) const
+{
+  long long m = n[a]+n[b];
+  long long twelve = 2*m*(m+1)*(2*m+1) - cubes[a] - cubes[b] - cross[(size_t)a*ndist+b];
+  return (double)twelve/12.0;
+}
+
+int rank_engine::pair_ties(int a, int b) const
+{
+  return n[a]+n[b] - (distinct[a]+distinct[b]-shared[(size_t)a*ndist+b]);
+}
+
+int assign_ranks(D *d, int N)
+{
+  // assign ranks to the N values, giving the same (averaged) rank to any tied values
+  // NOTE: the N values in d must be in sorted order
+  int i,j;
+  int crank=1;
+  int totalrank;
+  int count;
+  int total_ties=0;
+
+  i=0;
+  while(i<N)
+    {
+      count=0;
+      totalrank=crank;
+      while(i+count+1<N && d[i+count+1].value == d[i].value)
+	{
+	  count++;
+	  totalrank+=(crank+count);
+	}
+      if(count>0)
+	{
+	  // set all the ranks to the average value
+	  for(j=0;j<=count;j++)
+	    d[i+j].rank = (double(totalrank)/double(count+1));
+	  total_ties+=count;
+	}
+      else
+	d[i].rank=crank;
+      i+=count+1;
+      crank+=count+1;
+    }
+  return(total_ties);
+
+}
+
+
+int compare(const void *i, const void *j)
+{
+  double x;
+  x = (*(D *)i).value - (*(D *)j).value;
+
+  if(x<0)
+    return(-1);
+
+  else if (x>0)
+    return(1);
+
+  else
+    return(0);
+
+}
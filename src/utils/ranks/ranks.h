@@ -0,0 +1,67 @@
+/* ranks.h
+
+Rank statistics shared by kruskal-wallis, mann-whit and sts-pipeline.
+
+The labelled values of all sample populations are sorted and ranked once,
+tied values getting the average of their ranks (assign_ranks(), originally
+part of kruskal-wallis.cc and mann-whit.cc (C) Joshua Knowles, 2005). The
+same pass accumulates the rank sum of every sample and the sum of all
+squared ranks, which is all the Kruskal-Wallis test needs.
+
+With pairs set, rank() also counts, for every pair of samples a and b, how
+the values of a and b interleave. From these counts the rank sum of a, the
+sum of the squared ranks and the number of ties that qsort() and
+assign_ranks() would produce for a and b alone follow in O(1), so a
+Mann-Whitney test between every pair needs no second sort. All of these
+sums are multiples of 1/4 and are computed exactly, which makes them equal
+to the sums the separate rankings gave.
+
+*/
+
+#ifndef RANKS_H
+#define RANKS_H
+
+#include <vector>
+
+typedef struct data
+{
+  double value;
+  int label;
+  double rank;
+}D;
+
+int compare(const void *, const void *);
+
+// assigns ranks to the N values, giving the same (averaged) rank to any
+// tied values; the values must be sorted; returns the number of ties
+int assign_ranks(D *d, int N);
+
+struct rank_engine
+{
+  int N;                    // the total number of values
+  int ndist;                // the number of sample populations
+  int ties;                 // the number of ties among all values
+  std::vector<int> n;       // n[a]: the number of values of sample a
+  std::vector<double> sum;  // sum[a]: the rank sum of sample a
+  double sum_squared;       // the sum of all squared ranks
+
+  // sorts the N values in d (labels 0..ndist-1) in place, ranks them and
+  // accumulates the sums above; with pairs set, the statistics of the
+  // pair-wise rankings below are prepared as well, in O(N ndist)
+  void rank(D *d, int N, int ndist, bool pairs);
+
+  // the rank sum of sample a, the sum of the squared ranks and the number
+  // of ties if only the values of samples a and b are ranked
+  double pair_rank_sum(int a, int b) const;
+  double pair_sum_squared(int a, int b) const;
+  int pair_ties(int a, int b) const;
+
+private:
+  std::vector<long long> u2;     // u2[a*ndist+b]: twice the Mann-Whitney U
+  std::vector<long long> cross;  // cross[a*ndist+b]: joint tie correction
+  std::vector<int> shared;       // shared[a*ndist+b]: values found in a and b
+  std::vector<long long> cubes;  // cubes[a]: sum of t^3-t over ties within a
+  std::vector<int> distinct;     // distinct[a]: distinct values of a
+};
+
+#endif
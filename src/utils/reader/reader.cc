@@ -0,0 +1,445 @@
+/*===========================================================================*
+ * reader.cc: memory-mapped, single pass text reader, see reader.h
+ *
+ * The numbers are converted with std::from_chars, which rounds correctly
+ * like strtod() (and thus sscanf("%lf")), but does not depend on the locale
+ * and does not need a terminated copy of every line. Binary files are
+ * recognized by their magic bytes and copied into the row-major layout.
+ *===========================================================================*/
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "reader.h"
+#include "trace.h"
+
+#define error(X,Y)  if (X) fprintf(stderr, Y "\n"), exit(1)
+
+static const char magic[8] = {'S', 'T', 'S', 'F', 'R', 'O', 'N', 'T'};
+static const uint32_t version = 1;
+
+struct header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t dim;
+  uint64_t no_runs;
+  uint64_t no_points;
+};
+
+static inline size_t align8(size_t n)
+{
+  return (n + 7) & ~(size_t)7;
+}
+
+static bool is_binary(const char *data, size_t size)
+{
+  return size >= sizeof(header) && memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+static inline bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static const char *parse_number(const char *p, const char *end, double *v)
+  // parses the number at p as sscanf("%lf") would; returns the position
+  // after the number or NULL if there is none
+{
+  const char *q = p;
+
+  if (q < end && *q == '+')
+    {
+      q++;
+      if (q < end && *q == '-')
+	return NULL;
+    }
+  std::from_chars_result r = std::from_chars(q, end, *v);
+  if (r.ec == std::errc::invalid_argument)
+    return NULL;
+  // out of range values saturate like strtod() does
+  if (r.ec == std::errc::result_out_of_range)
+    *v = strtod(std::string(p, r.ptr).c_str(), NULL);
+  return r.ptr;
+}
+
+static char *load(const char *path, size_t *size, bool *mapped)
+  // maps the file into memory; files that cannot be mapped (pipes, ...) are
+  // read into a buffer instead
+{
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  char *data;
+
+  if (fd < 0)
+    return NULL;
+  *mapped = false;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    {
+      *size = (size_t)st.st_size;
+      if (*size == 0)
+	{
+	  close(fd);
+	  return (char *)malloc(1);
+	}
+      data = (char *)mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED)
+	{
+	  madvise(data, *size, MADV_SEQUENTIAL);
+	  close(fd);
+	  *mapped = true;
+	  return data;
+	}
+    }
+
+  size_t capacity = 1 << 16;
+  ssize_t n;
+  *size = 0;
+  data = (char *)malloc(capacity);
+  error(data == NULL, "memory overflow");
+  while ((n = read(fd, data + *size, capacity - *size)) > 0)
+    {
+      *size += (size_t)n;
+      if (*size == capacity)
+	{
+	  capacity *= 2;
+	  data = (char *)realloc(data, capacity);
+	  error(data == NULL, "memory overflow");
+	}
+    }
+  close(fd);
+  return data;
+}
+
+static void unload(char *data, size_t size, bool mapped)
+{
+  if (mapped)
+    munmap(data, size);
+  else
+    free(data);
+}
+
+static const double *check_binary(const char *data, size_t size, int dim,
+				  size_t *no_runs, size_t *no_points,
+				  const uint64_t **start)
+  // checks the binary file in data against dim; returns its columns
+{
+  header h;
+
+  memcpy(&h, data, sizeof(h));
+  error(h.version != version, "unsupported binary data or reference set file");
+  error(h.dim != (uint32_t)dim || h.no_points > (uint64_t)INT32_MAX
+	|| h.no_runs > (uint64_t)INT32_MAX,
+	"error in data or reference set file");
+
+  *no_runs = (size_t)h.no_runs;
+  *no_points = (size_t)h.no_points;
+  size_t offsets = sizeof(h) + align8(dim * sizeof(int32_t));
+  size_t columns = offsets + (*no_runs + 1) * sizeof(uint64_t);
+  error(size != columns + *no_points * dim * sizeof(double),
+	"error in data or reference set file");
+
+  *start = (const uint64_t *)(data + offsets);
+  error((*start)[0] != 0 || (*start)[*no_runs] != h.no_points,
+	"error in data or reference set file");
+  for (size_t r = 0; r < *no_runs; r++)
+    error((*start)[r] > (*start)[r + 1], "error in data or reference set file");
+  return (const double *)(data + columns);
+}
+
+static void read_binary(const char *data, size_t size, int separate_runs,
+			point_file *pf)
+  // checks the binary file in data against pf->dim and transposes its
+  // columns into pf
+{
+  int dim = pf->dim;
+  size_t no_runs, no_points;
+  const uint64_t *start;
+  const double *column = check_binary(data, size, dim, &no_runs, &no_points, &start);
+
+  if (!separate_runs)
+    no_runs = no_points > 0;
+  pf->no_runs = (int)no_runs;
+  pf->no_points = (int)no_points;
+  pf->points = (double *)malloc((no_points * dim + 1) * sizeof(double));
+  pf->run_start = (int *)malloc((no_runs + 1) * sizeof(int));
+  error(pf->points == NULL || pf->run_start == NULL, "memory overflow");
+  for (size_t r = 0; r <= no_runs; r++)
+    pf->run_start[r] = (int)(separate_runs ? start[r] : r * no_points);
+
+  for (int k = 0; k < dim; k++, column += no_points)
+    for (size_t i = 0; i < no_points; i++)
+      pf->points[i * dim + k] = column[i];
+}
+
+static bool parse_point(const char *p, const char *eol, int dim, double *v)
+  // parses the line p..eol into v; returns false if it does not start with
+  // a number, i.e., if it is not a point
+{
+  const char *q = p;
+
+  while (q < eol && is_space(*q))
+    q++;
+  if ((q = parse_number(q, eol, &v[0])) == NULL)
+    return false;
+  for (int j = 1; j < dim; j++)
+    {
+      // the rest of a token that is not a number is skipped, as
+      // read_file() does
+      while (q < eol && !is_space(*q))
+	q++;
+      while (q < eol && is_space(*q))
+	q++;
+      q = parse_number(q, eol, &v[j]);
+      error(q == NULL, "error in data or reference set file");
+    }
+  return true;
+}
+
+int read_point_file(const char *path, int dim, int separate_runs,
+		    point_file *pf)
+{
+  size_t size, max_points, max_runs;
+  bool mapped, new_run = true;
+  char *data;
+
+  pf->dim = dim;
+  pf->no_runs = 0;
+  pf->no_points = 0;
+  pf->points = NULL;
+  pf->run_start = NULL;
+  error(dim < 1, "error in data or reference set file");
+  if ((data = load(path, &size, &mapped)) == NULL)
+    return 0;
+  if (mapped)
+    trace_read_bytes((long long)size);
+  if (is_binary(data, size))
+    {
+      read_binary(data, size, separate_runs, pf);
+      unload(data, size, mapped);
+      return 1;
+    }
+
+  // a "%.9e " number takes 16 bytes
+  max_points = size / (16 * (size_t)dim) + 16;
+  max_runs = 16;
+  pf->points = (double *)malloc(max_points * dim * sizeof(double));
+  pf->run_start = (int *)malloc((max_runs + 1) * sizeof(int));
+  error(pf->points == NULL || pf->run_start == NULL, "memory overflow");
+  pf->run_start[0] = 0;
+
+  const char *p = data, *end = data + size;
+  while (p < end)
+    {
+      const char *eol = (const char *)memchr(p, '\n', end - p);
+      if (eol == NULL)
+	eol = end;
+
+      if ((size_t)pf->no_points == max_points)
+	{
+	  max_points *= 2;
+	  pf->points = (double *)realloc(pf->points, max_points * dim * sizeof(double));
+	  error(pf->points == NULL, "memory overflow");
+	}
+      if (!parse_point(p, eol, dim, pf->points + (size_t)pf->no_points * dim))
+	{
+	  if (separate_runs)
+	    new_run = true;
+	  p = eol + 1;
+	  continue;
+	}
+
+      if (new_run)
+	{
+	  if ((size_t)pf->no_runs == max_runs)
+	    {
+	      max_runs *= 2;
+	      pf->run_start = (int *)realloc(pf->run_start, (max_runs + 1) * sizeof(int));
+	      error(pf->run_start == NULL, "memory overflow");
+	    }
+	  pf->no_runs++;
+	  new_run = false;
+	}
+      pf->no_points++;
+      pf->run_start[pf->no_runs] = pf->no_points;
+      p = eol + 1;
+    }
+
+  unload(data, size, mapped);
+  return 1;
+}
+
+static size_t line_start(const char *data, size_t size, size_t offset)
+  // the first line that starts at or after offset
+{
+  if (offset == 0 || offset >= size)
+    return offset < size ? offset : size;
+  if (data[offset - 1] == '\n')
+    return offset;
+  const char *eol = (const char *)memchr(data + offset, '\n', size - offset);
+  return eol == NULL ? size : (size_t)(eol - data) + 1;
+}
+
+int scan_point_file(const char *path, int dim, int part, int nparts,
+		    void (*visit)(const double *points, int n, void *arg),
+		    void *arg)
+{
+  // the pages behind the parsed text are given back every release bytes,
+  // so that a mapped file of any size needs little memory
+  static const size_t release = (size_t)16 << 20;
+  size_t size;
+  bool mapped;
+  char *data;
+  int n = 0;
+
+  error(dim < 1 || part < 0 || part >= nparts, "error in data or reference set file");
+  if ((data = load(path, &size, &mapped)) == NULL)
+    return 0;
+  double *block = (double *)malloc((size_t)SCAN_BLOCK * dim * sizeof(double));
+  error(block == NULL, "memory overflow");
+
+  if (is_binary(data, size))
+    {
+      size_t no_runs, no_points;
+      const uint64_t *start;
+      const double *column = check_binary(data, size, dim, &no_runs, &no_points, &start);
+      size_t first = no_points * part / nparts, last = no_points * (part + 1) / nparts;
+      if (mapped)
+	trace_read_bytes((long long)((last - first) * dim * sizeof(double)));
+      for (size_t i = first; i < last; i += SCAN_BLOCK)
+	{
+	  n = (int)(last - i < SCAN_BLOCK ? last - i : SCAN_BLOCK);
+	  for (int k = 0; k < dim; k++)
+	    for (int j = 0; j < n; j++)
+	      block[(size_t)j * dim + k] = column[k * no_points + i + j];
+	  visit(block, n, arg);
+	}
+      free(block);
+      unload(data, size, mapped);
+      return 1;
+    }
+
+  size_t first = line_start(data, size, size * part / nparts);
+  size_t last = line_start(data, size, size * (part + 1) / nparts);
+  size_t page = (size_t)sysconf(_SC_PAGESIZE), released = first / page * page;
+  if (mapped)
+    trace_read_bytes((long long)(last - first));
+  const char *p = data + first, *end = data + last;
+  while (p < end)
+    {
+      const char *eol = (const char *)memchr(p, '\n', end - p);
+      if (eol == NULL)
+	eol = end;
+      if (parse_point(p, eol, dim, block + (size_t)n * dim) && ++n == SCAN_BLOCK)
+	{
+	  visit(block, n, arg);
+	  n = 0;
+	}
+      p = eol + 1;
+      size_t done = (size_t)(p - data) / page * page;
+      if (mapped && done >= released + release)
+	{
+	  madvise(data + released, done - released, MADV_DONTNEED);
+	  released = done;
+	}
+    }
+  if (n > 0)
+    visit(block, n, arg);
+  free(block);
+  unload(data, size, mapped);
+  return 1;
+}
+
+void free_point_file(point_file *pf)
+{
+  free(pf->points);
+  free(pf->run_start);
+  pf->points = NULL;
+  pf->run_start = NULL;
+  pf->no_runs = 0;
+  pf->no_points = 0;
+}
+
+int point_file_header(const char *path, int *minmax)
+{
+  FILE *fp = fopen(path, "rb");
+  header h;
+  int dim = 0;
+
+  if (fp == NULL)
+    return 0;
+  if (fread(&h, sizeof(h), 1, fp) == 1
+      && memcmp(h.magic, magic, sizeof(magic)) == 0)
+    {
+      error(h.version != version, "unsupported binary data or reference set file");
+      error(h.dim < 1 || h.dim > (uint32_t)INT32_MAX, "error in data or reference set file");
+      dim = (int)h.dim;
+      for (int k = 0; minmax != NULL && k < dim; k++)
+	{
+	  int32_t sense;
+	  error(fread(&sense, sizeof(sense), 1, fp) != 1,
+		"error in data or reference set file");
+	  minmax[k] = sense;
+	}
+    }
+  fclose(fp);
+  return dim;
+}
+
+int binary_file_name(const char *path)
+{
+  size_t n = strlen(path);
+  return n >= 4 && strcmp(path + n - 4, ".bin") == 0;
+}
+
+int write_point_file(const char *path, const point_file *pf,
+		     const int *minmax)
+{
+  FILE *fp = fopen(path, "wb");
+  size_t dim = (size_t)pf->dim, no_points = (size_t)pf->no_points;
+  header h;
+
+  if (fp == NULL)
+    return 0;
+  memcpy(h.magic, magic, sizeof(magic));
+  h.version = version;
+  h.dim = (uint32_t)pf->dim;
+  h.no_runs = (uint64_t)pf->no_runs;
+  h.no_points = (uint64_t)pf->no_points;
+  fwrite(&h, sizeof(h), 1, fp);
+
+  std::string senses(align8(dim * sizeof(int32_t)), '\0');
+  for (size_t k = 0; k < dim; k++)
+    {
+      int32_t sense = minmax != NULL ? minmax[k] : -1;
+      memcpy(&senses[k * sizeof(int32_t)], &sense, sizeof(sense));
+    }
+  fwrite(senses.data(), 1, senses.size(), fp);
+
+  for (int r = 0; r <= pf->no_runs; r++)
+    {
+      uint64_t start = (uint64_t)pf->run_start[r];
+      fwrite(&start, sizeof(start), 1, fp);
+    }
+
+  double *column = (double *)malloc((no_points + 1) * sizeof(double));
+  error(column == NULL, "memory overflow");
+  for (size_t k = 0; k < dim; k++)
+    {
+      for (size_t i = 0; i < no_points; i++)
+	column[i] = pf->points[i * dim + k];
+      fwrite(column, sizeof(double), no_points, fp);
+    }
+  free(column);
+
+  int ok = !ferror(fp);
+  return fclose(fp) == 0 && ok;
+}
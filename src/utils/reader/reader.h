@@ -0,0 +1,96 @@
+/*===========================================================================*
+ * reader.h: the text reader shared by all tools
+ *
+ * A data file is a sequence of lines; every line that starts with a number
+ * holds one point (the first 'dim' whitespace separated numbers of the line,
+ * any further contents are ignored), any other line (usually a blank one)
+ * ends the current run. This is the format check_file() and read_file() by
+ * Eckart Zitzler accepted; the reader maps the file into memory and parses
+ * it in a single pass, so the file is no longer read twice.
+ *
+ * Alternatively, a data file may be stored in the binary format below,
+ * which read_point_file() recognizes by its first bytes; every tool thus
+ * accepts both formats. All fields are in host byte order (a file written
+ * on a machine of the other byte order is rejected by its version field)
+ * and every section starts at a multiple of 8 bytes:
+ *
+ *   char      magic[8]             "STSFRONT"
+ *   uint32    version              1
+ *   uint32    dim
+ *   uint64    no_runs
+ *   uint64    no_points
+ *   int32     minmax[dim]          1 = maximize, -1 = minimize,
+ *                                  padded with zeros to a multiple of 8 bytes
+ *   uint64    run_start[no_runs+1] run_start[0] = 0, run_start[no_runs] =
+ *                                  no_points
+ *   double    column[dim][no_points]
+ *
+ * The objective values are stored column by column, so a single objective
+ * or a single run (column[k][run_start[r]..run_start[r+1]-1]) can be read
+ * straight from the mapped file. The file is about a third of the size of
+ * the "%.9e " text and is loaded without any number conversion.
+ *
+ * Points are stored row-major, i.e. objective k of point i is found at
+ * points[i * dim + k]; run r consists of the points
+ * run_start[r]..run_start[r+1]-1. A file of indicator values is read with
+ * dim = 1, one run per sample.
+ *===========================================================================*/
+
+#ifndef READER_H
+#define READER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    int  dim;
+    int  no_runs;
+    int  no_points;
+    double  *points;
+    int  *run_start;  /* no_runs + 1 entries */
+} point_file;
+
+/* reads the file 'path' in either format; if 'separate_runs' is 0, all
+   points form a single run; returns 0 if the file cannot be opened and 1
+   otherwise; a point line with less than 'dim' numbers, or a binary file
+   of another dimension, is an error */
+int  read_point_file(const char  *path, int  dim, int  separate_runs,
+		     point_file  *pf);
+
+void  free_point_file(point_file  *pf);
+
+/* passes the points of part 'part' (0..nparts-1) of the file 'path', in
+   either format, to visit(points, n, arg) in blocks of at most SCAN_BLOCK
+   row-major points; runs are ignored. The parts divide the file at line
+   (or point) boundaries into pieces of nearly equal size, so that every
+   point belongs to exactly one part and the parts follow each other in
+   the order of the file; they may be scanned concurrently. Besides the
+   block, only a bounded window of the mapped file is held in memory.
+   Returns 0 if the file cannot be opened and 1 otherwise */
+#define  SCAN_BLOCK  4096
+
+int  scan_point_file(const char  *path, int  dim, int  part, int  nparts,
+		     void  (*visit)(const double  *points, int  n, void  *arg),
+		     void  *arg);
+
+/* returns the dimension stored in the header of the binary file 'path' and,
+   if 'minmax' is not NULL, stores its objective senses in minmax[0..dim-1];
+   returns 0 if 'path' cannot be opened or is not a binary file */
+int  point_file_header(const char  *path, int  *minmax);
+
+/* returns 1 if output to 'path' is to be written in the binary format,
+   i.e., if 'path' ends in ".bin", and 0 otherwise */
+int  binary_file_name(const char  *path);
+
+/* writes 'pf' to 'path' in the binary format; 'minmax' gives the objective
+   senses (NULL = all minimized); returns 0 if the file cannot be written */
+int  write_point_file(const char  *path, const point_file  *pf,
+		      const int  *minmax);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
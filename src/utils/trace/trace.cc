@@ -0,0 +1,215 @@
+/*===========================================================================*
+ * trace.cc: timing and memory records, see trace.h
+ *
+ * The CPU time is taken from the process or thread CPU clock and the bytes
+ * from rchar and wchar in /proc/self/io or /proc/thread-self/io, which
+ * count all read(2) and write(2) calls (stdio included); the bytes of
+ * mapped files are added by the reader with trace_read_bytes(). The
+ * counters of a thread only cover the tasks it ran itself, so usage taken
+ * around a task is not disturbed by the other threads of the process.
+ *===========================================================================*/
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "trace.h"
+
+static std::atomic<long long> mapped_bytes(0);  // of the process
+static thread_local long long thread_mapped_bytes = 0;
+static std::mutex trace_mutex;  // the totals of task spans and the output
+static int trace_fd = -1;
+
+static const char *trace_path()
+{
+  static const char *path = getenv("STS_TRACE");
+  return path;
+}
+
+int trace_enabled(void)
+{
+  const char *path = trace_path();
+  return path != NULL && *path != '\0';
+}
+
+static double seconds(clockid_t clock)
+{
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void usage(bool thread, bool start, trace_usage *u)
+  // the counters of the process or of the calling thread; the read of the
+  // /proc file itself is counted by rchar from then on, so that a start
+  // value includes it
+{
+  char buf[512];
+  ssize_t n = 0;
+  int fd = open(thread ? "/proc/thread-self/io" : "/proc/self/io", O_RDONLY);
+
+  u->cpu = seconds(thread ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID);
+  u->read = thread ? thread_mapped_bytes : mapped_bytes.load();
+  u->written = 0;
+  if (fd < 0)
+    return;
+  n = read(fd, buf, sizeof(buf)-1);
+  close(fd);
+  if (n <= 0)
+    return;
+  buf[n] = '\0';
+  const char *r = strstr(buf, "rchar:"), *w = strstr(buf, "wchar:");
+  if (r != NULL)
+    u->read += atoll(r+6) + (start ? n : 0);
+  if (w != NULL)
+    u->written = atoll(w+6);
+}
+
+void trace_read_bytes(long long n)
+{
+  if (!trace_enabled())
+    return;
+  mapped_bytes += n;
+  thread_mapped_bytes += n;
+}
+
+static void start_span(trace_span *span, const char *stage, trace_span *parent, int tasks)
+{
+  span->stage = stage;
+  span->parent = parent;
+  span->tasks = tasks;
+  span->wall = seconds(CLOCK_MONOTONIC);
+  span->total.cpu = 0;
+  span->total.read = span->total.written = 0;
+}
+
+void trace_begin(trace_span *span, const char *stage)
+{
+  if (!trace_enabled())
+    return;
+  start_span(span, stage, NULL, 0);
+  usage(false, true, &span->start);
+}
+
+void trace_begin_tasks(trace_span *span, const char *stage, trace_span *parent)
+{
+  if (!trace_enabled())
+    return;
+  start_span(span, stage, parent, 1);
+}
+
+void trace_task_begin(trace_usage *task)
+{
+  if (!trace_enabled())
+    return;
+  usage(true, true, task);
+}
+
+static void add(trace_span *span, const trace_usage &d)
+{
+  for (; span != NULL; span = span->parent)
+    {
+      span->total.cpu += d.cpu;
+      span->total.read += d.read;
+      span->total.written += d.written;
+    }
+}
+
+void trace_task_end(trace_span *span, const trace_usage *task)
+{
+  if (!trace_enabled())
+    return;
+  trace_usage now, d;
+  usage(true, false, &now);
+  d.cpu = now.cpu - task->cpu;
+  d.read = now.read - task->read;
+  d.written = now.written - task->written;
+  std::lock_guard<std::mutex> lk(trace_mutex);
+  add(span, d);
+}
+
+static void append_string(std::string &s, const char *key, const char *value)
+{
+  char buf[8];
+
+  s += ",\"";
+  s += key;
+  s += "\":\"";
+  for (const char *c = value; *c != '\0'; c++)
+    if (*c == '"' || *c == '\\')
+      {
+	s += '\\';
+	s += *c;
+      }
+    else if ((unsigned char)*c < 0x20)
+      {
+	snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)*c);
+	s += buf;
+      }
+    else
+      s += *c;
+  s += '"';
+}
+
+void trace_end(trace_span *span, const char *instance, const char *input, long long points)
+{
+  if (!trace_enabled())
+    return;
+  double wall = seconds(CLOCK_MONOTONIC) - span->wall;
+  trace_usage d;
+  if (span->tasks)
+    {
+      std::lock_guard<std::mutex> lk(trace_mutex);
+      d = span->total;
+    }
+  else
+    {
+      usage(false, false, &d);
+      d.cpu -= span->start.cpu;
+      d.read -= span->start.read;
+      d.written -= span->start.written;
+    }
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+
+  std::string s = "{\"tool\":\"";
+  s += program_invocation_short_name;
+  s += "\",\"pid\":" + std::to_string((long)getpid());
+  append_string(s, "stage", span->stage);
+  if (instance != NULL)
+    append_string(s, "instance", instance);
+  if (input != NULL)
+    append_string(s, "input", input);
+  char buf[256];
+  snprintf(buf, sizeof(buf), ",\"points\":%lld,\"wall_s\":%.6f,\"cpu_s\":%.6f,\"peak_rss_kb\":%ld,"
+	   "\"read_bytes\":%lld,\"written_bytes\":%lld}\n",
+	   points, wall, d.cpu, ru.ru_maxrss, d.read, d.written);
+  s += buf;
+
+  std::lock_guard<std::mutex> lk(trace_mutex);
+  if (trace_fd < 0)
+    {
+      if (strcmp(trace_path(), "-") == 0)
+	trace_fd = STDERR_FILENO;
+      else
+	trace_fd = open(trace_path(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+      if (trace_fd < 0)
+	{
+	  fprintf(stderr, "Couldn't open %s for writing\n", trace_path());
+	  exit(1);
+	}
+    }
+  if (write(trace_fd, s.data(), s.size()) != (ssize_t)s.size())
+    {
+      fprintf(stderr, "Couldn't write to %s\n", trace_path());
+      exit(1);
+    }
+}
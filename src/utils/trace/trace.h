@@ -0,0 +1,79 @@
+/*===========================================================================*
+ * trace.h: optional timing and memory records of the tools and sts-pipeline
+ *
+ * If the environment variable STS_TRACE names a file, every tool appends
+ * one line per stage to it (STS_TRACE=- writes the lines to stderr); each
+ * line is a JSON object such as
+ *
+ *   {"tool":"hyp_ind","pid":4711,"stage":"hypervolume","input":"a.out",
+ *    "points":30000,"wall_s":0.012,"cpu_s":0.011,"peak_rss_kb":4536,
+ *    "read_bytes":0,"written_bytes":391}
+ *
+ * (on a single line). "instance" is given by sts-pipeline, "input" by the
+ * tools (their data file); both are left out where they do not apply.
+ * wall_s is the elapsed time of the stage, cpu_s the user and system time
+ * and read_bytes and written_bytes count the bytes read and written by the
+ * stage, including files mapped by the reader. peak_rss_kb is the peak
+ * resident set size of the process at the end of the stage, i.e., of the
+ * stage and all stages before it. Every line is written by a single
+ * write(2) to a file opened for appending, so the tools of
+ * run_analysis.sh and the instances of sts-pipeline --jobs may share the
+ * file.
+ *
+ * A stage of a tool (trace_begin) counts the CPU time and bytes of the
+ * whole process. A stage made of tasks (trace_begin_tasks) only counts
+ * the tasks timed with trace_task_begin() and trace_task_end(), which may
+ * run on several threads; this is how sts-pipeline separates concurrent
+ * instances and stages. If STS_TRACE is not set, all functions return
+ * after a single test.
+ *===========================================================================*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    double  cpu;  /* seconds */
+    long long  read;  /* bytes */
+    long long  written;
+} trace_usage;
+
+typedef struct trace_span
+{
+    const char  *stage;
+    struct trace_span  *parent;  /* receives the usage of the tasks */
+    int  tasks;  /* 1 = only the tasks are counted */
+    double  wall;  /* start of the stage */
+    trace_usage  start;  /* of the process, if tasks = 0 */
+    trace_usage  total;  /* of the tasks, if tasks = 1 */
+} trace_span;
+
+/* returns 1 if STS_TRACE is set and 0 otherwise */
+int  trace_enabled(void);
+
+/* a stage of the process */
+void  trace_begin(trace_span  *span, const char  *stage);
+
+/* a stage made of tasks; if 'parent' is not NULL, the usage of the tasks is
+   also added to the parent span (which must be made of tasks as well) */
+void  trace_begin_tasks(trace_span  *span, const char  *stage,
+			trace_span  *parent);
+void  trace_task_begin(trace_usage  *task);
+void  trace_task_end(trace_span  *span, const trace_usage  *task);
+
+/* writes the record of the stage; 'instance' and 'input' may be NULL */
+void  trace_end(trace_span  *span, const char  *instance, const char  *input,
+		long long  points);
+
+/* counts 'n' bytes read without read(2), e.g. from a mapped file */
+void  trace_read_bytes(long long  n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif